@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/arena.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/dom.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct track_t {
+  std::string uri;
+  std::string name;
+  long long duration_ms;
+  std::vector<int> markets;
+};
+
+codec::object_t<track_t> track_codec() {
+  auto codec = codec::object<track_t>();
+  codec.required("uri", &track_t::uri);
+  codec.required("name", &track_t::name);
+  codec.required("duration_ms", &track_t::duration_ms);
+  codec.optional("markets", &track_t::markets);
+  return codec;
+}
+
+std::string generate_tracks(const std::size_t count) {
+  std::string json = "[";
+  for (std::size_t i = 0; i < count; i++) {
+    json += "{\"uri\":\"spotify:track:" + std::to_string(i * 7919) + "\",\"name\":\"track number " +
+            std::to_string(i) + "\",\"duration_ms\":" + std::to_string(180000 + i) +
+            ",\"markets\":[1,2,3,4,5]},";
+  }
+  json.back() = ']';
+  return json;
+}
+
+}  // namespace
+
+/*
+ * Decoding the same input into typed values and into a DOM.
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_dom_decode_typed) {
+  const auto json = generate_tracks(1000);
+  const auto codec = codec::array<std::vector<track_t>>(track_codec());
+  JSON_BENCHMARK(100, [&]{
+    const auto tracks = decode(codec, json);
+    BOOST_REQUIRE_EQUAL(tracks.size(), 1000);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_dom_decode) {
+  const auto json = generate_tracks(1000);
+  JSON_BENCHMARK(100, [&]{
+    const auto document = decode_dom(json);
+    BOOST_REQUIRE_EQUAL(document.root().size(), 1000);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_dom_decode_into_reused_arena) {
+  const auto json = generate_tracks(1000);
+  monotonic_arena arena(json.size());
+  const auto codec = codec::dom(arena, true);
+  JSON_BENCHMARK(100, [&]{
+    arena.reset();
+    const auto value = decode(codec, json);
+    BOOST_REQUIRE_EQUAL(value.size(), 1000);
+  });
+}
+
+/*
+ * Encoding the same values from typed values and from a DOM.
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_dom_encode_typed) {
+  const auto codec = codec::array<std::vector<track_t>>(track_codec());
+  const auto tracks = decode(codec, generate_tracks(1000));
+  JSON_BENCHMARK(100, [&]{
+    encode(codec, tracks);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_dom_encode) {
+  const auto document = decode_dom(generate_tracks(1000));
+  JSON_BENCHMARK(100, [&]{
+    encode(document.root());
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
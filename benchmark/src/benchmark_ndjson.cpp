@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/any.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/shared.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/detail/parallel_for.hpp>
+#include <spotify/json/ndjson.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct event_t {
+  std::string id;
+  std::string name;
+  long long timestamp;
+  std::vector<int> tags;
+};
+
+codec::object_t<event_t> event_codec() {
+  auto codec = codec::object<event_t>();
+  codec.required("id", &event_t::id);
+  codec.required("name", &event_t::name);
+  codec.required("timestamp", &event_t::timestamp);
+  codec.optional("tags", &event_t::tags);
+  return codec;
+}
+
+/**
+ * The same codec, but with every field going through a type erased any_t and
+ * a shared_t, which are the codecs that keep shared_ptrs to other codecs.
+ */
+codec::object_t<event_t> shared_event_codec() {
+  auto codec = codec::object<event_t>();
+  codec.required("id", &event_t::id, codec::any(codec::shared(codec::string())));
+  codec.required("name", &event_t::name, codec::any(codec::shared(codec::string())));
+  codec.required("timestamp", &event_t::timestamp, codec::any(codec::number<long long>()));
+  codec.optional("tags", &event_t::tags, codec::any(codec::array<std::vector<int>>(codec::number<int>())));
+  return codec;
+}
+
+std::string generate_events(const std::size_t count) {
+  std::string ndjson;
+  for (std::size_t i = 0; i < count; i++) {
+    ndjson += "{\"id\":\"" + std::to_string(i * 7919) + "\",\"name\":\"event number " + std::to_string(i) +
+              "\",\"timestamp\":" + std::to_string(1460000000000LL + i) + ",\"tags\":[1,2,3,4,5]}\n";
+  }
+  return ndjson;
+}
+
+/**
+ * Events where only every 20th one is a "play", which is what a typical log
+ * filtering stage keeps.
+ */
+std::string generate_heartbeats(const std::size_t count) {
+  std::string ndjson;
+  for (std::size_t i = 0; i < count; i++) {
+    ndjson += "{\"id\":\"" + std::to_string(i * 7919) + "\",\"name\":\"" + (i % 20 ? "heartbeat" : "play") +
+              "\",\"timestamp\":" + std::to_string(1460000000000LL + i) + ",\"tags\":[1,2,3,4,5]}\n";
+  }
+  return ndjson;
+}
+
+/**
+ * Decode the same input with 1, 2, 4, ... threads up to the number of hardware
+ * threads and print the throughput for each. Throughput that stops growing
+ * with more threads points to contention, e.g., on shared_ptr reference counts.
+ */
+template <typename codec_type>
+void benchmark_scaling(const char *name, const codec_type &codec) {
+  using namespace std::chrono;
+  const auto ndjson = generate_events(200000);
+  const auto max_threads = detail::default_thread_count();
+
+  std::vector<std::size_t> thread_counts;
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(max_threads);
+
+  for (const auto threads : thread_counts) {
+    parallel_options options;
+    options.threads = threads;
+    options.chunk_size = 256 * 1024;
+
+    const auto before = high_resolution_clock::now();
+    const auto result = parallel_decode_ndjson(codec, ndjson, options);
+    const auto duration = duration_cast<microseconds>(high_resolution_clock::now() - before).count();
+    BOOST_REQUIRE_EQUAL(result.values.size(), 200000);
+
+    std::cerr
+        << name << " (" << threads << " threads): "
+        << (ndjson.size() / std::max<double>(duration, 1)) << " MB/s, "
+        << (duration / 1000) << " ms total"
+        << std::endl;
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_ndjson) {
+  const auto ndjson = generate_events(1000);
+  const auto codec = event_codec();
+  JSON_BENCHMARK(100, [&]{
+    const auto result = decode_ndjson(codec, ndjson);
+    BOOST_REQUIRE_EQUAL(result.values.size(), 1000);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_decode_ndjson_and_discard) {
+  const auto ndjson = generate_heartbeats(1000);
+  const auto codec = event_codec();
+  JSON_BENCHMARK(100, [&]{
+    std::size_t plays = 0;
+    decode_ndjson(codec, ndjson.data(), ndjson.size(), [&](event_t &&event) {
+      plays += (event.name == "play");
+    });
+    BOOST_REQUIRE_EQUAL(plays, 50);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_filter_ndjson) {
+  const auto ndjson = generate_heartbeats(1000);
+  const auto codec = event_codec();
+  const auto filter = field_equals("/name", "play");
+  JSON_BENCHMARK(100, [&]{
+    const auto result = filter_ndjson(codec, ndjson, filter);
+    BOOST_REQUIRE_EQUAL(result.values.size(), 50);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_parallel_decode_ndjson_scaling) {
+  benchmark_scaling("parallel_decode_ndjson", event_codec());
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_parallel_decode_ndjson_scaling_with_shared_codecs) {
+  benchmark_scaling("parallel_decode_ndjson with shared codecs", shared_event_codec());
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
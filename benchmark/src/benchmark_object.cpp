@@ -20,6 +20,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/boolean.hpp>
 #include <spotify/json/codec/object.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
@@ -27,6 +28,32 @@
 
 #include <spotify/json/benchmark/benchmark.hpp>
 
+namespace spotify {
+namespace json {
+namespace {
+
+struct message_t {
+  std::string id;
+  int integer;
+  bool flag;
+};
+
+}  // namespace
+
+template <>
+struct default_codec_t<message_t> {
+  static codec::object_t<message_t> codec() {
+    auto codec = codec::object<message_t>();
+    codec.required("id", &message_t::id);
+    codec.required("integer", &message_t::integer);
+    codec.optional("flag", &message_t::flag);
+    return codec;
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(codec)
@@ -84,6 +111,38 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_many_required_field
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_encode_with_fresh_default_codec) {
+  const auto message = message_t{ "abc", 17, true };
+
+  JSON_BENCHMARK(1e5, [=]{
+    encode(default_codec<message_t>(), message);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_encode_with_cached_default_codec) {
+  const auto message = message_t{ "abc", 17, true };
+
+  JSON_BENCHMARK(1e5, [=]{
+    encode(message);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_fresh_default_codec) {
+  const std::string json = R"({"id":"abc","integer":17,"flag":true})";
+
+  JSON_BENCHMARK(1e5, [=]{
+    decode(default_codec<message_t>(), json);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_cached_default_codec) {
+  const std::string json = R"({"id":"abc","integer":17,"flag":true})";
+
+  JSON_BENCHMARK(1e5, [=]{
+    decode<message_t>(json);
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/detail/parallel_for.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/parallel_decode.hpp>
+#include <spotify/json/parallel_encode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+namespace spotify {
+namespace json {
+namespace {
+
+struct track_t {
+  std::string uri;
+  std::string title;
+  int duration;
+  std::vector<std::string> artists;
+};
+
+}  // namespace
+
+template <>
+struct default_codec_t<track_t> {
+  static codec::object_t<track_t> codec() {
+    auto codec = codec::object<track_t>();
+    codec.required("uri", &track_t::uri);
+    codec.required("title", &track_t::title);
+    codec.required("duration", &track_t::duration);
+    codec.optional("artists", &track_t::artists);
+    return codec;
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+std::string generate_tracks(const std::size_t count) {
+  std::string json = "[";
+  for (std::size_t i = 0; i < count; i++) {
+    json += (i ? "," : "");
+    json += "{\"uri\":\"spotify:track:" + std::to_string(i * 7919) + "\",\"title\":\"Track \\\"" +
+            std::to_string(i) + "\\\"\",\"duration\":" + std::to_string(i % 600000) +
+            ",\"artists\":[\"Artist A\",\"Artist B\"]}";
+  }
+  return json + "]";
+}
+
+std::vector<std::size_t> thread_counts() {
+  const auto max_threads = detail::default_thread_count();
+  std::vector<std::size_t> counts;
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(max_threads);
+  return counts;
+}
+
+template <typename function_type>
+void report(const std::string &name, const std::size_t bytes, const function_type &function) {
+  using namespace std::chrono;
+  const auto before = high_resolution_clock::now();
+  function();
+  const auto duration = duration_cast<microseconds>(high_resolution_clock::now() - before).count();
+  std::cerr
+      << name << ": "
+      << (bytes / std::max<double>(duration, 1)) << " MB/s, "
+      << (duration / 1000) << " ms total"
+      << std::endl;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_parallel_decode_array_scaling) {
+  const auto json = generate_tracks(200000);
+  const auto codec = default_codec<std::vector<track_t>>();
+
+  report("decode", json.size(), [&]{
+    BOOST_REQUIRE_EQUAL(decode(codec, json).size(), 200000);
+  });
+
+  for (const auto threads : thread_counts()) {
+    parallel_options options;
+    options.threads = threads;
+    report("parallel_decode (" + std::to_string(threads) + " threads)", json.size(), [&]{
+      BOOST_REQUIRE_EQUAL(parallel_decode(codec, json, options).size(), 200000);
+    });
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_parallel_encode_array_scaling) {
+  const auto codec = default_codec<std::vector<track_t>>();
+  const auto tracks = decode(codec, generate_tracks(200000));
+  const auto size = encode(codec, tracks).size();
+
+  report("encode", size, [&]{
+    BOOST_REQUIRE_EQUAL(encode(codec, tracks).size(), size);
+  });
+
+  for (const auto threads : thread_counts()) {
+    parallel_options options;
+    options.threads = threads;
+    report("parallel_encode (" + std::to_string(threads) + " threads)", size, [&]{
+      BOOST_REQUIRE_EQUAL(parallel_encode(codec, tracks, options).size(), size);
+    });
+    report("parallel_encode_segments (" + std::to_string(threads) + " threads)", size, [&]{
+      BOOST_REQUIRE_EQUAL(parallel_encode_segments(codec, tracks, options).size(), size);
+    });
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
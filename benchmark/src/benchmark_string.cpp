@@ -15,13 +15,17 @@
  */
 
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/array.hpp>
 #include <spotify/json/codec/string.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encode.hpp>
+#include <spotify/json/fixed_string.hpp>
+#include <spotify/json/interned_string.hpp>
 
 #include <spotify/json/benchmark/benchmark.hpp>
 
@@ -102,6 +106,81 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_simple_tiny_string) {
   });
 }
 
+/*
+ * Interning
+ */
+
+std::string generate_country_codes(size_t count) {
+  static const char *codes[] = { "SE", "US", "GB", "DE", "FR", "BR", "JP", "MX" };
+  std::string json = "[";
+  for (size_t i = 0; i < count; i++) {
+    json += std::string("\"") + codes[(i * 7) % 8] + "\",";
+  }
+  json.back() = ']';
+  return json;
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_repeated_strings) {
+  const auto codec = default_codec<std::vector<std::string>>();
+  const auto json = generate_country_codes(10000);
+  JSON_BENCHMARK(1e2, [=]{
+    decode(codec, json);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_repeated_interned_strings) {
+  const auto codec = default_codec<std::vector<json::interned_string>>();
+  const auto json = generate_country_codes(10000);
+  JSON_BENCHMARK(1e2, [=]{
+    decode(codec, json);
+  });
+}
+
+/*
+ * Fixed capacity strings
+ */
+
+std::string generate_ids(size_t count) {
+  std::string json = "[";
+  for (size_t i = 0; i < count; i++) {
+    json += "\"" + generate_simple_string(16) + std::to_string(100000 + i) + "\",";
+  }
+  json.back() = ']';
+  return json;
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_ids) {
+  const auto codec = default_codec<std::vector<std::string>>();
+  const auto json = generate_ids(10000);
+  JSON_BENCHMARK(1e2, [=]{
+    decode(codec, json);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_fixed_string_ids) {
+  const auto codec = default_codec<std::vector<json::fixed_string<22>>>();
+  const auto json = generate_ids(10000);
+  JSON_BENCHMARK(1e2, [=]{
+    decode(codec, json);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_ids) {
+  const auto codec = default_codec<std::vector<std::string>>();
+  const auto ids = decode(codec, generate_ids(10000));
+  JSON_BENCHMARK(1e2, [=]{
+    encode(codec, ids);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_fixed_string_ids) {
+  const auto codec = default_codec<std::vector<json::fixed_string<22>>>();
+  const auto ids = decode(codec, generate_ids(10000));
+  JSON_BENCHMARK(1e2, [=]{
+    encode(codec, ids);
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
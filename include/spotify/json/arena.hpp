@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A monotonic arena: memory is handed out by bumping a pointer through large
+ * blocks, individual allocations are never freed, and all memory is released
+ * at once when the arena is destroyed or reset. This makes allocation a few
+ * instructions and deallocation of any number of objects a handful of calls
+ * to std::free. Objects placed in the arena must be trivially destructible,
+ * since their destructors are never run.
+ *
+ * Blocks start at 'block_size' bytes and double in size up to 1 MB, and an
+ * allocation that is larger than the next block gets a block of its own. The
+ * arena is not thread safe. It can be used with an encode_context through
+ * arena_allocator(...), in <spotify/json/encode_allocator.hpp>.
+ */
+class monotonic_arena final {
+ public:
+  explicit monotonic_arena(std::size_t block_size = 4096)
+      : _next_block_size(block_size ? block_size : 1) {}
+
+  monotonic_arena(monotonic_arena &&other) noexcept;
+  monotonic_arena &operator=(monotonic_arena &&other) noexcept;
+  monotonic_arena(const monotonic_arena &) = delete;
+  monotonic_arena &operator=(const monotonic_arena &) = delete;
+
+  ~monotonic_arena();
+
+  /**
+   * Allocate 'size' bytes, aligned to 'alignment', which must be a power of
+   * two. Throws std::bad_alloc if the memory cannot be allocated.
+   */
+  json_force_inline void *allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) {
+    const auto position = (reinterpret_cast<uintptr_t>(_position) + alignment - 1) & ~uintptr_t(alignment - 1);
+    if (json_likely(position + size <= reinterpret_cast<uintptr_t>(_end) && _position)) {
+      _position = reinterpret_cast<char *>(position + size);
+      return reinterpret_cast<void *>(position);
+    }
+    return allocate_slow(size, alignment);
+  }
+
+  /**
+   * Allocate uninitialized memory for 'n' objects of type T.
+   */
+  template <typename T>
+  json_force_inline T *allocate_array(const std::size_t n) {
+    return static_cast<T *>(allocate(n * sizeof(T), alignof(T)));
+  }
+
+  /**
+   * Release all memory, except for the most recently allocated block, which
+   * is kept for reuse.
+   */
+  void reset();
+
+  /**
+   * The number of bytes in the blocks that the arena holds.
+   */
+  std::size_t capacity() const {
+    return _capacity;
+  }
+
+ private:
+  struct block;
+
+  void *allocate_slow(std::size_t size, std::size_t alignment);
+  void release(block *first);
+
+  block *_blocks = nullptr;
+  char *_position = nullptr;
+  char *_end = nullptr;
+  std::size_t _next_block_size;
+  std::size_t _capacity = 0;
+};
+
+}  // namespace json
+}  // namespace spotify
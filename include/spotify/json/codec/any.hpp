@@ -45,6 +45,10 @@ class any_t final {
     _codec->encode(context, value);
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return _codec->measure(context, value);
+  }
+
   bool should_encode(const object_type &value) const {
     return _codec->should_encode(value);
   }
@@ -56,6 +60,7 @@ class any_t final {
 
     virtual object_type decode(decode_context &context) const = 0;
     virtual void encode(encode_context &context, const object_type &value) const = 0;
+    virtual std::size_t measure(const encode_context &context, const object_type &value) const = 0;
     virtual bool should_encode(const object_type &value) const = 0;
   };
 
@@ -73,6 +78,10 @@ class any_t final {
       _codec.encode(context, value);
     }
 
+    std::size_t measure(const encode_context &context, const object_type &value) const override {
+      return detail::measure(context, _codec, value);
+    }
+
     bool should_encode(const object_type &value) const override {
       return detail::should_encode(_codec, value);
     }
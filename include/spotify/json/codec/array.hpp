@@ -97,23 +97,23 @@ struct associative_inserter {
 
 template <typename T> struct container_inserter;
 
-template <typename T>
-struct container_inserter<std::vector<T>> : public sequence_inserter {};
+template <typename T, typename A>
+struct container_inserter<std::vector<T, A>> : public sequence_inserter {};
 
-template <typename T>
-struct container_inserter<std::deque<T>> : public sequence_inserter {};
+template <typename T, typename A>
+struct container_inserter<std::deque<T, A>> : public sequence_inserter {};
 
-template <typename T>
-struct container_inserter<std::list<T>> : public sequence_inserter {};
+template <typename T, typename A>
+struct container_inserter<std::list<T, A>> : public sequence_inserter {};
 
 template <typename T, size_t Size>
 struct container_inserter<std::array<T, Size>> : public fixed_size_sequence_inserter {};
 
-template <typename T>
-struct container_inserter<std::set<T>> : public associative_inserter {};
+template <typename T, typename C, typename A>
+struct container_inserter<std::set<T, C, A>> : public associative_inserter {};
 
-template <typename T>
-struct container_inserter<std::unordered_set<T>> : public associative_inserter {};
+template <typename T, typename H, typename E, typename A>
+struct container_inserter<std::unordered_set<T, H, E, A>> : public associative_inserter {};
 
 }  // namespace detail
 
@@ -135,7 +135,7 @@ class array_t final {
 
   object_type decode(decode_context &context) const {
     using inserter = detail::container_inserter<T>;
-    object_type output;
+    auto output = detail::construct_container<object_type>(context);
     typename inserter::state state = inserter::init_state;
     detail::decode_comma_separated(context, '[', ']', [&]{
       state = inserter::insert(
@@ -147,13 +147,37 @@ class array_t final {
 
   void encode(encode_context &context, const object_type &array) const {
     context.append('[');
+    encode_elements(context, array.begin(), array.end());
+    context.append_or_replace(',', ']');
+  }
+
+  /**
+   * Encode the elements in [begin, end), each followed by a ','. This is the
+   * part of encode(...) between the brackets, and lets the elements of a large
+   * array be encoded in separate pieces; see parallel_encode(...).
+   */
+  template <typename iterator_type>
+  void encode_elements(encode_context &context, iterator_type begin, const iterator_type end) const {
+    for (; begin != end; ++begin) {
+      if (json_likely(detail::should_encode(_inner_codec, *begin))) {
+        _inner_codec.encode(context, *begin);
+        context.append(',');
+      }
+    }
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &array) const {
+    std::size_t size = 1;  // '['
     for (const auto &element : array) {
       if (json_likely(detail::should_encode(_inner_codec, element))) {
-        _inner_codec.encode(context, element);
-        context.append(',');
+        size += detail::measure(context, _inner_codec, element) + 1;  // + ','
       }
     }
-    context.append_or_replace(',', ']');
+    return size + (size == 1 ? 1 : 0);  // the last ',' is replaced with ']'
+  }
+
+  const codec_type &inner_codec() const {
+    return _inner_codec;
   }
 
  private:
@@ -167,24 +191,24 @@ array_t<T, typename std::decay<codec_type>::type> array(codec_type &&inner_codec
 
 }  // namespace codec
 
-template <typename T>
-struct default_codec_t<std::vector<T>> {
-  static decltype(codec::array<std::vector<T>>(default_codec<T>())) codec() {
-    return codec::array<std::vector<T>>(default_codec<T>());
+template <typename T, typename A>
+struct default_codec_t<std::vector<T, A>> {
+  static decltype(codec::array<std::vector<T, A>>(default_codec<T>())) codec() {
+    return codec::array<std::vector<T, A>>(default_codec<T>());
   }
 };
 
-template <typename T>
-struct default_codec_t<std::deque<T>> {
-  static decltype(codec::array<std::deque<T>>(default_codec<T>())) codec() {
-    return codec::array<std::deque<T>>(default_codec<T>());
+template <typename T, typename A>
+struct default_codec_t<std::deque<T, A>> {
+  static decltype(codec::array<std::deque<T, A>>(default_codec<T>())) codec() {
+    return codec::array<std::deque<T, A>>(default_codec<T>());
   }
 };
 
-template <typename T>
-struct default_codec_t<std::list<T>> {
-  static decltype(codec::array<std::list<T>>(default_codec<T>())) codec() {
-    return codec::array<std::list<T>>(default_codec<T>());
+template <typename T, typename A>
+struct default_codec_t<std::list<T, A>> {
+  static decltype(codec::array<std::list<T, A>>(default_codec<T>())) codec() {
+    return codec::array<std::list<T, A>>(default_codec<T>());
   }
 };
 
@@ -195,17 +219,17 @@ struct default_codec_t<std::array<T, size>> {
   }
 };
 
-template <typename T>
-struct default_codec_t<std::set<T>> {
-  static decltype(codec::array<std::set<T>>(default_codec<T>())) codec() {
-    return codec::array<std::set<T>>(default_codec<T>());
+template <typename T, typename C, typename A>
+struct default_codec_t<std::set<T, C, A>> {
+  static decltype(codec::array<std::set<T, C, A>>(default_codec<T>())) codec() {
+    return codec::array<std::set<T, C, A>>(default_codec<T>());
   }
 };
 
-template <typename T>
-struct default_codec_t<std::unordered_set<T>> {
-  static decltype(codec::array<std::unordered_set<T>>(default_codec<T>())) codec() {
-    return codec::array<std::unordered_set<T>>(default_codec<T>());
+template <typename T, typename H, typename E, typename A>
+struct default_codec_t<std::unordered_set<T, H, E, A>> {
+  static decltype(codec::array<std::unordered_set<T, H, E, A>>(default_codec<T>())) codec() {
+    return codec::array<std::unordered_set<T, H, E, A>>(default_codec<T>());
   }
 };
 
@@ -50,6 +50,10 @@ class boolean_t final {
     buffer[needed - 1] = 'e'; // write the missing 'e' in 'false' (or overwrite it in 'true')
     context.advance(needed);
   }
+
+  std::size_t measure(const encode_context &context, const object_type value) const {
+    return 5 - size_t(value);
+  }
 };
 
 inline boolean_t boolean() {
@@ -74,6 +74,11 @@ class optional_t final {
     _inner_codec.encode(context, *value);
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    detail::fail_if(context, !value, "Cannot encode uninitialized optional");
+    return detail::measure(context, _inner_codec, *value);
+  }
+
   bool should_encode(const object_type &value) const {
     return (value != boost::none) && detail::should_encode(_inner_codec, *value);
   }
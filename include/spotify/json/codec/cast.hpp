@@ -20,6 +20,7 @@
 #include <utility>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -53,6 +54,11 @@ class cast_t {
     _inner_codec.encode(context, codec_cast<inner_type, T>::cast(value));
   }
 
+  std::size_t measure(const encode_context &context, object_type value) const {
+    using inner_type = typename codec_type::object_type;
+    return detail::measure(context, _inner_codec, codec_cast<inner_type, T>::cast(value));
+  }
+
  private:
   codec_type _inner_codec;
 };
@@ -25,6 +25,7 @@
 #include <spotify/json/codec/enumeration.hpp>
 #include <spotify/json/codec/eq.hpp>
 #include <spotify/json/codec/ignore.hpp>
+#include <spotify/json/codec/lazy.hpp>
 #include <spotify/json/codec/map.hpp>
 #include <spotify/json/codec/null.hpp>
 #include <spotify/json/codec/number.hpp>
@@ -32,6 +33,7 @@
 #include <spotify/json/codec/omit.hpp>
 #include <spotify/json/codec/one_of.hpp>
 #include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/shared.hpp>
 #include <spotify/json/codec/smart_ptr.hpp>
 #include <spotify/json/codec/string.hpp>
 #include <spotify/json/codec/transform.hpp>
@@ -22,6 +22,7 @@
 #include <spotify/json/codec/omit.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -69,6 +70,14 @@ class empty_as_t final {
     }
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    if (value == _default) {
+      return detail::measure(context, _empty_codec, value);
+    } else {
+      return detail::measure(context, _inner_codec, value);
+    }
+  }
+
   bool should_encode(const object_type &value) const {
     if (value == _default) {
       return detail::should_encode(_empty_codec, value);
@@ -62,6 +62,12 @@ class enumeration_t final {
     _inner_codec.encode(context, (*it).second);
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    const auto it = find(value);
+    detail::fail_if(context, it == _mapping.end(), "Encoding unknown enumeration value");
+    return detail::measure(context, _inner_codec, (*it).second);
+  }
+
   bool should_encode(const object_type &value) const {
     return find(value) != _mapping.end();
   }
@@ -52,6 +52,10 @@ class eq_t final {
     _inner_codec.encode(context, _value);
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return detail::measure(context, _inner_codec, _value);
+  }
+
   bool should_encode(const object_type &value) const {
     return detail::should_encode(_inner_codec, value);
   }
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+template <typename T>
+struct lazy_decoder {
+  virtual ~lazy_decoder() = default;
+  virtual T decode(const codec::raw_ref &raw) const = 0;
+};
+
+template <typename codec_type>
+class lazy_decoder_t final : public lazy_decoder<typename codec_type::object_type> {
+ public:
+  explicit lazy_decoder_t(codec_type codec)
+      : _codec(std::move(codec)) {}
+
+  typename codec_type::object_type decode(const codec::raw_ref &raw) const override {
+    decode_context context(raw.data(), raw.size());
+    auto value = _codec.decode(context);
+    fail_if(context, context.position != context.end, "Unexpected trailing input");
+    return value;
+  }
+
+ private:
+  codec_type _codec;
+};
+
+}  // namespace detail
+
+/**
+ * A value that is decoded on first access rather than when the surrounding
+ * document is decoded; see codec::lazy(...). Until then, a lazy value only
+ * holds a reference to its JSON in the input, so the input must outlive it (or
+ * at least, must outlive the first access and any encoding of the untouched
+ * value). Decoding is thread safe and happens at most once, unless it fails,
+ * in which case each access throws the decode_exception. The offsets of such
+ * exceptions are relative to the start of the lazy value.
+ *
+ * Copies share the decoded value until one of them is modified through get().
+ */
+template <typename T>
+class lazy final {
+ public:
+  lazy()
+      : lazy(T()) {}
+
+  lazy(T value)
+      : _state(std::make_shared<state>(std::move(value))) {}
+
+  lazy(const codec::raw_ref &raw, std::shared_ptr<const detail::lazy_decoder<T>> decoder)
+      : _state(std::make_shared<state>(raw, std::move(decoder))) {}
+
+  const T &get() const {
+    auto &state = *_state;
+    if (json_unlikely(!state.is_decoded.load(std::memory_order_acquire))) {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (!state.is_decoded.load(std::memory_order_relaxed)) {
+        state.value = state.decoder->decode(state.raw);
+        state.is_decoded.store(true, std::memory_order_release);
+      }
+    }
+    return state.value;
+  }
+
+  /**
+   * Mutable access decodes the value, if that has not been done yet, and makes
+   * the value forget its original JSON, so that it is encoded from the value.
+   */
+  T &get() {
+    static_cast<const lazy &>(*this).get();
+    if (_state.use_count() != 1) {
+      _state = std::make_shared<state>(_state->value);
+    } else {
+      _state->raw = codec::raw_ref();
+    }
+    return _state->value;
+  }
+
+  const T &operator*() const { return get(); }
+  T &operator*() { return get(); }
+  const T *operator->() const { return &get(); }
+  T *operator->() { return &get(); }
+
+  bool is_decoded() const {
+    return _state->is_decoded.load(std::memory_order_acquire);
+  }
+
+  /**
+   * The original JSON of an unmodified, lazily decoded value, or an empty
+   * raw_ref if the value was created or modified by the application.
+   */
+  const codec::raw_ref &raw() const {
+    return _state->raw;
+  }
+
+ private:
+  struct state {
+    explicit state(T value)
+        : is_decoded(true),
+          value(std::move(value)) {}
+
+    state(const codec::raw_ref &raw, std::shared_ptr<const detail::lazy_decoder<T>> decoder)
+        : raw(raw),
+          decoder(std::move(decoder)),
+          is_decoded(false) {}
+
+    codec::raw_ref raw;
+    std::shared_ptr<const detail::lazy_decoder<T>> decoder;
+    std::mutex mutex;
+    std::atomic<bool> is_decoded;
+    T value;
+  };
+
+  std::shared_ptr<state> _state;
+};
+
+namespace codec {
+
+template <typename codec_type>
+class lazy_t final {
+ public:
+  using object_type = json::lazy<typename codec_type::object_type>;
+
+  explicit lazy_t(codec_type inner_codec)
+      : _inner_codec(std::move(inner_codec)),
+        _decoder(std::make_shared<detail::lazy_decoder_t<codec_type>>(_inner_codec)) {}
+
+  object_type decode(decode_context &context) const {
+    const auto begin = context.position;
+    detail::skip_value(context);
+    return object_type(raw_ref(begin, context.position), _decoder);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    const auto &raw = value.raw();
+    if (raw.data()) {
+      raw_t<raw_ref>().encode(context, raw);
+    } else {
+      _inner_codec.encode(context, value.get());
+    }
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    const auto &raw = value.raw();
+    return (raw.data() ? raw.size() : detail::measure(context, _inner_codec, value.get()));
+  }
+
+  bool should_encode(const object_type &value) const {
+    return value.raw().data() || detail::should_encode(_inner_codec, value.get());
+  }
+
+ private:
+  codec_type _inner_codec;
+  std::shared_ptr<const detail::lazy_decoder<typename codec_type::object_type>> _decoder;
+};
+
+template <typename codec_type>
+lazy_t<typename std::decay<codec_type>::type> lazy(codec_type &&inner_codec) {
+  return lazy_t<typename std::decay<codec_type>::type>(std::forward<codec_type>(inner_codec));
+}
+
+}  // namespace codec
+
+template <typename T>
+struct default_codec_t<lazy<T>> {
+  static decltype(codec::lazy(default_codec<T>())) codec() {
+    return codec::lazy(default_codec<T>());
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -28,16 +28,42 @@
 
 namespace spotify {
 namespace json {
+namespace detail {
+
+/**
+ * R, if the default codec of key_type is a string codec. The default codecs
+ * of maps only exist for keys that can be JSON object keys.
+ */
+template <typename key_type, typename R>
+using if_string_key = typename std::enable_if<
+    is_string_codec<decltype(default_codec<key_type>())>::value, R>::type;
+
+}  // namespace detail
+
 namespace codec {
 
-template <typename T, typename codec_type>
+/**
+ * A codec for maps from strings to values, encoded as JSON objects. The keys
+ * are decoded and encoded with key_codec_type, which must be a string codec
+ * (see detail::is_string_codec); by default, it is the default codec of the
+ * key type.
+ */
+template <
+    typename T,
+    typename codec_type,
+    typename key_codec_type = decltype(default_codec<typename T::key_type>())>
 class map_t final {
  public:
   using object_type = T;
 
   static_assert(
-      std::is_same<typename T::key_type, std::string>::value,
-      "Map key type must be string");
+      std::is_same<
+          typename T::key_type,
+          typename key_codec_type::object_type>::value,
+      "Map key type must match key codec type");
+  static_assert(
+      detail::is_string_codec<key_codec_type>::value,
+      "Map key codec must be a string codec");
   static_assert(
       std::is_same<
           typename T::mapped_type,
@@ -47,32 +73,56 @@ class map_t final {
   explicit map_t(codec_type inner_codec)
       : _inner_codec(std::move(inner_codec)) {}
 
+  map_t(key_codec_type key_codec, codec_type inner_codec)
+      : _key_codec(std::move(key_codec)),
+        _inner_codec(std::move(inner_codec)) {}
+
   object_type decode(decode_context &context) const {
-    using value_type = typename object_type::value_type;
-    object_type output;
-    detail::decode_object<string_t>(
+    auto output = detail::construct_container<object_type>(context);
+    detail::decode_object(
         context,
-        [&](std::string &&key) {
-          output.insert(value_type(std::move(key), _inner_codec.decode(context)));
+        _key_codec,
+        [&](typename object_type::key_type &&key) {
+          output.emplace(std::move(key), _inner_codec.decode(context));
         });
     return output;
   }
 
   void encode(encode_context &context, const object_type &map) const {
     context.append('{');
-    for (const auto &element : map) {
-      if (json_likely(detail::should_encode(_inner_codec, element.second))) {
-        _string_codec.encode(context, element.first);
+    encode_elements(context, map.begin(), map.end());
+    context.append_or_replace(',', '}');
+  }
+
+  /**
+   * Encode the entries in [begin, end), each followed by a ','. This is the
+   * part of encode(...) between the braces; see parallel_encode(...).
+   */
+  template <typename iterator_type>
+  void encode_elements(encode_context &context, iterator_type begin, const iterator_type end) const {
+    for (; begin != end; ++begin) {
+      if (json_likely(detail::should_encode(_inner_codec, begin->second))) {
+        _key_codec.encode(context, begin->first);
         context.append(':');
-        _inner_codec.encode(context, element.second);
+        _inner_codec.encode(context, begin->second);
         context.append(',');
       }
     }
-    context.append_or_replace(',', '}');
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &map) const {
+    std::size_t size = 1;  // '{'
+    for (const auto &element : map) {
+      if (json_likely(detail::should_encode(_inner_codec, element.second))) {
+        size += detail::measure(context, _key_codec, element.first) + 1;  // + ':'
+        size += detail::measure(context, _inner_codec, element.second) + 1;  // + ','
+      }
+    }
+    return size + (size == 1 ? 1 : 0);  // the last ',' is replaced with '}'
   }
 
  private:
-  string_t _string_codec;
+  key_codec_type _key_codec;
   codec_type _inner_codec;
 };
 
@@ -81,19 +131,34 @@ map_t<T, typename std::decay<codec_type>::type> map(codec_type &&inner_codec) {
   return map_t<T, typename std::decay<codec_type>::type>(std::forward<codec_type>(inner_codec));
 }
 
+template <typename T, typename key_codec_type, typename codec_type>
+map_t<T, typename std::decay<codec_type>::type, typename std::decay<key_codec_type>::type> map(
+    key_codec_type &&key_codec,
+    codec_type &&inner_codec) {
+  return map_t<T, typename std::decay<codec_type>::type, typename std::decay<key_codec_type>::type>(
+      std::forward<key_codec_type>(key_codec),
+      std::forward<codec_type>(inner_codec));
+}
+
 }  // namespace codec
 
-template <typename T>
-struct default_codec_t<std::map<std::string, T>> {
-  static decltype(codec::map<std::map<std::string, T>>(default_codec<T>())) codec() {
-    return codec::map<std::map<std::string, T>>(default_codec<T>());
+template <typename S, typename T, typename C, typename A>
+struct default_codec_t<std::map<S, T, C, A>> {
+  template <typename key_type = S>
+  static detail::if_string_key<
+      key_type,
+      decltype(codec::map<std::map<S, T, C, A>>(default_codec<T>()))> codec() {
+    return codec::map<std::map<S, T, C, A>>(default_codec<T>());
   }
 };
 
-template <typename T>
-struct default_codec_t<std::unordered_map<std::string, T>> {
-  static decltype(codec::map<std::unordered_map<std::string, T>>(default_codec<T>())) codec() {
-    return codec::map<std::unordered_map<std::string, T>>(default_codec<T>());
+template <typename S, typename T, typename H, typename E, typename A>
+struct default_codec_t<std::unordered_map<S, T, H, E, A>> {
+  template <typename key_type = S>
+  static detail::if_string_key<
+      key_type,
+      decltype(codec::map<std::unordered_map<S, T, H, E, A>>(default_codec<T>()))> codec() {
+    return codec::map<std::unordered_map<S, T, H, E, A>>(default_codec<T>());
   }
 };
 
@@ -46,6 +46,10 @@ class null_t final {
     context.append("null", 4);
   }
 
+  std::size_t measure(const encode_context &context, const object_type value) const {
+    return 4;
+  }
+
  private:
   object_type _value;
 };
@@ -85,14 +85,32 @@ class floating_point_t {
   }
 
   void encode(encode_context &context, const object_type &value) const {
-    // The maximum buffer size required to emit a double in base 10, for decimal
-    // and exponential representations, is 25 bytes; based on the settings used
-    // below for the DoubleToStringConverter. We add another byte for the null
-    // terminator, but it is not actually needed because we don't finalize the
-    // builder.
-    const auto max_required_size = 26;
+    if (json_unlikely(context.remaining() < max_required_size)) {
+      // Write via the stack to not reserve more than needed at the end of a
+      // fixed size buffer.
+      char buffer[max_required_size];
+      context.append(buffer, write(context, buffer, value));
+      return;
+    }
+
     const auto p = reinterpret_cast<char *>(context.reserve(max_required_size));
+    context.advance(write(context, p, value));
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    char buffer[max_required_size];
+    return write(context, buffer, value);
+  }
 
+ private:
+  // The maximum buffer size required to emit a double in base 10, for decimal
+  // and exponential representations, is 25 bytes; based on the settings used
+  // below for the DoubleToStringConverter. We add another byte for the null
+  // terminator, but it is not actually needed because we don't finalize the
+  // builder.
+  static constexpr int max_required_size = 26;
+
+  static int write(const encode_context &context, char *p, const object_type &value) {
     // The converter is based on the ECMAScript converter, but will not convert
     // special values, like Infinity and NaN, since JSON does not support those.
     using dtoa_converter = double_conversion::DoubleToStringConverter;
@@ -103,7 +121,7 @@ class floating_point_t {
     using dtoa_builder = double_conversion::StringBuilder;
     dtoa_builder builder(p, max_required_size);
     detail::fail_if(context, !converter.ToShortest(value, &builder), "Special values like 'Infinity' or 'NaN' are supported in JSON.");
-    context.advance(builder.position());
+    return builder.position();
   }
 };
 
@@ -418,6 +436,10 @@ class integer_t<T, true, false> {
   json_force_inline void encode(encode_context &context, const object_type value) const {
     encode_positive_integer(context, value);
   }
+
+  json_force_inline std::size_t measure(const encode_context &context, const object_type value) const {
+    return positive_integer_size(value);
+  }
 };
 
 template <typename T>
@@ -438,6 +460,10 @@ class integer_t<T, true, true> {
       encode_positive_integer(context, value);
     }
   }
+
+  json_force_inline std::size_t measure(const encode_context &context, const object_type value) const {
+    return (value < 0 ? negative_integer_size(value) : positive_integer_size(value));
+  }
 };
 
 template <typename T>
@@ -30,9 +30,11 @@
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/bitset.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_value.hpp>
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/projection.hpp>
 
 namespace spotify {
 namespace json {
@@ -48,8 +50,11 @@ class object_t final {
       typename = typename std::enable_if<std::is_default_constructible<U>::value>::type>
   object_t() {}
 
+  /**
+   * Copying is cheap since the fields are shared. There is deliberately no move
+   * constructor, so that a moved-from codec still has its fields.
+   */
   object_t(const object_t<T> &) = default;
-  object_t(object_t<T> &&) = default;
 
   template <
       typename create_function,
@@ -70,13 +75,18 @@ class object_t final {
   }
 
   json_never_inline object_type decode(decode_context &context) const {
+    if (json_unlikely(context.projection)) {
+      return decode_projected(context, *context.projection);
+    }
+
     uint_fast32_t uniq_seen_required = 0;
-    detail::bitset<64> seen_required(_num_required_fields);
+    const auto &fields = *_fields;
+    detail::bitset<64> seen_required(fields.num_required);
 
     object_type output = construct(std::is_default_constructible<T>());
     detail::decode_object<string_t>(context, [&](const std::string &key) {
-      const auto field_it = _fields.find(key);
-      if (json_unlikely(field_it == _fields.end())) {
+      const auto field_it = fields.map.find(key);
+      if (json_unlikely(field_it == fields.map.end())) {
         return detail::skip_value(context);
       }
 
@@ -88,22 +98,77 @@ class object_t final {
       }
     });
 
-    const auto is_missing_req_fields = (uniq_seen_required != _num_required_fields);
+    const auto is_missing_req_fields = (uniq_seen_required != fields.num_required);
     detail::fail_if(context, is_missing_req_fields, "Missing required field(s)");
     return output;
   }
 
   void encode(encode_context &context, const object_type &value) const {
     context.append('{');
-    for (const auto &field : _field_list) {
+    for (const auto &field : _fields->list) {
       field.second->encode(context, field.first, value);
     }
     context.append_or_replace(',', '}');
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    std::size_t size = 0;
+    for (const auto &field : _fields->list) {
+      size += field.second->measure(context, field.first, value);
+    }
+    return 1 + size + (size == 0 ? 1 : 0);  // '{' and '}', which replaces the last ','
+  }
+
  private:
+  /**
+   * Decode only the fields that are selected by the projection, each with the
+   * projection of its value. Unselected fields are skipped, and required fields
+   * are only required if they are selected.
+   */
+  json_never_inline object_type decode_projected(
+      decode_context &context,
+      const detail::projection_node &projection) const {
+    uint_fast32_t uniq_seen_required = 0;
+    const auto &fields = *_fields;
+    detail::bitset<64> seen_required(fields.num_required);
+
+    object_type output = construct(std::is_default_constructible<T>());
+    detail::decode_object<string_t>(context, [&](const std::string &key) {
+      const auto selected_it = projection.fields.find(key);
+      const auto field_it = (selected_it == projection.fields.end() ?
+          fields.map.end() :
+          fields.map.find(key));
+      if (json_unlikely(field_it == fields.map.end())) {
+        return detail::skip_value(context);
+      }
+
+      const auto &field = *(*field_it).second;
+      {
+        const detail::projection_scope scope(context, (*selected_it).second.get());
+        field.decode(context, output);
+      }
+
+      if (field.is_required()) {
+        const auto seen = seen_required.test_and_set(field.required_field_idx());
+        uniq_seen_required += (1 - seen);  // 'seen' is 1 when the field is a duplicate; 0 otherwise
+      }
+    });
+
+    if (uniq_seen_required != fields.num_required) {
+      for (const auto &selected : projection.fields) {
+        const auto field_it = fields.map.find(selected.first);
+        const auto is_missing_req_field = (field_it != fields.map.end() &&
+            (*field_it).second->is_required() &&
+            !seen_required.test((*field_it).second->required_field_idx()));
+        detail::fail_if(context, is_missing_req_field, "Missing required field(s)");
+      }
+    }
+
+    return output;
+  }
+
   static std::string escape_key(const std::string &key) {
-    encode_context context;
+    encode_context context(key.size() + 3);  // room for the quotes and ':' if no escaping is needed
     string().encode(context, key);
     context.append(':');
     return std::string(static_cast<const char *>(context.data()), context.size());
@@ -115,6 +180,18 @@ class object_t final {
     context.append(escaped_key.data(), escaped_key.size());
   }
 
+  template <typename codec_type>
+  json_force_inline static std::size_t measure_key_and_val(
+      const encode_context &context,
+      const std::string &escaped_key,
+      const codec_type &codec,
+      const typename codec_type::object_type &value) {
+    if (json_likely(detail::should_encode(codec, value))) {
+      return escaped_key.size() + detail::measure(context, codec, value) + 1;  // + ','
+    }
+    return 0;
+  }
+
   template <typename codec_type>
   json_force_inline static void append_val_to_context(
       encode_context &context,
@@ -146,6 +223,10 @@ class object_t final {
         encode_context &context,
         const std::string &escaped_key,
         const object_type &object) const = 0;
+    virtual std::size_t measure(
+        const encode_context &context,
+        const std::string &escaped_key,
+        const object_type &object) const = 0;
 
     json_force_inline bool is_required() const { return (_data != json_size_t_max); }
     json_force_inline size_t required_field_idx() const { return _data; }
@@ -175,6 +256,13 @@ class object_t final {
       }
     }
 
+    std::size_t measure(
+        const encode_context &context,
+        const std::string &escaped_key,
+        const object_type &object) const override {
+      return measure_key_and_val(context, escaped_key, codec, typename codec_type::object_type());
+    }
+
     codec_type codec;
   };
 
@@ -200,6 +288,13 @@ class object_t final {
       }
     }
 
+    std::size_t measure(
+        const encode_context &context,
+        const std::string &escaped_key,
+        const object_type &object) const override {
+      return measure_key_and_val(context, escaped_key, codec, object.*member);
+    }
+
     codec_type codec;
     member_ptr member;
   };
@@ -228,6 +323,13 @@ class object_t final {
       }
     }
 
+    std::size_t measure(
+        const encode_context &context,
+        const std::string &escaped_key,
+        const object_type &object) const override {
+      return measure_key_and_val(context, escaped_key, codec, (object.*getter)());
+    }
+
     codec_type codec;
     getter_ptr getter;
     setter_ptr setter;
@@ -258,6 +360,13 @@ class object_t final {
       }
     }
 
+    std::size_t measure(
+        const encode_context &context,
+        const std::string &escaped_key,
+        const object_type &object) const override {
+      return measure_key_and_val(context, escaped_key, codec, get(object));
+    }
+
     codec_type codec;
     getter get;
     setter set;
@@ -278,7 +387,7 @@ class object_t final {
     using field_type = member_var_field<member_ptr, typename std::decay<codec_type>::type>;
     save_field(name, required, std::make_shared<field_type>(
         required,
-        _num_required_fields,
+        _fields->num_required,
         std::forward<codec_type>(codec),
         member));
   }
@@ -313,7 +422,7 @@ class object_t final {
     using field_type = member_fn_field<getter_ptr, setter_ptr, typename std::decay<codec_type>::type>;
     save_field(name, required, std::make_shared<field_type>(
         required,
-        _num_required_fields,
+        _fields->num_required,
         std::forward<codec_type>(codec),
         getter,
         setter));
@@ -336,7 +445,7 @@ class object_t final {
         typename std::decay<setter>::type,
         typename std::decay<codec_type>::type>;
     save_field(name, required, std::make_shared<field_type>(required,
-        _num_required_fields,
+        _fields->num_required,
         std::forward<codec_type>(codec),
         std::forward<getter>(get),
         std::forward<setter>(set)));
@@ -348,30 +457,45 @@ class object_t final {
     using field_type = dummy_field<typename std::decay<codec_type>::type>;
     save_field(name, required, std::make_shared<field_type>(
         required,
-        _num_required_fields,
+        _fields->num_required,
         std::forward<codec_type>(codec)));
   }
 
   void save_field(const std::string &name, bool required, const std::shared_ptr<field> &f) {
-    const auto was_saved = _fields.insert(typename field_map::value_type(name, f)).second;
+    if (_fields.use_count() != 1) {
+      // Copies of this codec share the fields, so copy them before changing.
+      _fields = std::make_shared<field_set>(*_fields);
+    }
+
+    const auto was_saved = _fields->map.insert(typename field_map::value_type(name, f)).second;
     if (was_saved) {
-      _field_list.push_back(std::make_pair(escape_key(name), f));
-      _num_required_fields += size_t(required);
+      _fields->list.push_back(std::make_pair(escape_key(name), f));
+      _fields->num_required += size_t(required);
     }
   }
 
   using field_vec = std::vector<std::pair<std::string, std::shared_ptr<const field>>>;
   using field_map = std::unordered_map<std::string, std::shared_ptr<const field>>;
 
+  struct field_set final {
+    field_vec list;
+    field_map map;
+    size_t num_required = 0;
+  };
+
   /**
    * _construct may be unset, but only if T is default constructible. This is
    * enforced compile time by enabling the constructor that doesn't set it only
    * if T is default constructible.
    */
   const std::function<T ()> _construct;
-  field_vec _field_list;
-  field_map _fields;
-  size_t _num_required_fields = 0;
+
+  /**
+   * The fields are shared between copies of the codec, which makes copying it,
+   * e.g., when nesting it in other codecs, cheap. Adding a field to a codec
+   * that shares its fields copies them first.
+   */
+  std::shared_ptr<field_set> _fields = std::make_shared<field_set>();
 };
 
 template <typename T>
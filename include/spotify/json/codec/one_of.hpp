@@ -20,6 +20,7 @@
 #include <type_traits>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -98,6 +99,10 @@ class one_of_t final {
     std::get<0>(_codecs).encode(context, value);
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return detail::measure(context, std::get<0>(_codecs), value);
+  }
+
   bool should_encode(const object_type &value) const {
     return detail::should_encode(std::get<0>(_codecs), value);
   }
@@ -21,6 +21,7 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_value.hpp>
 #include <spotify/json/encode_context.hpp>
 
@@ -43,6 +44,26 @@ struct raw_ref {
   std::size_t _size;
 };
 
+}  // namespace codec
+
+namespace detail {
+
+/**
+ * Constructs the values of raw_t<T> from the range of the input that holds
+ * them. Specialize this for types that need more than the range, e.g., the
+ * owner of the input; see shared_slice.hpp.
+ */
+template <typename T>
+struct make_raw_value {
+  static T make(const decode_context &, const char *begin, const char *end) {
+    return T(begin, end);
+  }
+};
+
+}  // namespace detail
+
+namespace codec {
+
 template <typename T>
 class raw_t final {
  public:
@@ -52,13 +73,22 @@ class raw_t final {
     const auto begin = context.position;
     detail::skip_value(context);
     const auto end = context.position;
-    return object_type(begin, end);
+    return detail::make_raw_value<object_type>::make(context, begin, end);
   }
 
   void encode(encode_context &context, const object_type &value) const {
+    if (json_unlikely(context.should_reference(value.size()))) {
+      context.append_reference(value.data(), value.size());
+      return;
+    }
+
     std::memcpy(context.reserve(value.size()), value.data(), value.size());
     context.advance(value.size());
   }
+
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return value.size();
+  }
 };
 
 template <typename T>
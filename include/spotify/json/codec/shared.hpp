@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * Codec that shares another codec by pointer, so that copying it, e.g., when
+ * nesting it in other codecs, only copies a pointer. Unlike any_t, the type of
+ * the inner codec is not erased, so calling it does not involve virtual calls.
+ */
+template <typename codec_type>
+class shared_t final {
+ public:
+  using object_type = typename codec_type::object_type;
+
+  explicit shared_t(std::shared_ptr<const codec_type> inner_codec)
+      : _inner_codec(std::move(inner_codec)) {}
+
+  object_type decode(decode_context &context) const {
+    return _inner_codec->decode(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    _inner_codec->encode(context, value);
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return detail::measure(context, *_inner_codec, value);
+  }
+
+  bool should_encode(const object_type &value) const {
+    return detail::should_encode(*_inner_codec, value);
+  }
+
+ private:
+  std::shared_ptr<const codec_type> _inner_codec;
+};
+
+template <typename codec_type>
+shared_t<typename std::decay<codec_type>::type> shared(codec_type &&inner_codec) {
+  using inner_type = typename std::decay<codec_type>::type;
+  return shared_t<inner_type>(std::make_shared<const inner_type>(std::forward<codec_type>(inner_codec)));
+}
+
+/**
+ * Share the process wide default codec for T; see cached_default_codec<T>().
+ * That codec is never destroyed, so the pointer does not need reference
+ * counting and copying the shared_t is as cheap as copying a plain pointer.
+ */
+template <typename T>
+shared_t<decltype(default_codec<T>())> shared_default() {
+  using inner_type = decltype(default_codec<T>());
+  const std::shared_ptr<const inner_type> no_owner;
+  return shared_t<inner_type>(std::shared_ptr<const inner_type>(no_owner, &cached_default_codec<T>()));
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
@@ -16,12 +16,14 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/monotonic_allocator.hpp>
 
 namespace spotify {
 namespace json {
@@ -52,7 +54,32 @@ struct make_smart_ptr_t<std::shared_ptr<T>> {
 
 namespace detail {
 
-template <typename codec_type, typename T>
+template <typename T>
+struct decode_smart_ptr {
+  template <typename Obj>
+  static T make(const decode_context &, Obj &&obj) {
+    return codec::make_smart_ptr_t<T>::make(std::forward<Obj>(obj));
+  }
+};
+
+/**
+ * Shared pointers that are allocated in the arena of the decode context,
+ * together with their control block, or on the heap when there is no arena.
+ */
+template <typename T>
+struct decode_arena_shared_ptr {
+  template <typename Obj>
+  static std::shared_ptr<T> make(const decode_context &context, Obj &&obj) {
+    using object_type = typename std::decay<Obj>::type;
+    if (context.arena) {
+      const auto allocator = monotonic_allocator<object_type>(context.arena);
+      return std::allocate_shared<object_type>(allocator, std::forward<Obj>(obj));
+    }
+    return std::make_shared<object_type>(std::forward<Obj>(obj));
+  }
+};
+
+template <typename codec_type, typename T, typename maker_type = decode_smart_ptr<T>>
 class smart_ptr_t final {
  public:
   using object_type = T;
@@ -61,7 +88,7 @@ class smart_ptr_t final {
       : _inner_codec(std::move(inner_codec)) {}
 
   object_type decode(decode_context &context) const {
-    return codec::make_smart_ptr_t<object_type>::make(_inner_codec.decode(context));
+    return maker_type::make(context, _inner_codec.decode(context));
   }
 
   void encode(encode_context &context, const object_type &value) const {
@@ -69,6 +96,11 @@ class smart_ptr_t final {
     _inner_codec.encode(context, *value);
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    detail::fail_if(context, !value, "Cannot encode null smart pointer");
+    return detail::measure(context, _inner_codec, *value);
+  }
+
   bool should_encode(const object_type &value) const {
     return bool(value);
   }
@@ -87,6 +119,17 @@ using unique_ptr_t = detail::smart_ptr_t<codec_type, std::unique_ptr<typename co
 template <typename codec_type>
 using shared_ptr_t = detail::smart_ptr_t<codec_type, std::shared_ptr<typename codec_type::object_type>>;
 
+/**
+ * Decodes into a std::shared_ptr that is allocated in the arena that is given
+ * to decode(), so the pointer must not outlive the arena, not even through
+ * copies. Without an arena, it decodes to the heap like shared_ptr_t.
+ */
+template <typename codec_type>
+using arena_shared_ptr_t = detail::smart_ptr_t<
+    codec_type,
+    std::shared_ptr<typename codec_type::object_type>,
+    detail::decode_arena_shared_ptr<typename codec_type::object_type>>;
+
 template <typename codec_type>
 unique_ptr_t<typename std::decay<codec_type>::type> unique_ptr(codec_type &&inner_codec) {
   return unique_ptr_t<typename std::decay<codec_type>::type>(std::forward<codec_type>(inner_codec));
@@ -97,6 +140,11 @@ shared_ptr_t<typename std::decay<codec_type>::type> shared_ptr(codec_type &&inne
   return shared_ptr_t<typename std::decay<codec_type>::type>(std::forward<codec_type>(inner_codec));
 }
 
+template <typename codec_type>
+arena_shared_ptr_t<typename std::decay<codec_type>::type> arena_shared_ptr(codec_type &&inner_codec) {
+  return arena_shared_ptr_t<typename std::decay<codec_type>::type>(std::forward<codec_type>(inner_codec));
+}
+
 }  // namespace codec
 
 template <typename T>
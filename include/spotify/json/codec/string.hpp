@@ -17,11 +17,15 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
+#include <string>
+#include <type_traits>
 
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/detail/escape.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_chars.hpp>
@@ -29,36 +33,87 @@
 
 namespace spotify {
 namespace json {
+namespace detail {
+
+/**
+ * Whether a codec decodes and encodes JSON strings, which is required of the
+ * key codecs of maps. String codecs specialize this next to their definition.
+ */
+template <typename codec_type>
+struct is_string_codec : std::false_type {};
+
+/**
+ * Encode a string as JSON, with quotes, directly from its characters. This is
+ * used by all string codecs, so that no string needs to be copied into a
+ * std::string before it is encoded.
+ */
+json_never_inline inline void encode_string(
+    encode_context &context,
+    const char *string,
+    const std::size_t size) {
+  context.append('"');
+
+  // Long strings that need no escaping can be referenced rather than copied,
+  // if the context allows it. Checking that is much cheaper than copying.
+  const auto data = reinterpret_cast<const uint8_t *>(string);
+  if (json_unlikely(context.should_reference(size)) &&
+      escaped_size(context, data, data + size) == size) {
+    context.append_reference(string, size);
+    context.append('"');
+    return;
+  }
+
+  // Write the strings in 1024 byte chunks, so that we do not have to reserve
+  // a potentially very large buffer for the escaped string. It is possible
+  // that the chunking will happen in the middle of a UTF-8 multi-byte
+  // character, but that is ok since write_escaped will not escape characters
+  // with the high bit set, so the combined escaped string will contain the
+  // correct UTF-8 characters in the end.
+  auto chunk_begin = data;
+  const auto string_end = chunk_begin + size;
+
+  while (chunk_begin != string_end) {
+    const auto chunk_end = std::min(chunk_begin + 1024, string_end);
+    write_escaped(context, chunk_begin, chunk_end);
+    chunk_begin = chunk_end;
+  }
+
+  context.append('"');
+}
+
+inline std::size_t measure_string(
+    const encode_context &context,
+    const char *string,
+    const std::size_t size) {
+  const auto data = reinterpret_cast<const uint8_t *>(string);
+  return 2 + escaped_size(context, data, data + size);
+}
+
+}  // namespace detail
+
 namespace codec {
 
-class string_t final {
+/**
+ * A codec for std::basic_string<char, ...>, with any traits and allocator. The
+ * allocator of decoded strings is taken from the decode context, see
+ * detail::decode_allocator. string_t is the codec for std::string.
+ */
+template <typename string_type>
+class basic_string_t final {
  public:
-  using object_type = std::string;
+  using object_type = string_type;
 
   json_never_inline object_type decode(decode_context &context) const {
     detail::skip_1(context, '"');
     return decode_string(context);
   }
 
-  json_never_inline void encode(encode_context &context, const object_type value) const {
-    context.append('"');
-
-    // Write the strings in 1024 byte chunks, so that we do not have to reserve
-    // a potentially very large buffer for the escaped string. It is possible
-    // that the chunking will happen in the middle of a UTF-8 multi-byte
-    // character, but that is ok since write_escaped will not escape characters
-    // with the high bit set, so the combined escaped string will contain the
-    // correct UTF-8 characters in the end.
-    auto chunk_begin = reinterpret_cast<const uint8_t *>(value.data());
-    const auto string_end = chunk_begin + value.size();
-
-    while (chunk_begin != string_end) {
-      const auto chunk_end = std::min(chunk_begin + 1024, string_end);
-      detail::write_escaped(context, chunk_begin, chunk_end);
-      chunk_begin = chunk_end;
-    }
+  void encode(encode_context &context, const object_type &value) const {
+    detail::encode_string(context, value.data(), value.size());
+  }
 
-    context.append('"');
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return detail::measure_string(context, value.data(), value.size());
   }
 
  private:
@@ -67,14 +122,14 @@ class string_t final {
     detail::skip_any_simple_characters(context);
 
     switch (detail::next(context, "Unterminated string")) {
-      case '"': return std::string(begin_simple, context.position - 1);
+      case '"': return object_type(begin_simple, context.position - 1, allocator(context));
       case '\\': return decode_escaped_string(context, begin_simple);
       default: json_unreachable();
     }
   }
 
   json_never_inline static object_type decode_escaped_string(decode_context &context, const char *begin) {
-    std::string unescaped(begin, context.position - 1);
+    object_type unescaped(begin, context.position - 1, allocator(context));
     decode_escape(context, unescaped);
 
     while (json_likely(context.remaining())) {
@@ -92,7 +147,11 @@ class string_t final {
     detail::fail(context, "Unterminated string");
   }
 
-  static void decode_escape(decode_context &context, std::string &out) {
+  static typename object_type::allocator_type allocator(const decode_context &context) {
+    return detail::decode_allocator<typename object_type::allocator_type>::get(context);
+  }
+
+  static void decode_escape(decode_context &context, object_type &out) {
     const auto escape_character = detail::next(context, "Unterminated string");
     switch (escape_character) {
       case '"':  out.push_back('"');  break;
@@ -115,7 +174,7 @@ class string_t final {
     detail::fail(context, "\\u must be followed by 4 hex digits");
   }
 
-  static void decode_unicode_escape(decode_context &context, std::string &out) {
+  static void decode_unicode_escape(decode_context &context, object_type &out) {
     detail::require_bytes<4>(context, "\\u must be followed by 4 hex digits");
     const auto a = decode_hex_nibble(context, *(context.position++));
     const auto b = decode_hex_nibble(context, *(context.position++));
@@ -125,7 +184,7 @@ class string_t final {
     encode_utf8(context, out, p);
   }
 
-  static void encode_utf8(decode_context &context, std::string &out, unsigned p) {
+  static void encode_utf8(decode_context &context, object_type &out, unsigned p) {
     if (json_likely(p <= 0x7F)) {
       encode_utf8_1(out, p);
     } else if (json_likely(p <= 0x07FF)) {
@@ -135,19 +194,19 @@ class string_t final {
     }
   }
 
-  static void encode_utf8_1(std::string &out, unsigned p) {
+  static void encode_utf8_1(object_type &out, unsigned p) {
     const char c0 = (p & 0x7F);
     out.push_back(c0);
   }
 
-  static void encode_utf8_2(std::string &out, unsigned p) {
+  static void encode_utf8_2(object_type &out, unsigned p) {
     const char c0 = 0xC0 | ((p >> 6) & 0x1F);
     const char c1 = 0x80 | ((p >> 0) & 0x3F);
     const char cc[] = { c0, c1 };
     out.append(&cc[0], 2);
   }
 
-  static void encode_utf8_3(std::string &out, unsigned p) {
+  static void encode_utf8_3(object_type &out, unsigned p) {
     const char c0 = 0xE0 | ((p >> 12) & 0x0F);
     const char c1 = 0x80 | ((p >>  6) & 0x3F);
     const char c2 = 0x80 | ((p >>  0) & 0x3F);
@@ -156,16 +215,146 @@ class string_t final {
   }
 };
 
+using string_t = basic_string_t<std::string>;
+
 inline string_t string() {
   return string_t();
 }
 
+/**
+ * A codec for strings held by types other than std::string that have data()
+ * and size() methods, e.g., raw_ref, std::vector<char> and string views. The
+ * strings are encoded from data() without being copied first. Decoding
+ * constructs a T from the (begin, end) range of the unescaped string. Types
+ * that do not own their data, i.e., trivially destructible types like raw_ref,
+ * point into the input and fail to decode strings with escape sequences.
+ */
+template <typename T>
+class string_ref_t final {
+ public:
+  using object_type = T;
+
+  object_type decode(decode_context &context) const {
+    const auto begin = context.position;
+    detail::skip_1(context, '"');
+    const auto begin_simple = context.position;
+    detail::skip_any_simple_characters(context);
+
+    switch (detail::next(context, "Unterminated string")) {
+      case '"': return object_type(begin_simple, context.position - 1);
+      case '\\': return decode_escaped(context, begin);
+      default: json_unreachable();
+    }
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    detail::encode_string(context, value.data(), value.size());
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return detail::measure_string(context, value.data(), value.size());
+  }
+
+ private:
+  static object_type decode_escaped(decode_context &context, const char *begin) {
+    detail::fail_if(
+        context,
+        std::is_trivially_destructible<object_type>::value,
+        "Strings with escape sequences cannot be decoded into a view",
+        begin - context.position);
+    context.position = begin;
+    const auto unescaped = string_t().decode(context);
+    return object_type(unescaped.data(), unescaped.data() + unescaped.size());
+  }
+};
+
+template <typename T>
+inline string_ref_t<T> string_ref() {
+  return string_ref_t<T>();
+}
+
+/**
+ * A codec that encodes null terminated strings. It cannot decode, since there
+ * is nothing that could own the decoded characters. Like the smart pointer
+ * codecs, it fails to encode null pointers, which are left out of objects.
+ */
+class c_string_t final {
+ public:
+  using object_type = const char *;
+
+  object_type decode(decode_context &context) const {
+    detail::fail(context, "c_string_t codec cannot decode");
+  }
+
+  void encode(encode_context &context, const object_type value) const {
+    detail::fail_if(context, !value, "Cannot encode null string");
+    detail::encode_string(context, value, std::strlen(value));
+  }
+
+  std::size_t measure(const encode_context &context, const object_type value) const {
+    detail::fail_if(context, !value, "Cannot encode null string");
+    return detail::measure_string(context, value, std::strlen(value));
+  }
+
+  bool should_encode(const object_type value) const {
+    return (value != nullptr);
+  }
+};
+
+inline c_string_t c_string() {
+  return c_string_t();
+}
+
 }  // namespace codec
 
+namespace detail {
+
+/**
+ * The unescaped characters of a string, see read_string_chars(...).
+ */
+struct string_chars {
+  const char *data;
+  std::size_t size;
+};
+
+/**
+ * Read past a string and return its characters, without copying them if
+ * possible. Strings without escape sequences are referenced in the input.
+ * Strings with escape sequences are rare, so they are simply decoded with
+ * string_t into 'scratch', which the result then points into.
+ */
+inline string_chars read_string_chars(decode_context &context, std::string &scratch) {
+  const auto begin = context.position;
+  skip_1(context, '"');
+  skip_any_simple_characters(context);
+  if (json_likely(next(context, "Unterminated string") == '"')) {
+    return string_chars{ begin + 1, std::size_t(context.position - begin - 2) };
+  }
+
+  context.position = begin;
+  scratch = codec::string_t().decode(context);
+  return string_chars{ scratch.data(), scratch.size() };
+}
+
+template <typename string_type>
+struct is_string_codec<codec::basic_string_t<string_type>> : std::true_type {};
+
+template <typename T>
+struct is_string_codec<codec::string_ref_t<T>> : std::true_type {};
+
+}  // namespace detail
+
 template <>
-struct default_codec_t<std::string> {
-  static codec::string_t codec() {
-    return codec::string_t();
+struct default_codec_t<const char *> {
+  static codec::c_string_t codec() {
+    return codec::c_string_t();
+  }
+};
+
+template <typename traits_type, typename allocator_type>
+struct default_codec_t<std::basic_string<char, traits_type, allocator_type>> {
+  static codec::basic_string_t<std::basic_string<char, traits_type, allocator_type>> codec() {
+    return codec::basic_string_t<std::basic_string<char, traits_type, allocator_type>>();
   }
 };
 
@@ -18,6 +18,7 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -133,6 +134,10 @@ class transform_t final {
     _inner_codec.encode(context, _encode_transform(value));
   }
 
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return detail::measure(context, _inner_codec, _encode_transform(value));
+  }
+
  private:
   codec_type _inner_codec;
   encode_transform _encode_transform;
@@ -55,12 +55,23 @@ struct tuple_field final {
     }
     tuple_field<T, remaining_count - 1, codecs_type...>::encode(codecs, context, object);
   }
+
+  static std::size_t measure(
+      const std::tuple<codecs_type...> &codecs,
+      const encode_context &context,
+      const T &object) {
+    const auto &codec = std::get<element_idx>(codecs);
+    const auto &element = std::get<element_idx>(object);
+    const auto size = (detail::should_encode(codec, element) ? detail::measure(context, codec, element) + 1 : 0);
+    return size + tuple_field<T, remaining_count - 1, codecs_type...>::measure(codecs, context, object);
+  }
 };
 
 template <typename T, typename... codecs_type>
 struct tuple_field<T, 0, codecs_type...> {
   static void decode(const std::tuple<codecs_type...> &codecs, decode_context &, T &) {}
   static void encode(const std::tuple<codecs_type...> &codecs, encode_context &, const T &) {}
+  static std::size_t measure(const std::tuple<codecs_type...> &codecs, const encode_context &, const T &) { return 0; }
 };
 
 }
@@ -93,6 +104,12 @@ class tuple_t final {
     context.append_or_replace(',', ']');
   }
 
+  std::size_t measure(const encode_context &context, const object_type &object) const {
+    const auto size = detail::tuple_field<object_type, element_count, codecs_type...>::measure(
+        _codecs, context, object);
+    return 1 + size + (size == 0 ? 1 : 0);
+  }
+
  private:
   std::tuple<codecs_type ...> _codecs;
 };
@@ -43,12 +43,12 @@ typename codec_type::object_type decode(const codec_type &codec, const std::stri
 
 template <typename Value>
 Value decode(const char *data, size_t size) {
-  return decode(default_codec<Value>(), data, size);
+  return decode(cached_default_codec<Value>(), data, size);
 }
 
 template <typename Value>
 Value decode(const std::string &string) {
-  return decode(default_codec<Value>(), string);
+  return decode(cached_default_codec<Value>(), string);
 }
 
 template <typename codec_type>
@@ -75,12 +75,12 @@ bool try_decode(
 
 template <typename Value>
 bool try_decode(Value &object, const std::string &string) {
-  return try_decode(object, default_codec<Value>(), string);
+  return try_decode(object, cached_default_codec<Value>(), string);
 }
 
 template <typename Value>
 bool try_decode(Value &object, const char *data, size_t size) {
-  return try_decode(object, default_codec<Value>(), data, size);
+  return try_decode(object, cached_default_codec<Value>(), data, size);
 }
 
 template <typename codec_type>
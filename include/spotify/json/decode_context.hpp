@@ -25,6 +25,13 @@
 namespace spotify {
 namespace json {
 
+class monotonic_arena;
+class shared_buffer;
+
+namespace detail {
+struct projection_node;
+}  // namespace detail
+
 /**
  * A decode_context has the information that is kept while decoding JSON with
  * codecs. It has information about the data to read and whether the decoding
@@ -32,13 +39,13 @@ namespace json {
  */
 struct decode_context final {
   decode_context(const char *begin, const char *end)
-      : has_sse42(detail::cpuid().has_sse42()),
+      : has_sse42(detail::cpu_has_sse42()),
         position(begin),
         begin(begin),
         end(end) {}
 
   decode_context(const char *data, size_t size)
-      : has_sse42(detail::cpuid().has_sse42()),
+      : has_sse42(detail::cpu_has_sse42()),
         position(data),
         begin(data),
         end(data + size) {}
@@ -59,6 +66,24 @@ struct decode_context final {
   const char *position;
   const char *const begin;
   const char *const end;
+
+  /**
+   * The fields that object codecs should decode, or nullptr to decode all of
+   * them. See projection.hpp.
+   */
+  const detail::projection_node *projection = nullptr;
+
+  /**
+   * The arena that monotonic_allocator containers are decoded into, or nullptr
+   * to allocate them from the heap. See monotonic_allocator.hpp.
+   */
+  monotonic_arena *arena = nullptr;
+
+  /**
+   * The buffer that holds the input, if it is shared, so that decoded values
+   * can share ownership of it. See shared_slice.hpp.
+   */
+  const shared_buffer *buffer = nullptr;
 };
 
 }  // namespace json
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <system_error>
+
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/mapped_file.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * Using a specified codec, decode the JSON in an already mapped file. Values
+ * that reference the input (e.g., codec::raw_ref) point into the mapping and
+ * are valid for as long as the mapped_file is alive.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode_file(const codec_type &codec, const mapped_file &file) {
+  return decode(codec, file.data(), file.size());
+}
+
+/**
+ * Using a specified codec, decode the JSON in the file at path, which is
+ * memory mapped for the duration of the call rather than read into a string.
+ * The result must therefore not reference the input; to decode into values
+ * that do, map the file with mapped_file and use decode_file(codec, file).
+ *
+ * Throws std::system_error if the file cannot be read, and decode_exception
+ * if it cannot be decoded.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode_file(const codec_type &codec, const std::string &path) {
+  const mapped_file file(path);
+  return decode_file(codec, file);
+}
+
+template <typename Value>
+Value decode_file(const std::string &path) {
+  return decode_file(cached_default_codec<Value>(), path);
+}
+
+/**
+ * Like decode_file(codec, path), but returns false instead of throwing if the
+ * file cannot be read or decoded. If it succeeds, the result is assigned to
+ * object.
+ */
+template <typename codec_type>
+bool try_decode_file(
+    typename codec_type::object_type &object,
+    const codec_type &codec,
+    const std::string &path) {
+  try {
+    object = decode_file(codec, path);
+    return true;
+  } catch (const decode_exception &) {
+    return false;
+  } catch (const std::system_error &) {
+    return false;
+  }
+}
+
+template <typename Value>
+bool try_decode_file(Value &object, const std::string &path) {
+  return try_decode_file(object, cached_default_codec<Value>(), path);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -33,5 +33,18 @@ decltype(default_codec_t<T>::codec()) default_codec() {
   return default_codec_t<T>::codec();
 }
 
+/**
+ * The default codec for T, constructed on first use and then shared by all
+ * threads for the rest of the process. encode(...) and decode(...) use this to
+ * not construct codecs, which can be expensive for object_t, for every call.
+ * The codec is never destroyed, so it can be used from static destructors.
+ */
+template <typename T>
+const decltype(default_codec_t<T>::codec()) &cached_default_codec() {
+  using codec_type = decltype(default_codec_t<T>::codec());
+  static const codec_type *codec = new codec_type(default_codec_t<T>::codec());
+  return *codec;
+}
+
 }  // namespace json
 }  // namespace spotify
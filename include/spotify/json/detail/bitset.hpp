@@ -37,6 +37,13 @@ struct bitset {
     }
   }
 
+  json_force_inline uint8_t test(const std::size_t index) const {
+    const auto byte = (index / 8);
+    const auto bidx = (index & 7);
+    const auto bytes = (json_unlikely(_vector) ? _vector->data() : _array.data());
+    return (bytes[byte] >> bidx) & 1;
+  }
+
   json_force_inline uint8_t test_and_set(const std::size_t index) {
     const auto byte = (index / 8);
     const auto bidx = (index & 7);
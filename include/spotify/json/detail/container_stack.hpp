@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/stack.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * The kinds (object or array) of the containers that a parser or writer is
+ * inside, one bit per level. The innermost 64 levels are kept in a single
+ * word. Only nesting deeper than 1088 levels makes the stack allocate memory.
+ */
+class container_stack final {
+ public:
+  json_force_inline bool empty() const {
+    return (_depth == 0);
+  }
+
+  json_force_inline std::size_t depth() const {
+    return _depth;
+  }
+
+  json_force_inline bool is_object() const {
+    return (_top & 1);
+  }
+
+  json_force_inline void push(const bool is_object) {
+    if (json_unlikely(_depth && _depth % 64 == 0)) {
+      _words.push(_top);
+    }
+    _top = (_top << 1) | uint64_t(is_object);
+    _depth++;
+  }
+
+  json_force_inline void pop() {
+    _depth--;
+    if (json_unlikely(_depth && _depth % 64 == 0)) {
+      _top = _words.pop();
+    } else {
+      _top >>= 1;
+    }
+  }
+
+ private:
+  uint64_t _top = 0;
+  std::size_t _depth = 0;
+  stack<uint64_t, 16> _words;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
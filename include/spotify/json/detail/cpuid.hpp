@@ -78,6 +78,16 @@ class cpuid {
   std::array<uint32_t, 4> _registers;
 };
 
+/**
+ * Whether the CPU supports SSE 4.2. The result is cached, since the cpuid
+ * instruction is slow, and even traps to the hypervisor in virtual machines.
+ * This matters when many small documents are decoded with a context each.
+ */
+inline bool cpu_has_sse42() {
+  static const bool has_sse42 = cpuid().has_sse42();
+  return has_sse42;
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
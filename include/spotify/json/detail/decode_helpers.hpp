@@ -20,7 +20,9 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <spotify/json/decode_context.hpp>
@@ -163,6 +165,39 @@ json_never_inline void decode_comma_separated(decode_context &context, char intr
   context.position++;
 }
 
+/**
+ * The allocator that containers with allocators of type allocator_type are
+ * decoded with. The primary template default constructs the allocator; it is
+ * specialized for allocators that take their memory from the decode context,
+ * see monotonic_allocator.hpp.
+ */
+template <typename allocator_type>
+struct decode_allocator {
+  static allocator_type get(const decode_context &) {
+    return allocator_type();
+  }
+};
+
+template <typename container_type>
+json_force_inline auto construct_container(const decode_context &context, int)
+    -> decltype(container_type(std::declval<typename container_type::allocator_type>())) {
+  return container_type(decode_allocator<typename container_type::allocator_type>::get(context));
+}
+
+template <typename container_type>
+json_force_inline container_type construct_container(const decode_context &, long) {
+  return container_type();
+}
+
+/**
+ * Construct an empty container to decode into, with the decode allocator for
+ * its allocator type, if it has one.
+ */
+template <typename container_type>
+json_force_inline container_type construct_container(const decode_context &context) {
+  return construct_container<container_type>(context, 0);
+}
+
 /**
  * Helper for parsing JSON objects. callback is called once for each key/value
  * pair. It is given the already parsed key and is expected to parse the value
@@ -170,10 +205,12 @@ json_never_inline void decode_comma_separated(decode_context &context, char intr
  * parsing fails later on.
  */
 template <typename key_codec_type, typename callback_function>
-json_force_inline void decode_object(decode_context &context, const callback_function &callback) {
-  auto codec = key_codec_type();
+json_force_inline void decode_object(
+    decode_context &context,
+    const key_codec_type &key_codec,
+    const callback_function &callback) {
   decode_comma_separated(context, '{', '}', [&]{
-    auto key = codec.decode(context);
+    auto key = key_codec.decode(context);
     skip_any_whitespace(context);
     skip_1(context, ':');
     skip_any_whitespace(context);
@@ -181,6 +218,11 @@ json_force_inline void decode_object(decode_context &context, const callback_fun
   });
 }
 
+template <typename key_codec_type, typename callback_function>
+json_force_inline void decode_object(decode_context &context, const callback_function &callback) {
+  decode_object(context, key_codec_type(), callback);
+}
+
 json_force_inline void skip_true(decode_context &context) {
   skip_4(context, "true");
 }
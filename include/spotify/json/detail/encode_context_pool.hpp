@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Contexts with a capacity above this limit are not returned to the pool, and
+ * capacity hints are clamped to it, so that an occasional huge document does
+ * not keep a huge buffer alive for the rest of the lifetime of the thread.
+ */
+constexpr std::size_t max_pooled_encode_context_capacity = 1024 * 1024;
+
+/**
+ * The number of encode contexts kept per thread. Nested calls to encode(...),
+ * e.g., from within a custom codec, each take their own context from the pool.
+ */
+constexpr std::size_t max_pooled_encode_contexts = 4;
+
+/**
+ * A running estimate of the size of the output of a specific codec type. The
+ * estimate follows growth immediately, so that the next encoding will reserve
+ * enough memory up front, but decays slowly (1/8 of the difference for each
+ * encoding), so that a single small document does not undo the estimate.
+ */
+template <typename codec_type>
+struct encode_size_hint final {
+  static std::size_t get() {
+    const auto estimate = value().load(std::memory_order_relaxed);
+    return std::min(estimate + estimate / 8, max_pooled_encode_context_capacity);
+  }
+
+  static void update(const std::size_t size) {
+    // Concurrent updates may race and lose a sample, which is fine for a hint.
+    const auto estimate = value().load(std::memory_order_relaxed);
+    const auto next = (size >= estimate ? size : estimate - (estimate - size) / 8);
+    value().store(next, std::memory_order_relaxed);
+  }
+
+ private:
+  static std::atomic<std::size_t> &value() {
+    static std::atomic<std::size_t> estimate(0);
+    return estimate;
+  }
+};
+
+/**
+ * A thread local pool of encode contexts. Since each thread has its own pool,
+ * handing contexts out and taking them back does not need any synchronization.
+ * Contexts are always cleared before being handed out.
+ */
+class encode_context_pool final {
+ public:
+  static std::unique_ptr<encode_context> acquire(const std::size_t capacity_hint) {
+    auto &pool = local();
+    std::unique_ptr<encode_context> context;
+    if (json_likely(pool._size)) {
+      context = std::move(pool._contexts[--pool._size]);
+      context->clear();
+    } else {
+      context.reset(new encode_context());
+    }
+
+    if (json_unlikely(context->capacity() < capacity_hint)) {
+      context->reserve(capacity_hint);
+    }
+
+    return context;
+  }
+
+  static void release(std::unique_ptr<encode_context> context) {
+    auto &pool = local();
+    const auto is_full = (pool._size == max_pooled_encode_contexts);
+    const auto is_huge = (context->capacity() > max_pooled_encode_context_capacity);
+    if (json_likely(!is_full && !is_huge)) {
+      pool._contexts[pool._size++] = std::move(context);
+    }
+  }
+
+ private:
+  encode_context_pool() = default;
+
+  static encode_context_pool &local() {
+    static thread_local encode_context_pool pool;
+    return pool;
+  }
+
+  std::array<std::unique_ptr<encode_context>, max_pooled_encode_contexts> _contexts;
+  std::size_t _size = 0;
+};
+
+/**
+ * Takes an encode context from the thread local pool and returns it to the
+ * pool when destroyed, also when encoding fails with an exception.
+ */
+struct pooled_encode_context final {
+  explicit pooled_encode_context(const std::size_t capacity_hint = 0)
+      : _context(encode_context_pool::acquire(capacity_hint)) {}
+
+  pooled_encode_context(const pooled_encode_context &) = delete;
+  pooled_encode_context &operator=(const pooled_encode_context &) = delete;
+
+  ~pooled_encode_context() {
+    encode_context_pool::release(std::move(_context));
+  }
+
+  json_force_inline encode_context &operator*() const { return *_context; }
+  json_force_inline encode_context *operator->() const { return _context.get(); }
+
+ private:
+  std::unique_ptr<encode_context> _context;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
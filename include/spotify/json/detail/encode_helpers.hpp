@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_exception.hpp>
 #include <spotify/json/encode_context.hpp>
@@ -67,6 +69,47 @@ json_force_inline should_encode(const codec_type &codec, const typename codec_ty
   return codec.should_encode(value);
 }
 
+template <typename T>
+struct has_measure_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<U>().measure(
+          std::declval<const encode_context &>(),
+          std::declval<typename U::object_type>()),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * Calculate the exact number of bytes that codec.encode(...) would write for
+ * the value. Codecs without a measure method are measured by encoding the value
+ * into a temporary context.
+ */
+template <typename codec_type>
+typename std::enable_if<!has_measure_method<codec_type>::value, std::size_t>::type
+json_never_inline measure(
+    const encode_context &context,
+    const codec_type &codec,
+    const typename codec_type::object_type &value) {
+  encode_context scratch_context(0);
+  codec.encode(scratch_context, value);
+  return scratch_context.size();
+}
+
+template <typename codec_type>
+typename std::enable_if<has_measure_method<codec_type>::value, std::size_t>::type
+json_force_inline measure(
+    const encode_context &context,
+    const codec_type &codec,
+    const typename codec_type::object_type &value) {
+  return codec.measure(context, value);
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include <spotify/json/detail/macros.hpp>
@@ -44,6 +45,31 @@ json_force_inline void encode_positive_integer(encode_context &context, T value)
     encode_positive_integer_64(context, value);
 }
 
+/**
+ * The number of bytes that encode_negative_integer(...) writes for the value,
+ * including the '-' sign character.
+ */
+template <typename T>
+json_force_inline std::size_t negative_integer_size(T value) {
+  std::size_t size = 2;
+  for (; value <= -10; value /= 10) {
+    size++;
+  }
+  return size;
+}
+
+/**
+ * The number of bytes that encode_positive_integer(...) writes for the value.
+ */
+template <typename T>
+json_force_inline std::size_t positive_integer_size(T value) {
+  std::size_t size = 1;
+  for (; value >= 10; value /= 10) {
+    size++;
+  }
+  return size;
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include <spotify/json/encode_context.hpp>
@@ -25,6 +26,47 @@ namespace spotify {
 namespace json {
 namespace detail {
 
+std::size_t escaped_size_scalar(const uint8_t *begin, const uint8_t *end);
+
+#if defined(json_arch_x86)
+std::size_t escaped_size_sse42(const uint8_t *begin, const uint8_t *end);
+#endif  // defined(json_arch_x86)
+
+/**
+ * \brief Calculate the number of bytes that write_escaped would write for the
+ * given string, without writing anything. If the result is equal to the length
+ * of the string, the string does not need escaping at all.
+ */
+template <typename context_type>
+json_force_inline std::size_t escaped_size(
+    const context_type &context,
+    const uint8_t *begin,
+    const uint8_t *end) {
+#if defined(json_arch_x86)
+  if (json_likely(context.has_sse42)) {
+    return escaped_size_sse42(begin, end);
+  }
+#endif  // defined(json_arch_x86)
+  return escaped_size_scalar(begin, end);
+}
+
+/**
+ * Reserve space for writing the escaped string. When the context has room for
+ * the worst case (every character escaped as \u00xx) that is reserved without
+ * looking at the string. Otherwise the exact escaped size is reserved, so that
+ * a context with a fixed size buffer does not run out of space needlessly.
+ */
+json_force_inline uint8_t *reserve_escaped(
+    encode_context &context,
+    const uint8_t *begin,
+    const uint8_t *end) {
+  const auto worst_case_size = 6 * static_cast<std::size_t>(end - begin);  // 6 is the length of \u00xx
+  if (json_likely(context.remaining() >= worst_case_size)) {
+    return context.reserve(worst_case_size);
+  }
+  return context.reserve(escaped_size(context, begin, end));
+}
+
 void write_escaped_scalar(
     encode_context &context,
     const uint8_t *begin,
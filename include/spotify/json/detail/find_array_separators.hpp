@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Find the structure of a JSON document that is a single top-level array, by
+ * scanning chunks of about chunk_size bytes on up to 'threads' threads. On
+ * success, separators holds the position of the opening '[', of each ','
+ * between the elements of the array and of the closing ']', and the function
+ * returns true.
+ *
+ * Since the quote state at the start of a chunk is not known until the chunks
+ * before it have been scanned, each chunk is scanned twice, once as if it
+ * started outside of a string and once as if it started inside of one. The
+ * results are then stitched together in order, which picks one of the scans
+ * for each chunk and the separators that are at the top level of the array.
+ *
+ * Only the brackets, braces, commas and strings are looked at; the elements
+ * themselves are not validated. The function returns false if the input is
+ * not structured like an array (e.g., the array is never closed, or it is
+ * followed by something other than whitespace).
+ */
+bool find_array_separators(
+    const char *begin,
+    const char *end,
+    std::size_t threads,
+    std::size_t chunk_size,
+    std::vector<const char *> &separators);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+const char *find_line_end_scalar(const char *begin, const char *end);
+#if defined(json_arch_x86)
+const char *find_line_end_sse42(const char *begin, const char *end);
+#endif  // defined(json_arch_x86)
+
+/**
+ * Find the first '\n' at or after begin that is not inside a JSON string, or
+ * end if there is none. The line must start outside of a string. Valid JSON
+ * never has a raw '\n' inside strings, but respecting quotes keeps a malformed
+ * record with such a newline from being reported as two broken records. The
+ * SSE 4.2 version looks for '\n', '"' and '\' in 16 bytes at a time.
+ */
+template <typename context_type>
+json_force_inline const char *find_line_end(
+    const context_type &context,
+    const char *begin,
+    const char *end) {
+#if defined(json_arch_x86)
+  if (json_likely(context.has_sse42)) {
+    return find_line_end_sse42(begin, end);
+  }
+#endif  // defined(json_arch_x86)
+  return find_line_end_scalar(begin, end);
+}
+
+/**
+ * Split [begin, end) into chunks of about chunk_size bytes each, each of which
+ * except the last one ends just after a '\n'. Unlike find_line_end(...), the
+ * split points do not respect quotes, since the quote state at an arbitrary
+ * offset is unknown, so they are only a first guess of where records start;
+ * see split_ndjson(...) in ndjson.hpp.
+ */
+std::vector<std::pair<const char *, const char *>> split_lines(
+    const char *begin,
+    const char *end,
+    std::size_t chunk_size);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Splits a top-level JSON array or object, which is received in chunks, into
+ * its elements. For objects, an element is a key, a ':' and a value. The
+ * splitter only finds the boundaries of the elements; validating and decoding
+ * them is left to the codecs. Elements that are completely contained in a
+ * chunk are handed out in place. Only the unfinished element at the end of a
+ * chunk is copied into an internal buffer, so memory use is bounded by the
+ * size of the largest element.
+ */
+class incremental_splitter final {
+ public:
+  explicit incremental_splitter(char open);
+
+  /**
+   * Scan a chunk of input, calling element_fn(context) with a decode_context
+   * spanning each complete element. element_fn must decode the whole element;
+   * trailing input is an error. The offsets of exceptions thrown from
+   * element_fn are translated to be relative to the start of the document.
+   */
+  template <typename element_fn_type>
+  void feed(const char *data, const std::size_t size, const element_fn_type &element_fn) {
+    const auto end = data + size;
+    auto position = data;
+    auto element_begin = data;  // elements that continue from earlier chunks start in the buffer
+    _chunk = data;
+
+    while (true) {
+      switch (scan(position, end)) {
+        case event::element_begin:
+          element_begin = position;
+          _element_offset = _chunk_offset + (position - data);
+          break;
+        case event::element_end:
+          if (json_likely(_buffer.empty())) {
+            decode_element(element_begin, position, element_fn);
+          } else {
+            _buffer.append(element_begin, position);
+            decode_element(_buffer.data(), _buffer.data() + _buffer.size(), element_fn);
+            _buffer.clear();
+          }
+          break;
+        case event::need_more_input:
+          if (is_in_element()) {
+            _buffer.append(element_begin, end);
+          }
+          _chunk_offset += size;
+          return;
+      }
+    }
+  }
+
+  /**
+   * Signal that there is no more input. Fails if the array or object has not
+   * been closed.
+   */
+  void finish() const;
+
+  /**
+   * Prepare for decoding a new document. The buffer keeps its capacity.
+   */
+  void reset();
+
+  bool is_done() const {
+    return (_state == state::done);
+  }
+
+  /**
+   * The number of bytes of an unfinished element that are held between chunks.
+   */
+  std::size_t buffered() const {
+    return _buffer.size();
+  }
+
+ private:
+  enum class event : uint8_t {
+    element_begin,
+    element_end,
+    need_more_input
+  };
+
+  enum class state : uint8_t {
+    before_open,
+    after_open,
+    before_element,
+    key_begin,
+    key,
+    after_key,
+    value_begin,
+    string_value,
+    nested_value,
+    nested_string,
+    scalar_value,
+    after_element,
+    done
+  };
+
+  event scan(const char *&position, const char *end);
+  const char *scan_string(const char *position, const char *end, bool &is_closed);
+  json_noreturn void fail(const char *position, const char *error) const;
+
+  bool is_in_element() const {
+    return (_state >= state::key_begin && _state <= state::scalar_value);
+  }
+
+  template <typename element_fn_type>
+  void decode_element(const char *begin, const char *end, const element_fn_type &element_fn) {
+    decode_context context(begin, end);
+    try {
+      element_fn(context);
+      skip_any_whitespace(context);
+      fail_if(context, context.position != context.end, "Unexpected trailing input");
+    } catch (const decode_exception &exception) {
+      throw decode_exception(exception.what(), _element_offset + exception.offset());
+    }
+  }
+
+  const char _open;
+  const char _close;
+  state _state = state::before_open;
+  bool _is_escaped = false;
+  std::size_t _depth = 0;
+  std::size_t _chunk_offset = 0;
+  std::size_t _element_offset = 0;
+  const char *_chunk = nullptr;
+  std::string _buffer;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * The number of threads to use when a parallel_options asks for the default
+ * (zero) number of threads: the number of hardware threads, or one if that is
+ * not known.
+ */
+std::size_t default_thread_count();
+
+/**
+ * The largest number of threads, including the calling thread, that
+ * parallel_for(...) runs tasks on at the same time: the number of hardware
+ * threads, but at least 8, so that an explicit thread count can still overlap
+ * tasks on machines with few hardware threads.
+ */
+std::size_t max_thread_count();
+
+/**
+ * Call task(index) for each index in [0, num_tasks), using up to 'threads'
+ * threads including the calling thread (zero means default_thread_count()).
+ * The other threads are workers of a process wide pool, which are started when
+ * they are first needed and then reused by all later calls. The pool has at
+ * most max_thread_count() - 1 workers, so asking for more threads than that
+ * splits the work more finely but does not start more threads. Each
+ * thread starts out with an even share of the indexes; a thread that runs out
+ * of work steals half of the remaining indexes of another thread, so that
+ * tasks of uneven cost still keep all threads busy. Tasks may call
+ * parallel_for(...) as well.
+ *
+ * Returns when all tasks have finished. If a task throws, the remaining tasks
+ * are abandoned and the first exception is rethrown on the calling thread.
+ */
+void parallel_for(
+    std::size_t threads,
+    std::size_t num_tasks,
+    const std::function<void (std::size_t)> &task);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
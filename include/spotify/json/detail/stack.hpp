@@ -54,7 +54,7 @@ struct stack {
  private:
   std::array<T, inline_capacity> _array;
   std::unique_ptr<std::vector<T>> _vector;
-  std::size_t _inline_size;
+  std::size_t _inline_size = 0;
 };
 
 }  // namespace detail
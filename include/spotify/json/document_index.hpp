@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/extract.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * An indexed value. Offsets are relative to the start of the document. The
+ * children of a container are stored next to each other, and the members of
+ * an object are sorted by key, so that they can be binary searched. Keys that
+ * contain escape sequences are unescaped into a separate buffer, which is
+ * marked by the escaped_key bit of key_size.
+ */
+struct index_node {
+  static constexpr uint32_t not_indexed = UINT32_MAX;
+  static constexpr uint32_t escaped_key = 1u << 31;
+
+  uint32_t begin;
+  uint32_t end;
+  uint32_t key_begin;
+  uint32_t key_size;
+  uint32_t first_child;  // not_indexed for containers below the indexed depth
+  uint32_t num_children;
+};
+
+}  // namespace detail
+
+/**
+ * A compact index of the positions of the object members and array elements of
+ * a document, up to a configurable depth, for repeated random access into a
+ * document that is kept in its raw form. Each indexed value takes 24 bytes, no
+ * matter how large it is, which is far less than a DOM. Array elements are
+ * found in O(1) and object members in O(log n) per pointer token; values below
+ * the indexed depth are found by scanning their indexed parent.
+ *
+ * Building the index validates the whole document. The index refers to, but
+ * does not own, the document, which must outlive it and must be smaller than
+ * 4 GB. The index is immutable once built, so it can be used from several
+ * threads at once.
+ */
+class document_index final {
+ public:
+  static constexpr std::size_t default_max_depth = 3;
+
+  document_index(const char *data, std::size_t size, std::size_t max_depth = default_max_depth);
+
+  /**
+   * Find the raw value that a JSON pointer refers to. Returns false if there is
+   * no such value.
+   */
+  bool find(const json_pointer &pointer, codec::raw_ref &value) const;
+
+  /**
+   * Decode the value that a JSON pointer refers to. Offsets in exceptions are
+   * relative to the start of the document. Throws decode_exception if there is
+   * no value at the pointer.
+   */
+  template <typename codec_type>
+  typename codec_type::object_type decode(const json_pointer &pointer, const codec_type &codec) const {
+    codec::raw_ref value;
+    if (json_unlikely(!find(pointer, value))) {
+      throw decode_exception("No value at JSON pointer '" + pointer.str() + "'", 0);
+    }
+
+    decode_context context(_data, _data + _size);
+    context.position = value.data();
+    return codec.decode(context);
+  }
+
+  template <typename Value>
+  Value decode(const json_pointer &pointer) const {
+    return decode(pointer, cached_default_codec<Value>());
+  }
+
+  template <typename codec_type>
+  bool try_decode(
+      typename codec_type::object_type &object,
+      const json_pointer &pointer,
+      const codec_type &codec) const {
+    try {
+      object = decode(pointer, codec);
+      return true;
+    } catch (const decode_exception &) {
+      return false;
+    }
+  }
+
+  template <typename Value>
+  bool try_decode(Value &object, const json_pointer &pointer) const {
+    return try_decode(object, pointer, cached_default_codec<Value>());
+  }
+
+  /**
+   * The number of indexed values, including the document itself.
+   */
+  std::size_t size() const { return _nodes.size(); }
+
+  /**
+   * The approximate number of bytes of memory used by the index.
+   */
+  std::size_t memory_usage() const {
+    return _nodes.capacity() * sizeof(detail::index_node) + _escaped_keys.capacity();
+  }
+
+ private:
+  class builder;
+
+  bool find_member(const detail::index_node &node, const std::string &token, uint32_t &child) const;
+  bool find_element(const detail::index_node &node, const std::string &token, uint32_t &child) const;
+
+  const char *_data;
+  std::size_t _size;
+  std::vector<detail::index_node> _nodes;
+  std::string _escaped_keys;
+};
+
+}  // namespace json
+}  // namespace spotify
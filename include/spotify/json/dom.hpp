@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spotify/json/arena.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/escape.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/sax.hpp>
+
+namespace spotify {
+namespace json {
+
+enum class dom_type : uint8_t {
+  null,
+  boolean,
+  integer,  // numbers without fraction or exponent that fit in an int64_t
+  number,   // all other numbers, as double
+  string,
+  array,
+  object
+};
+
+struct dom_member;
+
+/**
+ * A dynamically typed JSON value, for data without a fixed schema. A value is
+ * 16 bytes: an 8 byte payload, a 32 bit length and a type tag. Strings point
+ * into an arena (or into the input, see codec::dom_t), arrays are contiguous
+ * arrays of values, and objects are contiguous arrays of members, in the order
+ * of the input. Values do not own any memory, so they are trivially copyable
+ * and must not outlive the arena that they were decoded into.
+ *
+ * The typed accessors throw std::invalid_argument if the value has a different
+ * type, with the exception that as_double() also accepts integers.
+ */
+class dom_value final {
+ public:
+  dom_value() : _integer(0), _size(0), _type(dom_type::null) {}
+
+  static dom_value boolean(const bool value) {
+    dom_value v(dom_type::boolean, 0);
+    v._boolean = value;
+    return v;
+  }
+
+  static dom_value integer(const int64_t value) {
+    dom_value v(dom_type::integer, 0);
+    v._integer = value;
+    return v;
+  }
+
+  static dom_value number(const double value) {
+    dom_value v(dom_type::number, 0);
+    v._number = value;
+    return v;
+  }
+
+  static dom_value string(const char *data, const uint32_t size) {
+    dom_value v(dom_type::string, size);
+    v._string = data;
+    return v;
+  }
+
+  static dom_value array(const dom_value *elements, const uint32_t size) {
+    dom_value v(dom_type::array, size);
+    v._elements = elements;
+    return v;
+  }
+
+  static dom_value object(const dom_member *members, const uint32_t size) {
+    dom_value v(dom_type::object, size);
+    v._members = members;
+    return v;
+  }
+
+  dom_type type() const { return _type; }
+  bool is_null() const { return _type == dom_type::null; }
+  bool is_bool() const { return _type == dom_type::boolean; }
+  bool is_integer() const { return _type == dom_type::integer; }
+  bool is_number() const { return _type == dom_type::integer || _type == dom_type::number; }
+  bool is_string() const { return _type == dom_type::string; }
+  bool is_array() const { return _type == dom_type::array; }
+  bool is_object() const { return _type == dom_type::object; }
+
+  bool as_bool() const {
+    require(dom_type::boolean);
+    return _boolean;
+  }
+
+  int64_t as_int64() const {
+    require(dom_type::integer);
+    return _integer;
+  }
+
+  double as_double() const {
+    if (_type == dom_type::integer) {
+      return static_cast<double>(_integer);
+    }
+    require(dom_type::number);
+    return _number;
+  }
+
+  /**
+   * The unescaped string, which is not null terminated.
+   */
+  const char *string_data() const {
+    require(dom_type::string);
+    return _string;
+  }
+
+  std::string str() const {
+    return std::string(string_data(), _size);
+  }
+
+  /**
+   * The number of bytes of a string, elements of an array or members of an
+   * object. Zero for all other types.
+   */
+  std::size_t size() const {
+    return _size;
+  }
+
+  const dom_value *begin() const {
+    require(dom_type::array);
+    return _elements;
+  }
+
+  const dom_value *end() const {
+    return begin() + _size;
+  }
+
+  const dom_value &operator[](const std::size_t index) const {
+    require(dom_type::array);
+    if (index >= _size) {
+      throw std::out_of_range("Array index out of range");
+    }
+    return _elements[index];
+  }
+
+  const dom_member *members_begin() const {
+    require(dom_type::object);
+    return _members;
+  }
+
+  const dom_member *members_end() const;
+
+  /**
+   * Find the first member of an object with the given key, with a linear
+   * search. Returns nullptr if there is no such member.
+   */
+  const dom_value *find(const char *key, std::size_t key_size) const;
+
+  const dom_value *find(const std::string &key) const {
+    return find(key.data(), key.size());
+  }
+
+ private:
+  dom_value(const dom_type type, const uint32_t size)
+      : _integer(0), _size(size), _type(type) {}
+
+  void require(const dom_type type) const {
+    if (json_unlikely(_type != type)) {
+      throw std::invalid_argument("Unexpected type of JSON value");
+    }
+  }
+
+  union {
+    bool _boolean;
+    int64_t _integer;
+    double _number;
+    const char *_string;
+    const dom_value *_elements;
+    const dom_member *_members;
+  };
+
+  uint32_t _size;
+  dom_type _type;
+};
+
+struct dom_member final {
+  dom_value key;
+  dom_value value;
+};
+
+inline const dom_member *dom_value::members_end() const {
+  return members_begin() + _size;
+}
+
+inline const dom_value *dom_value::find(const char *key, const std::size_t key_size) const {
+  for (auto member = members_begin(); member != members_end(); ++member) {
+    if (member->key.size() == key_size && std::memcmp(member->key.string_data(), key, key_size) == 0) {
+      return &member->value;
+    }
+  }
+  return nullptr;
+}
+
+namespace detail {
+
+/**
+ * Builds a DOM from the events of sax_parse(...). The values of all open
+ * containers are collected on a single scratch stack (for objects, as pairs of
+ * key and value), and copied into the arena as one contiguous array when the
+ * container ends, so every node is written to the arena exactly once.
+ */
+class dom_builder final : public sax_handler {
+ public:
+  dom_builder(monotonic_arena &arena, const bool borrow_strings)
+      : _arena(arena),
+        _borrow_strings(borrow_strings),
+        _scratch(local_scratch()) {
+    _scratch.values.clear();
+    _scratch.starts.clear();
+  }
+
+  dom_value root() const {
+    return _scratch.values.front();
+  }
+
+  void start_object() { _scratch.starts.push_back(_scratch.values.size()); }
+  void start_array() { _scratch.starts.push_back(_scratch.values.size()); }
+
+  void end_object() {
+    const auto start = pop_start();
+    const auto size = (_scratch.values.size() - start) / 2;
+    const auto members = _arena.allocate_array<dom_member>(size);
+    for (std::size_t i = 0; i < size; i++) {
+      new (&members[i]) dom_member{ _scratch.values[start + 2 * i], _scratch.values[start + 2 * i + 1] };
+    }
+    _scratch.values.resize(start);
+    _scratch.values.push_back(dom_value::object(members, checked_size(size)));
+  }
+
+  void end_array() {
+    const auto start = pop_start();
+    const auto size = _scratch.values.size() - start;
+    const auto elements = _arena.allocate_array<dom_value>(size);
+    std::uninitialized_copy(_scratch.values.begin() + start, _scratch.values.end(), elements);
+    _scratch.values.resize(start);
+    _scratch.values.push_back(dom_value::array(elements, checked_size(size)));
+  }
+
+  void key(const sax_string &key) { string(key); }
+
+  void string(const sax_string &value) {
+    if (json_unlikely(value.has_escapes)) {
+      const auto unescaped = value.str();
+      push_string(copy(unescaped.data(), unescaped.size()), unescaped.size());
+    } else if (_borrow_strings) {
+      push_string(value.data, value.size);
+    } else {
+      push_string(copy(value.data, value.size), value.size);
+    }
+  }
+
+  void number(const sax_number &value) {
+    if (is_integer(value)) {
+      if (json_likely(value.size <= 18)) {
+        _scratch.values.push_back(dom_value::integer(parse_short_integer(value)));
+        return;
+      }
+
+      try {
+        _scratch.values.push_back(dom_value::integer(value.as<int64_t>()));
+        return;
+      } catch (const decode_exception &) {
+        // Outside of the range of int64_t; fall back to a double.
+      }
+    }
+    _scratch.values.push_back(dom_value::number(value.as<double>()));
+  }
+
+  void boolean(const bool value) { _scratch.values.push_back(dom_value::boolean(value)); }
+  void null() { _scratch.values.push_back(dom_value()); }
+
+ private:
+  struct scratch {
+    std::vector<dom_value> values;
+    std::vector<std::size_t> starts;
+  };
+
+  static scratch &local_scratch() {
+    static thread_local scratch local;
+    return local;
+  }
+
+  static bool is_integer(const sax_number &value) {
+    for (std::size_t i = 0; i < value.size; i++) {
+      const auto c = value.data[i];
+      if (c == '.' || c == 'e' || c == 'E') {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static int64_t parse_short_integer(const sax_number &value) {
+    const auto negative = (value.data[0] == '-');
+    int64_t result = 0;
+    for (std::size_t i = negative; i < value.size; i++) {
+      result = result * 10 + (value.data[i] - '0');
+    }
+    return (negative ? -result : result);
+  }
+
+  static uint32_t checked_size(const std::size_t size) {
+    if (json_unlikely(size > std::numeric_limits<uint32_t>::max())) {
+      throw std::length_error("JSON value is too large for a dom_value");
+    }
+    return static_cast<uint32_t>(size);
+  }
+
+  std::size_t pop_start() {
+    const auto start = _scratch.starts.back();
+    _scratch.starts.pop_back();
+    return start;
+  }
+
+  const char *copy(const char *data, const std::size_t size) {
+    const auto copied = _arena.allocate_array<char>(size);
+    std::memcpy(copied, data, size);
+    return copied;
+  }
+
+  void push_string(const char *data, const std::size_t size) {
+    _scratch.values.push_back(dom_value::string(data, checked_size(size)));
+  }
+
+  monotonic_arena &_arena;
+  const bool _borrow_strings;
+  scratch &_scratch;
+};
+
+}  // namespace detail
+
+namespace codec {
+
+/**
+ * A codec for dom_value. Decoding builds the tree in a single pass into the
+ * arena, which must outlive the decoded values. If 'borrow_strings' is true,
+ * strings without escape sequences point into the input instead of being
+ * copied into the arena, in which case the input must outlive the values too.
+ *
+ * A dom_t that is constructed without an arena can only encode.
+ */
+class dom_t final {
+ public:
+  using object_type = dom_value;
+
+  dom_t() = default;
+
+  explicit dom_t(monotonic_arena &arena, const bool borrow_strings = false)
+      : _arena(&arena),
+        _borrow_strings(borrow_strings) {}
+
+  object_type decode(decode_context &context) const {
+    detail::fail_if(context, !_arena, "dom_t needs an arena to decode");
+    detail::dom_builder builder(*_arena, _borrow_strings);
+    sax_parse(context, builder);
+    return builder.root();
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    switch (value.type()) {
+      case dom_type::null: context.append("null", 4); break;
+      case dom_type::boolean: encode_boolean(context, value.as_bool()); break;
+      case dom_type::integer: codec::number<int64_t>().encode(context, value.as_int64()); break;
+      case dom_type::number: codec::number<double>().encode(context, value.as_double()); break;
+      case dom_type::string: encode_string(context, value); break;
+      case dom_type::array: encode_array(context, value); break;
+      case dom_type::object: encode_object(context, value); break;
+    }
+  }
+
+ private:
+  static void encode_boolean(encode_context &context, const bool value) {
+    if (value) {
+      context.append("true", 4);
+    } else {
+      context.append("false", 5);
+    }
+  }
+
+  static void encode_string(encode_context &context, const dom_value &value) {
+    const auto data = reinterpret_cast<const uint8_t *>(value.string_data());
+    context.append('"');
+    detail::write_escaped(context, data, data + value.size());
+    context.append('"');
+  }
+
+  void encode_array(encode_context &context, const dom_value &value) const {
+    context.append('[');
+    for (const auto &element : value) {
+      encode(context, element);
+      context.append(',');
+    }
+    context.append_or_replace(',', ']');
+  }
+
+  void encode_object(encode_context &context, const dom_value &value) const {
+    context.append('{');
+    for (auto member = value.members_begin(); member != value.members_end(); ++member) {
+      encode_string(context, member->key);
+      context.append(':');
+      encode(context, member->value);
+      context.append(',');
+    }
+    context.append_or_replace(',', '}');
+  }
+
+  monotonic_arena *_arena = nullptr;
+  bool _borrow_strings = false;
+};
+
+inline dom_t dom(monotonic_arena &arena, const bool borrow_strings = false) {
+  return dom_t(arena, borrow_strings);
+}
+
+}  // namespace codec
+
+template <>
+struct default_codec_t<dom_value> {
+  static codec::dom_t codec() {
+    return codec::dom_t();
+  }
+};
+
+/**
+ * A decoded document that owns its arena, so that the whole tree is freed at
+ * once when the document is destroyed. Moving a document does not move the
+ * nodes, so values taken from it stay valid.
+ */
+class dom_document final {
+ public:
+  explicit dom_document(std::size_t block_size = 4096)
+      : _arena(block_size) {}
+
+  const dom_value &root() const { return _root; }
+  monotonic_arena &arena() { return _arena; }
+
+ private:
+  friend dom_document decode_dom(const char *data, std::size_t size);
+
+  monotonic_arena _arena;
+  dom_value _root;
+};
+
+inline dom_document decode_dom(const char *data, const std::size_t size) {
+  dom_document document(std::max<std::size_t>(size, 64));
+  decode_context context(data, size);
+  detail::skip_any_whitespace(context);
+  document._root = codec::dom(document._arena).decode(context);
+  detail::skip_any_whitespace(context);
+  detail::fail_if(context, context.position != context.end, "Unexpected trailing input");
+  return document;
+}
+
+inline dom_document decode_dom(const std::string &string) {
+  return decode_dom(string.data(), string.size());
+}
+
+}  // namespace json
+}  // namespace spotify
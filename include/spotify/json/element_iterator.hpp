@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+template <typename callback_type, typename value_type>
+json_force_inline bool call_element_callback(std::true_type /* returns_void */, callback_type &callback, value_type &&value) {
+  callback(std::forward<value_type>(value));
+  return true;
+}
+
+template <typename callback_type, typename value_type>
+json_force_inline bool call_element_callback(std::false_type /* returns_void */, callback_type &callback, value_type &&value) {
+  return bool(callback(std::forward<value_type>(value)));
+}
+
+/**
+ * Call callback(value), and return whether to continue with the next element:
+ * always if the callback returns void, otherwise if it returns true.
+ */
+template <typename callback_type, typename value_type>
+json_force_inline bool call_element_callback(callback_type &callback, value_type &&value) {
+  using returns_void = std::is_void<decltype(callback(std::forward<value_type>(value)))>;
+  return call_element_callback(returns_void(), callback, std::forward<value_type>(value));
+}
+
+/**
+ * After an element, skip past the ',' before the next element and return true,
+ * or skip past the closing ']' and return false.
+ */
+json_force_inline bool skip_to_next_element(decode_context &context) {
+  skip_any_whitespace(context);
+  if (peek(context) == ']') {
+    context.position++;
+    return false;
+  }
+
+  skip_1(context, ',');
+  skip_any_whitespace(context);
+  return true;
+}
+
+/**
+ * Skip past the '[' of an array and return true if it has any elements, or
+ * skip past the whole (empty) array and return false.
+ */
+json_force_inline bool skip_to_first_element(decode_context &context) {
+  skip_1(context, '[');
+  skip_any_whitespace(context);
+  if (peek(context) == ']') {
+    context.position++;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace detail
+
+/**
+ * Decode the elements of the JSON array at the position of the context one at
+ * a time, calling callback(object_type &&) with each of them, without building
+ * a container. The callback may return a bool, in which case returning false
+ * stops the iteration; the rest of the array is then not read at all.
+ *
+ * Returns true if the whole array was read, in which case the context is
+ * positioned just after it, or false if the callback stopped the iteration, in
+ * which case the context is positioned just after the last decoded element.
+ */
+template <typename codec_type, typename callback_type>
+bool for_each_element(const codec_type &codec, decode_context &context, callback_type &&callback) {
+  if (!detail::skip_to_first_element(context)) {
+    return true;
+  }
+
+  do {
+    if (!detail::call_element_callback(callback, codec.decode(context))) {
+      return false;
+    }
+  } while (detail::skip_to_next_element(context));
+  return true;
+}
+
+/**
+ * Like for_each_element(codec, context, callback), for a document that is a
+ * top-level array. When the whole array has been read, trailing input is an
+ * error, like for decode(...); when the iteration is stopped, the rest of the
+ * document is not looked at.
+ */
+template <typename codec_type, typename callback_type>
+bool for_each_element(const codec_type &codec, const char *data, const size_t size, callback_type &&callback) {
+  decode_context context(data, data + size);
+  detail::skip_any_whitespace(context);
+  if (!for_each_element(codec, context, callback)) {
+    return false;
+  }
+
+  detail::skip_any_whitespace(context);
+  detail::fail_if(context, context.position != context.end, "Unexpected trailing input");
+  return true;
+}
+
+/**
+ * An input iterator that decodes the elements of a JSON array one at a time;
+ * see elements(...). Advancing the iterator decodes the next element, and
+ * throws a decode_exception if that fails. Only the current element is kept.
+ */
+template <typename codec_type>
+class element_iterator final {
+ public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = typename codec_type::object_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type *;
+  using reference = value_type &;
+
+  /**
+   * The end iterator.
+   */
+  element_iterator()
+      : _codec(nullptr),
+        _begin(nullptr),
+        _position(nullptr),
+        _end(nullptr),
+        _is_top_level(false) {}
+
+  /**
+   * An iterator at the first element of the array that starts at 'position'.
+   * Offsets in decode exceptions are relative to 'begin'.
+   */
+  element_iterator(
+      const codec_type &codec,
+      const char *begin,
+      const char *position,
+      const char *end,
+      const bool is_top_level)
+      : _codec(&codec),
+        _begin(begin),
+        _position(position),
+        _end(end),
+        _is_top_level(is_top_level) {
+    auto context = make_context();
+    if (detail::skip_to_first_element(context)) {
+      decode(context);
+    } else {
+      finish(context);
+    }
+  }
+
+  reference operator*() { return _value; }
+  pointer operator->() { return &_value; }
+
+  element_iterator &operator++() {
+    auto context = make_context();
+    if (detail::skip_to_next_element(context)) {
+      decode(context);
+    } else {
+      finish(context);
+    }
+    return *this;
+  }
+
+  void operator++(int) {
+    ++*this;
+  }
+
+  bool operator==(const element_iterator &other) const {
+    return (_codec == nullptr) == (other._codec == nullptr) && _position == other._position;
+  }
+
+  bool operator!=(const element_iterator &other) const {
+    return !(*this == other);
+  }
+
+ private:
+  decode_context make_context() const {
+    decode_context context(_begin, _end);
+    context.position = _position;
+    return context;
+  }
+
+  void decode(decode_context &context) {
+    _value = _codec->decode(context);
+    _position = context.position;
+  }
+
+  void finish(decode_context &context) {
+    if (_is_top_level) {
+      detail::skip_any_whitespace(context);
+      detail::fail_if(context, context.position != context.end, "Unexpected trailing input");
+    }
+
+    *this = element_iterator();
+  }
+
+  const codec_type *_codec;
+  const char *_begin;
+  const char *_position;
+  const char *_end;
+  bool _is_top_level;
+  value_type _value;
+};
+
+/**
+ * A single pass range over the elements of a JSON array; see elements(...). The
+ * range keeps a copy of the codec, which its iterators refer to, so the range
+ * must outlive its iterators.
+ */
+template <typename codec_type>
+class element_range final {
+ public:
+  element_range(
+      codec_type codec,
+      const char *begin,
+      const char *position,
+      const char *end,
+      const bool is_top_level)
+      : _codec(std::move(codec)),
+        _begin(begin),
+        _position(position),
+        _end(end),
+        _is_top_level(is_top_level) {}
+
+  element_iterator<codec_type> begin() const {
+    return element_iterator<codec_type>(_codec, _begin, _position, _end, _is_top_level);
+  }
+
+  element_iterator<codec_type> end() const {
+    return element_iterator<codec_type>();
+  }
+
+ private:
+  codec_type _codec;
+  const char *_begin;
+  const char *_position;
+  const char *_end;
+  bool _is_top_level;
+};
+
+/**
+ * Iterate over the elements of a document that is a top-level array, decoding
+ * them one at a time with the codec:
+ *
+ *   for (const auto &track : elements(default_codec<track_t>(), data, size)) {
+ *     ...
+ *   }
+ *
+ * Breaking out of the loop stops the decoding; the rest of the document is
+ * then not read. Iterating through to the end checks for trailing input.
+ */
+template <typename codec_type>
+element_range<codec_type> elements(const codec_type &codec, const char *data, const size_t size) {
+  decode_context context(data, data + size);
+  detail::skip_any_whitespace(context);
+  return element_range<codec_type>(codec, data, context.position, data + size, true);
+}
+
+/**
+ * Iterate over the elements of the JSON array at the position of the context,
+ * for example an array nested in a document that was reached through a raw_ref.
+ */
+template <typename codec_type>
+element_range<codec_type> elements(const codec_type &codec, const decode_context &context) {
+  return element_range<codec_type>(codec, context.begin, context.position, context.end, false);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -16,10 +16,14 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/encode_context_pool.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_allocator.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -27,14 +31,69 @@ namespace json {
 
 template <typename codec_type>
 json_never_inline std::string encode(const codec_type &codec, const typename codec_type::object_type &object) {
-  encode_context context;
-  codec.encode(context, object);
-  return std::string(static_cast<const char *>(context.data()), context.size());
+  using size_hint = detail::encode_size_hint<codec_type>;
+  detail::pooled_encode_context context(size_hint::get());
+  codec.encode(*context, object);
+  size_hint::update(context->size());
+  return std::string(static_cast<const char *>(context->data()), context->size());
 }
 
 template <typename value_type>
 json_never_inline std::string encode(const value_type &value) {
-  return encode(default_codec<value_type>(), value);
+  return encode(cached_default_codec<value_type>(), value);
+}
+
+/**
+ * The exact number of bytes that encode(codec, object) produces, computed
+ * without writing the encoded data anywhere.
+ */
+template <typename codec_type>
+json_never_inline std::size_t measure(const codec_type &codec, const typename codec_type::object_type &object) {
+  const encode_context context(0);
+  return detail::measure(context, codec, object);
+}
+
+template <typename value_type>
+json_never_inline std::size_t measure(const value_type &value) {
+  return measure(cached_default_codec<value_type>(), value);
+}
+
+/**
+ * Encode into a caller owned buffer of 'size' bytes, which is never grown or
+ * reallocated, and return the number of bytes written. If the buffer is too
+ * small, std::bad_alloc is thrown; use measure(...) to find the exact size.
+ */
+template <typename codec_type>
+json_never_inline std::size_t encode(
+    const codec_type &codec,
+    const typename codec_type::object_type &object,
+    void *buffer,
+    const std::size_t size) {
+  fixed_encode_allocator allocator(buffer, size);
+  encode_context context(allocator, size);
+  codec.encode(context, object);
+  return context.size();
+}
+
+template <typename value_type>
+json_never_inline std::size_t encode(const value_type &value, void *buffer, const std::size_t size) {
+  return encode(cached_default_codec<value_type>(), value, buffer, size);
+}
+
+/**
+ * Encode into a string of exactly the right size, by first measuring the size
+ * and then writing straight into the string, without an intermediate buffer.
+ */
+template <typename codec_type>
+json_never_inline std::string encode_exact(const codec_type &codec, const typename codec_type::object_type &object) {
+  std::string output(measure(codec, object), '\0');
+  encode(codec, object, &output[0], output.size());
+  return output;
+}
+
+template <typename value_type>
+json_never_inline std::string encode_exact(const value_type &value) {
+  return encode_exact(cached_default_codec<value_type>(), value);
 }
 
 }  // namespace json
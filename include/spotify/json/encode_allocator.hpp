@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+namespace spotify {
+namespace json {
+
+/**
+ * The allocator policy that an encode_context uses for its buffer. Only the
+ * slow paths of an encode_context (construction, growing and destruction) call
+ * into the allocator, so the virtual calls do not affect the encoding itself.
+ *
+ * All functions signal failure by returning nullptr, in which case the
+ * encode_context throws std::bad_alloc.
+ */
+class encode_allocator {
+ public:
+  virtual ~encode_allocator() = default;
+
+  /**
+   * Allocate a buffer of (at least) 'capacity' bytes.
+   */
+  virtual void *allocate(std::size_t capacity) = 0;
+
+  /**
+   * Grow a buffer of 'old_capacity' bytes, of which the first 'size' bytes are
+   * in use, to 'new_capacity' bytes. 'ptr' may be nullptr if 'old_capacity' is
+   * zero. The default implementation allocates a new buffer, copies the used
+   * bytes and then deallocates the old buffer, which is suitable for arena
+   * allocators that do not support growing allocations in place.
+   */
+  virtual void *reallocate(
+      void *ptr,
+      std::size_t size,
+      std::size_t old_capacity,
+      std::size_t new_capacity) {
+    const auto new_ptr = allocate(new_capacity);
+    if (new_ptr) {
+      std::memcpy(new_ptr, ptr, size);
+      deallocate(ptr, old_capacity);
+    }
+    return new_ptr;
+  }
+
+  /**
+   * Release a buffer of 'capacity' bytes. 'ptr' may be nullptr.
+   */
+  virtual void deallocate(void *ptr, std::size_t capacity) = 0;
+};
+
+/**
+ * The default allocator, which uses std::malloc, std::realloc and std::free.
+ */
+class malloc_encode_allocator final : public encode_allocator {
+ public:
+  void *allocate(std::size_t capacity) override {
+    return std::malloc(capacity);
+  }
+
+  void *reallocate(
+      void *ptr,
+      std::size_t size,
+      std::size_t old_capacity,
+      std::size_t new_capacity) override {
+    return std::realloc(ptr, new_capacity);
+  }
+
+  void deallocate(void *ptr, std::size_t capacity) override {
+    std::free(ptr);
+  }
+
+  static malloc_encode_allocator &instance() {
+    static malloc_encode_allocator allocator;
+    return allocator;
+  }
+};
+
+/**
+ * Adapts an arena (or any other monotonic allocator) for use with an
+ * encode_context. The arena must have a 'void *allocate(std::size_t size)'
+ * method and must outlive all encode contexts that use it. Buffers are never
+ * given back to the arena; when an encode_context grows, a new buffer is taken
+ * from the arena and the contents are copied over.
+ */
+template <typename arena_type>
+class arena_encode_allocator final : public encode_allocator {
+ public:
+  explicit arena_encode_allocator(arena_type &arena)
+      : _arena(arena) {}
+
+  void *allocate(std::size_t capacity) override {
+    return _arena.allocate(capacity);
+  }
+
+  void deallocate(void *ptr, std::size_t capacity) override {
+    // The memory is released together with the arena.
+  }
+
+ private:
+  arena_type &_arena;
+};
+
+template <typename arena_type>
+arena_encode_allocator<arena_type> arena_allocator(arena_type &arena) {
+  return arena_encode_allocator<arena_type>(arena);
+}
+
+/**
+ * Lets an encode_context write into a fixed, caller owned buffer. The context
+ * must be created with a capacity no larger than the buffer, and it fails with
+ * std::bad_alloc instead of growing past the end of the buffer.
+ */
+class fixed_encode_allocator final : public encode_allocator {
+ public:
+  fixed_encode_allocator(void *buffer, std::size_t size)
+      : _buffer(buffer),
+        _size(size) {}
+
+  void *allocate(std::size_t capacity) override {
+    return (capacity <= _size ? _buffer : nullptr);
+  }
+
+  void *reallocate(
+      void *ptr,
+      std::size_t size,
+      std::size_t old_capacity,
+      std::size_t new_capacity) override {
+    return (new_capacity <= _size ? _buffer : nullptr);
+  }
+
+  void deallocate(void *ptr, std::size_t capacity) override {
+    // The buffer is owned by the caller.
+  }
+
+ private:
+  void *_buffer;
+  std::size_t _size;
+};
+
+/**
+ * An allocator that places buffers of at least 'threshold' bytes in anonymous
+ * memory mappings that are advised to be backed by transparent huge pages,
+ * which reduces the number of TLB misses when writing very large documents.
+ * Large buffers are grown with mremap(...), which avoids copying the data.
+ * Smaller buffers use std::malloc and friends. On platforms other than Linux,
+ * this allocator behaves like malloc_encode_allocator.
+ */
+class huge_page_encode_allocator final : public encode_allocator {
+ public:
+  explicit huge_page_encode_allocator(std::size_t threshold = 2 * 1024 * 1024)
+      : _threshold(threshold) {}
+
+  void *allocate(std::size_t capacity) override;
+  void *reallocate(
+      void *ptr,
+      std::size_t size,
+      std::size_t old_capacity,
+      std::size_t new_capacity) override;
+  void deallocate(void *ptr, std::size_t capacity) override;
+
+  static huge_page_encode_allocator &instance() {
+    static huge_page_encode_allocator allocator;
+    return allocator;
+  }
+
+ private:
+  bool is_huge(const std::size_t capacity) const {
+    return (capacity >= _threshold);
+  }
+
+  const std::size_t _threshold;
+};
+
+}  // namespace json
+}  // namespace spotify
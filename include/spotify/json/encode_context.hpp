@@ -22,23 +22,40 @@
 #include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <vector>
 
 #include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_allocator.hpp>
 
 namespace spotify {
 namespace json {
+
+/**
+ * A contiguous piece of encoded output. See base_encode_context::segments().
+ */
+struct encode_segment {
+  const void *data;
+  std::size_t size;
+};
+
 namespace detail {
 
 /**
  * An encode_context has the information that is kept while encoding JSON with
- * codecs. It keeps a buffer of data that can be expanded and written to.
+ * codecs. It keeps a buffer of data that can be expanded and written to. The
+ * buffer is managed by an encode_allocator, which must outlive the context.
+ * By default, the buffer is allocated with std::malloc.
  */
 template <typename size_type = std::size_t>
 struct base_encode_context final {
   base_encode_context(const size_type capacity = 4096)
-      : has_sse42(detail::cpuid().has_sse42()),
-        _buf(static_cast<uint8_t *>(capacity ? std::malloc(capacity) : nullptr)),
+      : base_encode_context(malloc_encode_allocator::instance(), capacity) {}
+
+  explicit base_encode_context(encode_allocator &allocator, const size_type capacity = 4096)
+      : has_sse42(detail::cpu_has_sse42()),
+        _allocator(allocator),
+        _buf(static_cast<uint8_t *>(capacity ? allocator.allocate(capacity) : nullptr)),
         _ptr(_buf),
         _end(_buf + capacity),
         _capacity(capacity) {
@@ -48,7 +65,7 @@ struct base_encode_context final {
   }
 
   ~base_encode_context() {
-    std::free(_buf);
+    _allocator.deallocate(_buf, _capacity);
   }
 
   json_force_inline uint8_t *reserve(const size_type num_bytes) {
@@ -85,6 +102,57 @@ struct base_encode_context final {
 
   json_never_inline void clear() {
     _ptr = _buf;
+    _references.clear();
+  }
+
+  /**
+   * Allow codecs to reference values of at least 'threshold' bytes, instead of
+   * copying them into the buffer. This is done for raw_t values and for string_t
+   * values that do not need escaping. The output must then be read through
+   * segments(), and the encoded values must outlive the segments.
+   */
+  void set_reference_threshold(const size_type threshold) {
+    _reference_threshold = threshold;
+  }
+
+  json_force_inline bool should_reference(const size_type num_bytes) const {
+    return (num_bytes >= _reference_threshold);
+  }
+
+  /**
+   * Insert a reference to external data at the current position. The data is
+   * not copied and must be a complete JSON value (or the unescaped body of a
+   * string), which is what append_or_replace(...) assumes.
+   */
+  void append_reference(const void *data, const size_type size) {
+    _references.push_back(reference{ this->size(), data, size });
+  }
+
+  /**
+   * The complete output as a list of segments, alternating between parts of the
+   * buffer of this context and referenced data, suitable for writev(...). The
+   * segments are invalidated when the context is written to or destroyed. If
+   * no data has been referenced, this is a single segment with data() and
+   * size().
+   */
+  std::vector<encode_segment> segments() const {
+    std::vector<encode_segment> segments;
+    segments.reserve(_references.size() * 2 + 1);
+
+    size_type offset = 0;
+    for (const auto &ref : _references) {
+      if (ref.offset != offset) {
+        segments.push_back(encode_segment{ _buf + offset, std::size_t(ref.offset - offset) });
+        offset = ref.offset;
+      }
+      segments.push_back(encode_segment{ ref.data, std::size_t(ref.size) });
+    }
+
+    if (size() != offset || segments.empty()) {
+      segments.push_back(encode_segment{ _buf + offset, std::size_t(size() - offset) });
+    }
+
+    return segments;
   }
 
   json_force_inline const void *data() const {
@@ -99,6 +167,10 @@ struct base_encode_context final {
     return _capacity;
   }
 
+  json_force_inline size_type remaining() const {
+    return static_cast<size_type>(_end - _ptr);
+  }
+
   json_force_inline bool empty() const {
     return (_ptr == _buf);
   }
@@ -127,20 +199,30 @@ struct base_encode_context final {
     // is at least as large as the reserved size. We avoid doing any arithmetics
     // here to not have to check for overflow yet again.
     const auto actual_capacity = std::max(new_size, new_capacity);
-    _buf = static_cast<uint8_t *>(std::realloc(_buf, actual_capacity));
-    if (json_unlikely(!_buf)) {
+    const auto new_buf = _allocator.reallocate(_buf, old_size, _capacity, actual_capacity);
+    if (json_unlikely(!new_buf)) {
       throw std::bad_alloc();
     }
 
+    _buf = static_cast<uint8_t *>(new_buf);
     _ptr = _buf + old_size;
     _end = _buf + actual_capacity;
     _capacity = actual_capacity;
   }
 
+  struct reference {
+    size_type offset;
+    const void *data;
+    size_type size;
+  };
+
+  encode_allocator &_allocator;
   uint8_t *_buf;
   uint8_t *_ptr;
   const uint8_t *_end;
   size_type _capacity;
+  size_type _reference_threshold = std::numeric_limits<size_type>::max();
+  std::vector<reference> _references;
 };
 
 }  // namespace detail
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A parsed JSON Pointer (RFC 6901), such as "/user/id" or "/items/0/uri". The
+ * empty pointer "" refers to the whole document. The tokens are unescaped when
+ * the pointer is parsed, so that no work is needed when matching them against
+ * a document. Throws std::invalid_argument if the pointer is malformed.
+ */
+class json_pointer final {
+ public:
+  json_pointer(const char *pointer);
+  json_pointer(std::string pointer);
+
+  const std::string &str() const { return _pointer; }
+  const std::vector<std::string> &tokens() const { return _tokens; }
+
+ private:
+  std::string _pointer;
+  std::vector<std::string> _tokens;
+};
+
+namespace detail {
+
+/**
+ * The array index that a JSON pointer token refers to, or npos if the token is
+ * not a valid array index ("-", leading zeros, non-digits).
+ */
+std::size_t parse_array_index(const std::string &token);
+
+/**
+ * Advance the context to the start of the value that the pointer refers to,
+ * skipping every other value on the way. Returns false if there is no such
+ * value, in which case the context is left at the start of the value in which
+ * the lookup failed. Object keys are compared in place, without allocating.
+ */
+bool find_pointer(decode_context &context, const json_pointer &pointer);
+
+/**
+ * Like find_pointer, for a range of the tokens of a pointer.
+ */
+bool find_tokens(
+    decode_context &context,
+    std::vector<std::string>::const_iterator begin,
+    std::vector<std::string>::const_iterator end);
+
+struct extract_target {
+  virtual ~extract_target() = default;
+  virtual void decode(decode_context &context) const = 0;
+};
+
+template <typename codec_type, typename callback_type>
+struct extract_target_t final : public extract_target {
+  extract_target_t(codec_type codec, callback_type callback)
+      : codec(std::move(codec)),
+        callback(std::move(callback)) {}
+
+  void decode(decode_context &context) const override {
+    callback(codec.decode(context));
+  }
+
+  codec_type codec;
+  callback_type callback;
+};
+
+/**
+ * A node in the tree of tokens of all pointers of an extractor. The children
+ * and targets are indices into the node and target lists of the extractor.
+ */
+struct extract_node {
+  std::string token;
+  std::size_t index;
+  std::vector<std::size_t> children;
+  std::vector<std::size_t> targets;
+};
+
+}  // namespace detail
+
+/**
+ * Decode the value that a JSON pointer refers to, without decoding anything
+ * else. Every subtree that is not on the path is skipped, and nothing after the
+ * value is read, so the rest of the document is not validated. A
+ * decode_exception is thrown if there is no value at the pointer.
+ */
+template <typename codec_type>
+typename codec_type::object_type extract(
+    const json_pointer &pointer,
+    const codec_type &codec,
+    const char *data,
+    const std::size_t size) {
+  decode_context context(data, size);
+  if (json_unlikely(!detail::find_pointer(context, pointer))) {
+    detail::fail(context, "No value at JSON pointer '" + pointer.str() + "'");
+  }
+  return codec.decode(context);
+}
+
+template <typename codec_type>
+typename codec_type::object_type extract(
+    const json_pointer &pointer,
+    const codec_type &codec,
+    const std::string &string) {
+  return extract(pointer, codec, string.data(), string.size());
+}
+
+template <typename Value>
+Value extract(const json_pointer &pointer, const char *data, const std::size_t size) {
+  return extract(pointer, cached_default_codec<Value>(), data, size);
+}
+
+template <typename Value>
+Value extract(const json_pointer &pointer, const std::string &string) {
+  return extract(pointer, cached_default_codec<Value>(), string);
+}
+
+template <typename codec_type>
+bool try_extract(
+    typename codec_type::object_type &object,
+    const json_pointer &pointer,
+    const codec_type &codec,
+    const char *data,
+    const std::size_t size) {
+  try {
+    object = extract(pointer, codec, data, size);
+    return true;
+  } catch (const decode_exception &) {
+    return false;
+  }
+}
+
+template <typename codec_type>
+bool try_extract(
+    typename codec_type::object_type &object,
+    const json_pointer &pointer,
+    const codec_type &codec,
+    const std::string &string) {
+  return try_extract(object, pointer, codec, string.data(), string.size());
+}
+
+template <typename Value>
+bool try_extract(Value &object, const json_pointer &pointer, const std::string &string) {
+  return try_extract(object, pointer, cached_default_codec<Value>(), string);
+}
+
+template <typename Value>
+bool try_extract(Value &object, const json_pointer &pointer, const char *data, const std::size_t size) {
+  return try_extract(object, pointer, cached_default_codec<Value>(), data, size);
+}
+
+/**
+ * Extracts the values at several JSON pointers in a single pass over a
+ * document. The pointers are merged into a tree, so a subtree is only entered
+ * if some pointer leads into it, and the document is only read until all
+ * values have been found. If a key occurs more than once, the first occurrence
+ * is used. An extractor can be reused for any number of documents, also
+ * concurrently as long as the callbacks allow it.
+ *
+ *   int64_t id;
+ *   std::string uri;
+ *   spotify::json::extractor extractor;
+ *   extractor.add("/user/id", id);
+ *   extractor.add("/items/0/uri", codec::string(), [&](std::string &&u) { uri = u; });
+ *   const auto found = extractor.extract(data, size);
+ */
+class extractor final {
+ public:
+  extractor();
+
+  /**
+   * Decode the value at the pointer with the codec, and call the callback with
+   * the decoded value.
+   */
+  template <typename codec_type, typename callback_type>
+  extractor &add(const json_pointer &pointer, codec_type codec, callback_type callback) {
+    using target_type = detail::extract_target_t<codec_type, callback_type>;
+    add_target(pointer, std::make_shared<target_type>(std::move(codec), std::move(callback)));
+    return *this;
+  }
+
+  /**
+   * Decode the value at the pointer with the default codec into 'value', which
+   * must outlive the extractor.
+   */
+  template <typename value_type>
+  extractor &add(const json_pointer &pointer, value_type &value) {
+    const auto target = &value;
+    return add(pointer, default_codec<value_type>(), [target](value_type &&decoded) {
+      *target = std::move(decoded);
+    });
+  }
+
+  /**
+   * Extract the values from a document and return how many of the pointers
+   * were found. A decode_exception is thrown if the document is invalid in a
+   * part that had to be read to find the values.
+   */
+  std::size_t extract(const char *data, std::size_t size) const;
+
+  std::size_t extract(const std::string &string) const {
+    return extract(string.data(), string.size());
+  }
+
+ private:
+  void add_target(const json_pointer &pointer, std::shared_ptr<const detail::extract_target> target);
+
+  std::vector<detail::extract_node> _nodes;
+  std::vector<std::shared_ptr<const detail::extract_target>> _targets;
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/escape.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A string of at most N bytes, stored inline, for short identifiers such as
+ * base62 IDs and country codes. A fixed_string<22> is 24 bytes and never
+ * allocates memory, so structs with fixed_strings can be kept contiguously in
+ * arrays. Constructing a fixed_string from a longer string throws
+ * std::length_error.
+ *
+ * A fixed_string remembers whether it has any characters that must be escaped
+ * in JSON, which it checks once when it is constructed, so that encoding a
+ * clean string is a single copy.
+ */
+template <std::size_t N>
+class fixed_string final {
+ public:
+  using size_type = typename std::conditional<(N < 256), uint8_t, uint32_t>::type;
+
+  fixed_string() : _size(0), _is_clean(true) {}
+
+  fixed_string(const char *data, const std::size_t size) {
+    if (json_unlikely(size > N)) {
+      throw std::length_error("String is too long for fixed_string");
+    }
+    assign(data, size, is_clean(data, size));
+  }
+
+  fixed_string(const char *string)
+      : fixed_string(string, std::strlen(string)) {}
+
+  fixed_string(const std::string &string)
+      : fixed_string(string.data(), string.size()) {}
+
+  static constexpr std::size_t capacity() { return N; }
+
+  const char *data() const { return _data; }
+  std::size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+
+  /**
+   * True if none of the characters needs to be escaped in JSON.
+   */
+  bool is_clean() const { return _is_clean; }
+
+  std::string str() const {
+    return std::string(_data, _size);
+  }
+
+  friend bool operator==(const fixed_string &a, const fixed_string &b) {
+    return a._size == b._size && std::memcmp(a._data, b._data, a._size) == 0;
+  }
+
+  friend bool operator!=(const fixed_string &a, const fixed_string &b) {
+    return !(a == b);
+  }
+
+  friend bool operator<(const fixed_string &a, const fixed_string &b) {
+    const auto result = std::memcmp(a._data, b._data, std::min(a._size, b._size));
+    return (result < 0) || (result == 0 && a._size < b._size);
+  }
+
+  /**
+   * Set the contents without checking them; 'size' must be at most N, and
+   * 'is_clean' must be true only if no character needs escaping.
+   */
+  void assign(const char *data, const std::size_t size, const bool is_clean) {
+    std::memcpy(_data, data, size);
+    _size = static_cast<size_type>(size);
+    _is_clean = is_clean;
+  }
+
+  static bool is_clean(const char *data, const std::size_t size) {
+    for (std::size_t i = 0; i < size; i++) {
+      if (!is_clean(data[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool is_clean(const char c) {
+    return (uint8_t(c) >= 0x20 && c != '"' && c != '\\');
+  }
+
+ private:
+  char _data[N];
+  size_type _size;
+  bool _is_clean;
+};
+
+namespace codec {
+
+/**
+ * A codec for fixed_string<N>. Strings without escape sequences are decoded
+ * with a single scan over at most N + 1 bytes, which finds the end of the
+ * string and checks whether it is clean at the same time. Strings with more
+ * than N bytes (after unescaping) fail to decode.
+ */
+template <std::size_t N>
+class fixed_string_t final {
+ public:
+  using object_type = json::fixed_string<N>;
+
+  object_type decode(decode_context &context) const {
+    const auto begin = context.position;
+    detail::skip_1(context, '"');
+
+    const auto data = context.position;
+    const auto limit = std::min(context.remaining(), N + 1);
+    auto is_clean = true;
+    for (std::size_t i = 0; i < limit; i++) {
+      const auto c = data[i];
+      if (c == '"') {
+        object_type result;
+        result.assign(data, i, is_clean);
+        context.position = data + i + 1;
+        return result;
+      } else if (c == '\\') {
+        return decode_escaped(context, begin);
+      }
+      is_clean &= object_type::is_clean(c);
+    }
+
+    detail::fail_if(context, limit <= N, "Unterminated string");
+    context.position = begin;
+    detail::fail(context, "String is too long for fixed_string");
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    const auto size = value.size();
+    if (json_likely(value.is_clean())) {
+      // Copying all N bytes is a copy of a size known at compile time, which is
+      // an order of magnitude cheaper than a memcpy call of 'size' bytes. Only
+      // the first 'size' bytes are kept. Near the end of the buffer, reserve
+      // the exact size instead, so that a fixed size buffer does not overflow.
+      if (json_likely(context.remaining() >= N + 2)) {
+        write_quoted(context.reserve(N + 2), value.data(), N, size);
+      } else {
+        write_quoted(context.reserve(size + 2), value.data(), size, size);
+      }
+      context.advance(size + 2);
+      return;
+    }
+
+    const auto data = reinterpret_cast<const uint8_t *>(value.data());
+    context.append('"');
+    detail::write_escaped(context, data, data + size);
+    context.append('"');
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    if (json_likely(value.is_clean())) {
+      return value.size() + 2;
+    }
+    return detail::measure_string(context, value.data(), value.size());
+  }
+
+ private:
+  json_force_inline static void write_quoted(
+      uint8_t *out,
+      const char *data,
+      const std::size_t copy_size,
+      const std::size_t size) {
+    out[0] = '"';
+    std::memcpy(out + 1, data, copy_size);
+    out[size + 1] = '"';
+  }
+
+  json_never_inline static object_type decode_escaped(decode_context &context, const char *begin) {
+    context.position = begin;
+    const auto string = string_t().decode(context);
+    if (json_unlikely(string.size() > N)) {
+      context.position = begin;
+      detail::fail(context, "String is too long for fixed_string");
+    }
+
+    object_type result;
+    result.assign(string.data(), string.size(), object_type::is_clean(string.data(), string.size()));
+    return result;
+  }
+};
+
+template <std::size_t N>
+inline fixed_string_t<N> fixed_string() {
+  return fixed_string_t<N>();
+}
+
+}  // namespace codec
+
+namespace detail {
+
+template <std::size_t N>
+struct is_string_codec<codec::fixed_string_t<N>> : std::true_type {};
+
+}  // namespace detail
+
+template <std::size_t N>
+struct default_codec_t<fixed_string<N>> {
+  static codec::fixed_string_t<N> codec() {
+    return codec::fixed_string_t<N>();
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
+
+namespace std {
+
+template <std::size_t N>
+struct hash<spotify::json::fixed_string<N>> {
+  std::size_t operator()(const spotify::json::fixed_string<N> &string) const {
+    std::size_t hash = 14695981039346656037ULL;  // FNV-1a
+    for (std::size_t i = 0; i < string.size(); i++) {
+      hash = (hash ^ uint8_t(string.data()[i])) * 1099511628211ULL;
+    }
+    return hash;
+  }
+};
+
+}  // namespace std
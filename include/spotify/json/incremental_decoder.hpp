@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/incremental_splitter.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * Decodes a top-level JSON array that arrives in chunks, e.g., from a network
+ * connection, without first concatenating the chunks. Every element is decoded
+ * with the codec as soon as it is complete, and passed to the callback given to
+ * feed(...). Memory use is bounded by the size of the largest element.
+ *
+ * decode_exceptions thrown by feed(...) and finish() have offsets relative to
+ * the start of the document. After an exception, the decoder must be reset.
+ */
+template <typename codec_type>
+class incremental_array_decoder final {
+ public:
+  using object_type = typename codec_type::object_type;
+
+  explicit incremental_array_decoder(codec_type codec)
+      : _codec(std::move(codec)),
+        _splitter('[') {}
+
+  /**
+   * Decode the complete elements in the chunk, calling callback(object_type &&)
+   * for each of them.
+   */
+  template <typename callback_type>
+  void feed(const char *data, const size_t size, callback_type &&callback) {
+    _splitter.feed(data, size, [&](decode_context &context) {
+      callback(_codec.decode(context));
+    });
+  }
+
+  template <typename callback_type>
+  void feed(const std::string &chunk, callback_type &&callback) {
+    feed(chunk.data(), chunk.size(), std::forward<callback_type>(callback));
+  }
+
+  /**
+   * Signal that there is no more input. Fails if the array is incomplete.
+   */
+  void finish() const { _splitter.finish(); }
+  void reset() { _splitter.reset(); }
+  bool is_done() const { return _splitter.is_done(); }
+  size_t buffered() const { return _splitter.buffered(); }
+
+ private:
+  codec_type _codec;
+  detail::incremental_splitter _splitter;
+};
+
+/**
+ * Like incremental_array_decoder, but for a top-level JSON object. The values
+ * are decoded with the codec, and passed to the callback with their keys as
+ * callback(std::string &&key, object_type &&value).
+ */
+template <typename codec_type>
+class incremental_object_decoder final {
+ public:
+  using object_type = typename codec_type::object_type;
+
+  explicit incremental_object_decoder(codec_type codec)
+      : _codec(std::move(codec)),
+        _splitter('{') {}
+
+  template <typename callback_type>
+  void feed(const char *data, const size_t size, callback_type &&callback) {
+    _splitter.feed(data, size, [&](decode_context &context) {
+      auto key = _key_codec.decode(context);
+      detail::skip_any_whitespace(context);
+      detail::skip_1(context, ':');
+      detail::skip_any_whitespace(context);
+      callback(std::move(key), _codec.decode(context));
+    });
+  }
+
+  template <typename callback_type>
+  void feed(const std::string &chunk, callback_type &&callback) {
+    feed(chunk.data(), chunk.size(), std::forward<callback_type>(callback));
+  }
+
+  void finish() const { _splitter.finish(); }
+  void reset() { _splitter.reset(); }
+  bool is_done() const { return _splitter.is_done(); }
+  size_t buffered() const { return _splitter.buffered(); }
+
+ private:
+  codec::string_t _key_codec;
+  codec_type _codec;
+  detail::incremental_splitter _splitter;
+};
+
+template <typename codec_type>
+incremental_array_decoder<typename std::decay<codec_type>::type> incremental_array(codec_type &&codec) {
+  return incremental_array_decoder<typename std::decay<codec_type>::type>(std::forward<codec_type>(codec));
+}
+
+template <typename codec_type>
+incremental_object_decoder<typename std::decay<codec_type>::type> incremental_object(codec_type &&codec) {
+  return incremental_object_decoder<typename std::decay<codec_type>::type>(std::forward<codec_type>(codec));
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A shared, immutable string from an intern_table. Copying a handle copies a
+ * shared_ptr, and equal strings from the same table usually share the same
+ * memory, which makes comparing them cheap. A handle stays valid after its
+ * string has been evicted from the table. A default constructed handle is the
+ * empty string.
+ */
+class interned_string final {
+ public:
+  interned_string() = default;
+
+  explicit interned_string(std::shared_ptr<const std::string> string)
+      : _string(std::move(string)) {}
+
+  const std::string &str() const {
+    return (_string ? *_string : empty_string());
+  }
+
+  operator const std::string &() const {
+    return str();
+  }
+
+  const char *data() const { return str().data(); }
+  std::size_t size() const { return str().size(); }
+  bool empty() const { return str().empty(); }
+
+  friend bool operator==(const interned_string &a, const interned_string &b) {
+    return (a._string == b._string) || (a.str() == b.str());
+  }
+
+  friend bool operator!=(const interned_string &a, const interned_string &b) {
+    return !(a == b);
+  }
+
+  friend bool operator<(const interned_string &a, const interned_string &b) {
+    return (a._string != b._string) && (a.str() < b.str());
+  }
+
+ private:
+  static const std::string &empty_string() {
+    static const std::string string;
+    return string;
+  }
+
+  std::shared_ptr<const std::string> _string;
+};
+
+struct intern_statistics final {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  std::size_t size = 0;
+
+  double hit_rate() const {
+    const auto lookups = hits + misses;
+    return (lookups ? double(hits) / lookups : 0.0);
+  }
+};
+
+/**
+ * A thread safe table of interned strings, for inputs that repeat the same
+ * small set of strings, such as country codes, URIs, enum-like labels and map
+ * keys. Strings are looked up by the hash of their bytes, without allocating
+ * memory, so a hit only costs a hash, a lock and a comparison.
+ *
+ * The table is split into shards, each with its own lock, so that concurrent
+ * lookups of different strings rarely contend. Each shard keeps two
+ * generations of strings. When the current generation of a shard is full, the
+ * previous generation is evicted and the current one takes its place; strings
+ * that are found in the previous generation are moved back to the current
+ * one. This bounds the size of the table to about 'max_size' strings while
+ * keeping the strings that are in use. Strings longer than 'max_string_size'
+ * are never interned.
+ */
+class intern_table final {
+ public:
+  explicit intern_table(std::size_t max_size = 64 * 1024, std::size_t max_string_size = 256);
+  ~intern_table();
+
+  intern_table(const intern_table &) = delete;
+  intern_table &operator=(const intern_table &) = delete;
+
+  interned_string intern(const char *data, std::size_t size);
+
+  interned_string intern(const std::string &string) {
+    return intern(string.data(), string.size());
+  }
+
+  /**
+   * Evict all strings and reset the statistics.
+   */
+  void clear();
+
+  intern_statistics statistics() const;
+
+  /**
+   * The table that the default codec for interned_string uses. It is never
+   * destroyed, so it can be used from static destructors.
+   */
+  static intern_table &instance();
+
+ private:
+  struct shard;
+
+  const std::size_t _max_shard_size;
+  const std::size_t _max_string_size;
+  std::unique_ptr<shard[]> _shards;
+};
+
+namespace codec {
+
+/**
+ * A codec for interned_string, which can also be the key codec of a map_t.
+ * Strings without escape sequences are looked up directly from the input,
+ * without first being copied into a std::string.
+ */
+class interned_string_t final {
+ public:
+  using object_type = json::interned_string;
+
+  interned_string_t()
+      : _table(&intern_table::instance()) {}
+
+  explicit interned_string_t(intern_table &table)
+      : _table(&table) {}
+
+  object_type decode(decode_context &context) const {
+    const auto begin = context.position;
+    detail::skip_1(context, '"');
+    if (json_likely(!detail::skip_string_body(context))) {
+      return _table->intern(begin + 1, context.position - begin - 2);
+    }
+
+    context.position = begin;
+    return _table->intern(string_t().decode(context));
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    string_t().encode(context, value.str());
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return string_t().measure(context, value.str());
+  }
+
+ private:
+  intern_table *_table;
+};
+
+inline interned_string_t interned_string() {
+  return interned_string_t();
+}
+
+inline interned_string_t interned_string(intern_table &table) {
+  return interned_string_t(table);
+}
+
+}  // namespace codec
+
+namespace detail {
+
+template <>
+struct is_string_codec<codec::interned_string_t> : std::true_type {};
+
+}  // namespace detail
+
+template <>
+struct default_codec_t<interned_string> {
+  static codec::interned_string_t codec() {
+    return codec::interned_string_t();
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
+
+namespace std {
+
+template <>
+struct hash<spotify::json::interned_string> {
+  std::size_t operator()(const spotify::json::interned_string &string) const {
+    return hash<std::string>()(string.str());
+  }
+};
+
+}  // namespace std
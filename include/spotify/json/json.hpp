@@ -16,11 +16,32 @@
 
 #pragma once
 
+#include <spotify/json/arena.hpp>
 #include <spotify/json/codec.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_file.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/document_index.hpp>
+#include <spotify/json/dom.hpp>
+#include <spotify/json/element_iterator.hpp>
 #include <spotify/json/encode.hpp>
+#include <spotify/json/encode_allocator.hpp>
 #include <spotify/json/encode_exception.hpp>
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/extract.hpp>
+#include <spotify/json/fixed_string.hpp>
+#include <spotify/json/incremental_decoder.hpp>
+#include <spotify/json/interned_string.hpp>
+#include <spotify/json/mapped_file.hpp>
+#include <spotify/json/monotonic_allocator.hpp>
+#include <spotify/json/ndjson.hpp>
+#include <spotify/json/parallel_decode.hpp>
+#include <spotify/json/parallel_encode.hpp>
+#include <spotify/json/parallel_options.hpp>
+#include <spotify/json/projection.hpp>
+#include <spotify/json/record_filter.hpp>
+#include <spotify/json/sax.hpp>
+#include <spotify/json/shared_slice.hpp>
+#include <spotify/json/writer.hpp>
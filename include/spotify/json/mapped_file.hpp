@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A file that is mapped read-only into memory, for decoding straight from the
+ * page cache without first copying the file into a string. The mapping is
+ * advised for sequential access and, where supported, for transparent huge
+ * pages. Values that reference the input, such as codec::raw_ref, stay valid
+ * for as long as the mapped_file is alive.
+ *
+ * On platforms without mmap(...), the file is read into memory instead.
+ * Throws std::system_error if the file cannot be opened, inspected or mapped.
+ */
+class mapped_file final {
+ public:
+  explicit mapped_file(const std::string &path);
+  mapped_file(mapped_file &&other);
+  ~mapped_file();
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+  mapped_file &operator=(mapped_file &&) = delete;
+
+  const char *data() const {
+    return _data;
+  }
+
+  std::size_t size() const {
+    return _size;
+  }
+
+ private:
+  const char *_data;
+  std::size_t _size;
+  bool _is_mapped;
+  std::vector<char> _buffer;
+};
+
+}  // namespace json
+}  // namespace spotify
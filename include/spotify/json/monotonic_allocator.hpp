@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <spotify/json/arena.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A standard allocator that takes its memory from a monotonic_arena, so that
+ * containers and strings can be decoded without going through the global
+ * heap. Deallocation is a no-op; the memory is released with the arena. A
+ * monotonic_allocator without an arena uses operator new and delete, which
+ * makes types with such containers default constructible.
+ *
+ * Moving a container keeps its arena, so that decoded values can be moved
+ * into place. Copying a container gives a copy on the heap, which is safe to
+ * keep after the arena is gone.
+ */
+template <typename T>
+class monotonic_allocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = monotonic_allocator<U>;
+  };
+
+  monotonic_allocator() = default;
+
+  explicit monotonic_allocator(monotonic_arena *arena)
+      : _arena(arena) {}
+
+  template <typename U>
+  monotonic_allocator(const monotonic_allocator<U> &other)
+      : _arena(other.arena()) {}
+
+  T *allocate(const std::size_t n) {
+    if (_arena) {
+      return _arena->allocate_array<T>(n);
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T *ptr, std::size_t) {
+    if (!_arena) {
+      ::operator delete(ptr);
+    }
+  }
+
+  monotonic_allocator select_on_container_copy_construction() const {
+    return monotonic_allocator();
+  }
+
+  monotonic_arena *arena() const {
+    return _arena;
+  }
+
+ private:
+  monotonic_arena *_arena = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const monotonic_allocator<T> &a, const monotonic_allocator<U> &b) {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const monotonic_allocator<T> &a, const monotonic_allocator<U> &b) {
+  return a.arena() != b.arena();
+}
+
+using arena_string = std::basic_string<char, std::char_traits<char>, monotonic_allocator<char>>;
+
+template <typename T>
+using arena_vector = std::vector<T, monotonic_allocator<T>>;
+
+template <typename T>
+using arena_map = std::map<
+    arena_string, T, std::less<arena_string>,
+    monotonic_allocator<std::pair<const arena_string, T>>>;
+
+template <typename T>
+using arena_unordered_map = std::unordered_map<
+    arena_string, T, std::hash<arena_string>, std::equal_to<arena_string>,
+    monotonic_allocator<std::pair<const arena_string, T>>>;
+
+namespace detail {
+
+template <typename T>
+struct decode_allocator<monotonic_allocator<T>> {
+  static monotonic_allocator<T> get(const decode_context &context) {
+    return monotonic_allocator<T>(context.arena);
+  }
+};
+
+}  // namespace detail
+
+/**
+ * Decode with containers that use monotonic_allocator taking their memory from
+ * 'arena', which must outlive the decoded value, unless it is copied. Other
+ * containers use the heap as usual. Pointers decoded with arena_shared_ptr()
+ * are allocated in the arena too, and they must not outlive it: copying a
+ * std::shared_ptr shares the same memory, so no copy is safe to keep.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode(
+    const codec_type &codec,
+    const char *data,
+    const std::size_t size,
+    monotonic_arena &arena) {
+  decode_context c(data, data + size);
+  c.arena = &arena;
+  detail::skip_any_whitespace(c);
+  auto result = codec.decode(c);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+  return result;
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode(
+    const codec_type &codec,
+    const std::string &string,
+    monotonic_arena &arena) {
+  return decode(codec, string.data(), string.size(), arena);
+}
+
+template <typename Value>
+Value decode(const char *data, const std::size_t size, monotonic_arena &arena) {
+  return decode(cached_default_codec<Value>(), data, size, arena);
+}
+
+template <typename Value>
+Value decode(const std::string &string, monotonic_arena &arena) {
+  return decode(cached_default_codec<Value>(), string, arena);
+}
+
+}  // namespace json
+}  // namespace spotify
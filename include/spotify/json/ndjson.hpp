@@ -0,0 +1,468 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/find_line_end.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/parallel_for.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/parallel_options.hpp>
+#include <spotify/json/record_filter.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A record of newline delimited JSON (NDJSON) that could not be decoded.
+ */
+struct ndjson_error final {
+  size_t line;  // 1-based line number of the start of the record
+  size_t offset;  // offset of the error from the start of the input
+  std::string what;
+};
+
+template <typename T>
+struct ndjson_result final {
+  std::vector<T> values;
+  std::vector<ndjson_error> errors;
+};
+
+namespace detail {
+
+struct accept_all_records final {
+  bool operator()(const char *begin, const char *end) const {
+    return true;
+  }
+};
+
+struct discard_values final {
+  template <typename T>
+  void operator()(T &&) const {}
+};
+
+struct ignore_errors final {
+  void operator()(const decode_exception &) const {}
+};
+
+/**
+ * Decode the record that starts at begin, which ends at the first '\n' that is
+ * not inside a string; see find_line_end(...). Blank records are skipped, and
+ * records for which accept(begin, end) returns false are skipped without being
+ * decoded. Decoded values are passed to callback(object_type &&), and errors to
+ * on_error(const decode_exception &). Returns where the next record starts:
+ * after the end of this record, or, if this record failed, after the first
+ * '\n' in it, so that an unterminated string does not swallow the rest of the
+ * input.
+ */
+template <typename codec_type, typename callback_type, typename accept_type, typename error_callback_type>
+const char *decode_ndjson_record(
+    const codec_type &codec,
+    const decode_context &input,
+    const char *begin,
+    callback_type &callback,
+    const accept_type &accept,
+    const error_callback_type &on_error) {
+  const auto line_end = find_line_end(input, begin, input.end);
+
+  decode_context context(begin, line_end);
+  try {
+    skip_any_whitespace(context);
+    if (json_likely(context.remaining()) && accept(begin, line_end)) {
+      auto value = codec.decode(context);
+      skip_any_whitespace(context);
+      fail_if(context, context.position != context.end, "Unexpected trailing input");
+      callback(std::move(value));
+    }
+  } catch (const decode_exception &exception) {
+    on_error(exception);
+    const auto newline = static_cast<const char *>(std::memchr(begin, '\n', size_t(line_end - begin)));
+    if (newline) {
+      return newline + 1;
+    }
+  }
+
+  return (line_end == input.end ? line_end : line_end + 1);
+}
+
+/**
+ * Find where the record after the one at begin starts, exactly like
+ * decode_ndjson_record(...) does. Only records with a raw '\n' inside a string
+ * are decoded for this, since whether they fail decides where the next record
+ * starts. The record after any other record starts on the next line.
+ */
+template <typename codec_type, typename accept_type>
+const char *next_ndjson_record(
+    const codec_type &codec,
+    const decode_context &input,
+    const char *begin,
+    const accept_type &accept) {
+  const auto line_end = find_line_end(input, begin, input.end);
+  if (json_likely(!std::memchr(begin, '\n', size_t(line_end - begin)))) {
+    return (line_end == input.end ? line_end : line_end + 1);
+  }
+
+  discard_values discard;
+  return decode_ndjson_record(codec, input, begin, discard, accept, ignore_errors());
+}
+
+/**
+ * Decode the records of the input that start in [begin, end), where begin is
+ * the start of a record, with decode_ndjson_record(...). The last record may
+ * extend past end. The errors get the physical line numbers of their records,
+ * counting the line of begin as line 1, and offsets from the start of the
+ * input. Returns the number of '\n' characters in the decoded records.
+ */
+template <typename codec_type, typename callback_type, typename accept_type = accept_all_records>
+size_t for_each_ndjson_record(
+    const codec_type &codec,
+    const decode_context &input,
+    const char *begin,
+    const char *end,
+    std::vector<ndjson_error> &errors,
+    callback_type &callback,
+    const accept_type &accept = accept_type()) {
+  auto record_begin = begin;
+  size_t line = 1;
+
+  while (record_begin < end) {
+    const auto next = decode_ndjson_record(codec, input, record_begin, callback, accept, [&](
+        const decode_exception &exception) {
+      errors.push_back(ndjson_error{ line, size_t(record_begin - input.begin) + exception.offset(), exception.what() });
+    });
+    line += size_t(std::count(record_begin, next, '\n'));
+    record_begin = next;
+  }
+
+  return line - 1;
+}
+
+/**
+ * Split the input into chunks of about chunk_size bytes that begin and end at
+ * the same record boundaries as for_each_ndjson_record(...) finds when decoding
+ * the whole input. The chunks of split_lines(...) start at physical lines,
+ * which may be inside a record if a string has a raw '\n'. Walking the records
+ * of each of those chunks, in parallel, finds where its last record ends; the
+ * next chunk then starts there, and is walked again if it started elsewhere.
+ * For valid NDJSON, every chunk starts where split_lines(...) put it.
+ */
+template <typename codec_type, typename accept_type>
+std::vector<std::pair<const char *, const char *>> split_ndjson(
+    const codec_type &codec,
+    const decode_context &input,
+    const parallel_options &options,
+    const accept_type &accept) {
+  const auto walk = [&](const char *position, const char *limit) -> const char * {
+    while (position < limit) {
+      position = next_ndjson_record(codec, input, position, accept);
+    }
+    return position;
+  };
+
+  const auto lines = split_lines(input.begin, input.end, options.chunk_size);
+  std::vector<const char *> walked(lines.size());
+  parallel_for(options.threads, lines.size(), [&](const size_t i) {
+    walked[i] = walk(lines[i].first, lines[i].second);
+  });
+
+  std::vector<std::pair<const char *, const char *>> chunks;
+  chunks.reserve(lines.size());
+  auto begin = input.begin;
+  for (size_t i = 0; i < lines.size(); i++) {
+    const auto end = (begin == lines[i].first ? walked[i] : walk(begin, lines[i].second));
+    if (end != begin) {
+      chunks.emplace_back(begin, end);
+      begin = end;
+    }
+  }
+  return chunks;
+}
+
+/**
+ * Decode the chunks of the input (see split_ndjson(...)) on multiple threads,
+ * calling make_callback(chunk_index) once per chunk for the callback. Each chunk
+ * collects its errors with line numbers relative to the chunk; they are made
+ * relative to the whole input once all chunks are done.
+ */
+template <typename codec_type, typename make_callback_type, typename accept_type = accept_all_records>
+std::vector<ndjson_error> parallel_for_each_ndjson_record(
+    const codec_type &codec,
+    const decode_context &input,
+    const std::vector<std::pair<const char *, const char *>> &chunks,
+    const parallel_options &options,
+    const make_callback_type &make_callback,
+    const accept_type &accept = accept_type()) {
+  struct chunk_errors {
+    std::vector<ndjson_error> errors;
+    size_t newlines = 0;
+  };
+
+  std::vector<chunk_errors> results(chunks.size());
+  parallel_for(options.threads, chunks.size(), [&](const size_t i) {
+    auto callback = make_callback(i);
+    results[i].newlines = for_each_ndjson_record(
+        codec, input, chunks[i].first, chunks[i].second, results[i].errors, callback, accept);
+  });
+
+  // Each chunk except the last one ends just after a '\n', so the newlines in
+  // the chunks before a chunk are the lines before its first line.
+  std::vector<ndjson_error> errors;
+  size_t lines = 0;
+  for (auto &result : results) {
+    for (auto &error : result.errors) {
+      error.line += lines;
+      errors.push_back(std::move(error));
+    }
+    lines += result.newlines;
+  }
+  return errors;
+}
+
+/**
+ * Decode the records that are accepted on multiple threads, and return the
+ * values and errors in input order.
+ */
+template <typename codec_type, typename accept_type>
+ndjson_result<typename codec_type::object_type> parallel_collect_ndjson(
+    const codec_type &codec,
+    const char *data,
+    const size_t size,
+    const parallel_options &options,
+    const accept_type &accept) {
+  using object_type = typename codec_type::object_type;
+  const decode_context input(data, size);
+  const auto chunks = split_ndjson(codec, input, options, accept);
+  std::vector<std::vector<object_type>> chunk_values(chunks.size());
+  ndjson_result<object_type> result;
+  result.errors = parallel_for_each_ndjson_record(codec, input, chunks, options, [&](size_t i) {
+    auto &values = chunk_values[i];
+    return [&values](object_type &&value) {
+      values.push_back(std::move(value));
+    };
+  }, accept);
+
+  size_t num_values = 0;
+  for (const auto &values : chunk_values) {
+    num_values += values.size();
+  }
+
+  result.values.reserve(num_values);
+  for (auto &values : chunk_values) {
+    std::move(values.begin(), values.end(), std::back_inserter(result.values));
+  }
+  return result;
+}
+
+/**
+ * Adapts a record_filter to the accept(begin, end) interface of
+ * for_each_ndjson_record(...).
+ */
+struct accept_filtered_records final {
+  bool operator()(const char *begin, const char *end) const {
+    return filter(begin, size_t(end - begin));
+  }
+
+  const record_filter &filter;
+};
+
+}  // namespace detail
+
+/**
+ * Decode newline delimited JSON (NDJSON, also known as JSON Lines), calling
+ * callback(object_type &&) with each record. Blank lines are skipped. Records
+ * that fail to decode do not abort the decoding; the errors are returned, with
+ * their line numbers, in the order they occurred.
+ */
+template <typename codec_type, typename callback_type>
+std::vector<ndjson_error> decode_ndjson(
+    const codec_type &codec,
+    const char *data,
+    const size_t size,
+    callback_type &&callback) {
+  std::vector<ndjson_error> errors;
+  const decode_context input(data, size);
+  detail::for_each_ndjson_record(codec, input, input.begin, input.end, errors, callback);
+  return errors;
+}
+
+/**
+ * Decode newline delimited JSON into a vector of values and a vector of errors.
+ */
+template <typename codec_type>
+ndjson_result<typename codec_type::object_type> decode_ndjson(
+    const codec_type &codec,
+    const char *data,
+    const size_t size) {
+  ndjson_result<typename codec_type::object_type> result;
+  result.errors = decode_ndjson(codec, data, size, [&](typename codec_type::object_type &&value) {
+    result.values.push_back(std::move(value));
+  });
+  return result;
+}
+
+template <typename codec_type>
+ndjson_result<typename codec_type::object_type> decode_ndjson(
+    const codec_type &codec,
+    const std::string &string) {
+  return decode_ndjson(codec, string.data(), string.size());
+}
+
+template <typename Value>
+ndjson_result<Value> decode_ndjson(const std::string &string) {
+  return decode_ndjson(cached_default_codec<Value>(), string);
+}
+
+/**
+ * Decode newline delimited JSON on multiple threads, calling callback(object_type
+ * &&) with each record. The callback is called concurrently from the decoding
+ * threads and in no particular order, so it must be thread safe. The codec is
+ * shared by all threads and is only used through its const methods. The errors
+ * are returned in input order, like for decode_ndjson(...).
+ */
+template <typename codec_type, typename callback_type>
+std::vector<ndjson_error> parallel_decode_ndjson(
+    const codec_type &codec,
+    const char *data,
+    const size_t size,
+    const parallel_options &options,
+    callback_type &&callback) {
+  const decode_context input(data, size);
+  const auto chunks = detail::split_ndjson(codec, input, options, detail::accept_all_records());
+  return detail::parallel_for_each_ndjson_record(codec, input, chunks, options, [&](size_t) {
+    return [&](typename codec_type::object_type &&value) {
+      callback(std::move(value));
+    };
+  });
+}
+
+/**
+ * Decode newline delimited JSON on multiple threads. The values and errors are
+ * returned in input order, exactly as decode_ndjson(...) would return them.
+ */
+template <typename codec_type>
+ndjson_result<typename codec_type::object_type> parallel_decode_ndjson(
+    const codec_type &codec,
+    const char *data,
+    const size_t size,
+    const parallel_options &options = parallel_options()) {
+  return detail::parallel_collect_ndjson(codec, data, size, options, detail::accept_all_records());
+}
+
+template <typename codec_type>
+ndjson_result<typename codec_type::object_type> parallel_decode_ndjson(
+    const codec_type &codec,
+    const std::string &string,
+    const parallel_options &options = parallel_options()) {
+  return parallel_decode_ndjson(codec, string.data(), string.size(), options);
+}
+
+/**
+ * Decode the records of newline delimited JSON that match the filter, calling
+ * callback(object_type &&) with each of them. Records that do not match are
+ * discarded without being decoded, or even fully validated. Errors, including
+ * errors that the filter runs into, are reported like for decode_ndjson(...).
+ */
+template <typename codec_type, typename callback_type>
+std::vector<ndjson_error> filter_ndjson(
+    const codec_type &codec,
+    const char *data,
+    const size_t size,
+    const record_filter &filter,
+    callback_type &&callback) {
+  std::vector<ndjson_error> errors;
+  const detail::accept_filtered_records accept{ filter };
+  const decode_context input(data, size);
+  detail::for_each_ndjson_record(codec, input, input.begin, input.end, errors, callback, accept);
+  return errors;
+}
+
+template <typename codec_type>
+ndjson_result<typename codec_type::object_type> filter_ndjson(
+    const codec_type &codec,
+    const char *data,
+    const size_t size,
+    const record_filter &filter) {
+  ndjson_result<typename codec_type::object_type> result;
+  result.errors = filter_ndjson(codec, data, size, filter, [&](typename codec_type::object_type &&value) {
+    result.values.push_back(std::move(value));
+  });
+  return result;
+}
+
+template <typename codec_type>
+ndjson_result<typename codec_type::object_type> filter_ndjson(
+    const codec_type &codec,
+    const std::string &string,
+    const record_filter &filter) {
+  return filter_ndjson(codec, string.data(), string.size(), filter);
+}
+
+/**
+ * Like filter_ndjson(...), on multiple threads; see parallel_decode_ndjson(...).
+ */
+template <typename codec_type>
+ndjson_result<typename codec_type::object_type> parallel_filter_ndjson(
+    const codec_type &codec,
+    const char *data,
+    const size_t size,
+    const record_filter &filter,
+    const parallel_options &options = parallel_options()) {
+  return detail::parallel_collect_ndjson(codec, data, size, options, detail::accept_filtered_records{ filter });
+}
+
+/**
+ * Append the values in [begin, end) to the context as newline delimited JSON:
+ * each value is encoded and followed by a '\n'. The built-in codecs never emit
+ * raw newlines, but raw_t values must not contain any.
+ */
+template <typename codec_type, typename iterator_type>
+void encode_ndjson(
+    encode_context &context,
+    const codec_type &codec,
+    iterator_type begin,
+    const iterator_type end) {
+  for (; begin != end; ++begin) {
+    codec.encode(context, *begin);
+    context.append('\n');
+  }
+}
+
+template <typename codec_type, typename container_type>
+std::string encode_ndjson(const codec_type &codec, const container_type &values) {
+  encode_context context;
+  encode_ndjson(context, codec, std::begin(values), std::end(values));
+  return std::string(static_cast<const char *>(context.data()), context.size());
+}
+
+template <typename container_type>
+std::string encode_ndjson(const container_type &values) {
+  return encode_ndjson(cached_default_codec<typename container_type::value_type>(), values);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/find_array_separators.hpp>
+#include <spotify/json/detail/parallel_for.hpp>
+#include <spotify/json/parallel_options.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Group the elements between the separators into runs of about chunk_size
+ * bytes. Returns the index of the first element of each group, followed by the
+ * number of elements.
+ */
+inline std::vector<std::size_t> group_array_elements(
+    const std::vector<const char *> &separators,
+    const std::size_t chunk_size) {
+  const auto num_elements = separators.size() - 1;
+  std::vector<std::size_t> groups;
+  for (std::size_t i = 0; i < num_elements; i++) {
+    if (groups.empty() || std::size_t(separators[i] - separators[groups.back()]) >= chunk_size) {
+      groups.push_back(i);
+    }
+  }
+  groups.push_back(num_elements);
+  return groups;
+}
+
+/**
+ * Whether there is only whitespace between begin and end.
+ */
+inline bool is_blank(const char *begin, const char *end) {
+  decode_context context(begin, end);
+  skip_any_whitespace(context);
+  return (context.position == context.end);
+}
+
+}  // namespace detail
+
+/**
+ * Decode a document that is one (large) top-level array, decoding its elements
+ * on multiple threads. The element boundaries are found first by a parallel
+ * scan of the structure of the array; the elements are then decoded with the
+ * inner codec of the array_t in groups of about options.chunk_size bytes, and
+ * are finally inserted into the container in order.
+ *
+ * The result is always the same as decode(codec, data, size): if anything is
+ * wrong with the input, the document is decoded again with decode(...), which
+ * throws the same decode_exception that it would have thrown in the first place.
+ */
+template <typename T, typename inner_codec_type>
+T parallel_decode(
+    const codec::array_t<T, inner_codec_type> &codec,
+    const char *data,
+    const std::size_t size,
+    const parallel_options &options = parallel_options()) {
+  using value_type = typename inner_codec_type::object_type;
+  using inserter = detail::container_inserter<T>;
+
+  if (options.threads == 1) {
+    return decode(codec, data, size);
+  }
+
+  std::vector<const char *> separators;
+  if (!detail::find_array_separators(data, data + size, options.threads, options.chunk_size, separators)) {
+    return decode(codec, data, size);
+  }
+
+  auto is_empty = false;
+  if (separators.size() == 2) {
+    is_empty = detail::is_blank(separators[0] + 1, separators[1]);
+  }
+
+  const auto groups = detail::group_array_elements(separators, options.chunk_size);
+  const auto num_groups = (is_empty ? 0 : groups.size() - 1);
+  std::vector<std::vector<value_type>> group_values(num_groups);
+  std::vector<char> group_failed(num_groups, false);  // not vector<bool>, which is not thread safe
+
+  const auto &inner_codec = codec.inner_codec();
+  detail::parallel_for(options.threads, num_groups, [&](const std::size_t group) {
+    auto &values = group_values[group];
+    values.reserve(groups[group + 1] - groups[group]);
+    decode_context context(data, data + size);
+    try {
+      for (auto i = groups[group]; i < groups[group + 1]; i++) {
+        context.position = separators[i] + 1;
+        detail::skip_any_whitespace(context);
+        values.push_back(inner_codec.decode(context));
+        detail::skip_any_whitespace(context);
+        detail::fail_if(context, context.position != separators[i + 1], "Unexpected input after element");
+      }
+    } catch (const decode_exception &) {
+      group_failed[group] = true;
+    }
+  });
+
+  if (std::find(group_failed.begin(), group_failed.end(), true) != group_failed.end()) {
+    return decode(codec, data, size);
+  }
+
+  try {
+    decode_context context(data, data + size);
+    context.position = separators.back();
+    T output;
+    typename inserter::state state = inserter::init_state;
+    for (auto &values : group_values) {
+      for (auto &value : values) {
+        state = inserter::insert(context, state, output, std::move(value));
+      }
+    }
+    inserter::validate(context, state, output);
+    return output;
+  } catch (const decode_exception &) {
+    return decode(codec, data, size);
+  }
+}
+
+template <typename T, typename inner_codec_type>
+T parallel_decode(
+    const codec::array_t<T, inner_codec_type> &codec,
+    const std::string &string,
+    const parallel_options &options = parallel_options()) {
+  return parallel_decode(codec, string.data(), string.size(), options);
+}
+
+template <typename Value>
+Value parallel_decode(
+    const char *data,
+    const std::size_t size,
+    const parallel_options &options = parallel_options()) {
+  return parallel_decode(cached_default_codec<Value>(), data, size, options);
+}
+
+template <typename Value>
+Value parallel_decode(const std::string &string, const parallel_options &options = parallel_options()) {
+  return parallel_decode(cached_default_codec<Value>(), string, options);
+}
+
+}  // namespace json
+}  // namespace spotify
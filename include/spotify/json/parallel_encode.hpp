@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/parallel_for.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/parallel_options.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * The output of parallel_encode_segments(...): the encoded JSON as a list of
+ * segments, suitable for writev(...). The segments point into the buffers of
+ * the encode contexts that are owned by this object, and into any referenced
+ * values, which must outlive it. The brackets 'open' and 'close' are added
+ * around the contexts, unless they are null.
+ */
+class encoded_segments final {
+ public:
+  encoded_segments(
+      std::vector<std::unique_ptr<encode_context>> contexts,
+      const char *open,
+      const char *close)
+      : _contexts(std::move(contexts)) {
+    if (open) {
+      _segments.push_back(encode_segment{ open, 1 });
+    }
+    for (const auto &context : _contexts) {
+      for (const auto &segment : context->segments()) {
+        if (segment.size) {
+          _segments.push_back(segment);
+        }
+      }
+    }
+    if (close) {
+      _segments.push_back(encode_segment{ close, 1 });
+    }
+  }
+
+  const std::vector<encode_segment> &segments() const {
+    return _segments;
+  }
+
+  std::size_t size() const {
+    std::size_t size = 0;
+    for (const auto &segment : _segments) {
+      size += segment.size;
+    }
+    return size;
+  }
+
+  std::string str() const {
+    std::string output;
+    output.reserve(size());
+    for (const auto &segment : _segments) {
+      output.append(static_cast<const char *>(segment.data), segment.size);
+    }
+    return output;
+  }
+
+ private:
+  std::vector<std::unique_ptr<encode_context>> _contexts;
+  std::vector<encode_segment> _segments;
+};
+
+namespace detail {
+
+/**
+ * The number of partitions that the elements are split into per thread. More
+ * partitions than threads let the work stealing balance elements of uneven
+ * size, at the cost of one encode context per partition.
+ */
+constexpr std::size_t parallel_encode_partitions_per_thread = 8;
+
+/**
+ * Encode the elements of the container into one encode context per partition
+ * with codec.encode_elements(...), which writes each element followed by a ','.
+ * Joined together between 'open' and the closing bracket, the partitions make
+ * up exactly what codec.encode(...) would have written. The closing bracket
+ * replaces the last ',' in the last partition that is not empty, which is what
+ * the final append_or_replace(...) of a serial encoding would do. Sets close
+ * to nullptr if it was written into a partition.
+ */
+template <typename codec_type, typename container_type>
+std::vector<std::unique_ptr<encode_context>> parallel_encode_partitions(
+    const codec_type &codec,
+    const container_type &container,
+    const parallel_options &options,
+    const std::size_t reference_threshold,
+    const char *&close) {
+  using iterator_type = typename container_type::const_iterator;
+  const auto num_elements = std::size_t(std::distance(container.begin(), container.end()));
+  const auto threads = (options.threads ? options.threads : default_thread_count());
+  const auto partitions_per_thread = (threads == 1 ? 1 : parallel_encode_partitions_per_thread);
+  const auto num_partitions = std::min(num_elements, threads * partitions_per_thread);
+
+  std::vector<iterator_type> bounds;
+  bounds.reserve(num_partitions + 1);
+  bounds.push_back(container.begin());
+  for (std::size_t i = 1; i <= num_partitions; i++) {
+    const auto partition_size = num_elements * i / num_partitions - num_elements * (i - 1) / num_partitions;
+    bounds.push_back(std::next(bounds.back(), partition_size));
+  }
+
+  std::vector<std::unique_ptr<encode_context>> contexts(num_partitions);
+  parallel_for(threads, num_partitions, [&](const std::size_t i) {
+    contexts[i].reset(new encode_context());
+    contexts[i]->set_reference_threshold(reference_threshold);
+    codec.encode_elements(*contexts[i], bounds[i], bounds[i + 1]);
+  });
+
+  for (auto context = contexts.rbegin(); context != contexts.rend(); ++context) {
+    if (!(*context)->empty()) {
+      (*context)->append_or_replace(',', *close);
+      close = nullptr;
+      break;
+    }
+  }
+
+  return contexts;
+}
+
+template <typename codec_type, typename container_type>
+std::string parallel_encode(
+    const codec_type &codec,
+    const container_type &container,
+    const parallel_options &options,
+    const char *open,
+    const char *close) {
+  if (options.threads == 1) {
+    return encode(codec, container);
+  }
+
+  const auto contexts = parallel_encode_partitions(
+      codec, container, options, std::numeric_limits<std::size_t>::max(), close);
+
+  std::vector<std::size_t> offsets(contexts.size() + 1, 1);  // after the opening bracket
+  for (std::size_t i = 0; i < contexts.size(); i++) {
+    offsets[i + 1] = offsets[i] + contexts[i]->size();
+  }
+
+  std::string output(offsets.back() + (close ? 1 : 0), *open);
+  parallel_for(options.threads, contexts.size(), [&](const std::size_t i) {
+    std::memcpy(&output[offsets[i]], contexts[i]->data(), contexts[i]->size());
+  });
+  if (close) {
+    output.back() = *close;
+  }
+  return output;
+}
+
+template <typename codec_type, typename container_type>
+encoded_segments parallel_encode_segments(
+    const codec_type &codec,
+    const container_type &container,
+    const parallel_options &options,
+    const std::size_t reference_threshold,
+    const char *open,
+    const char *close) {
+  if (options.threads == 1) {
+    std::vector<std::unique_ptr<encode_context>> contexts;
+    contexts.emplace_back(new encode_context());
+    contexts.back()->set_reference_threshold(reference_threshold);
+    codec.encode(*contexts.back(), container);
+    return encoded_segments(std::move(contexts), nullptr, nullptr);
+  }
+
+  auto contexts = parallel_encode_partitions(codec, container, options, reference_threshold, close);
+  return encoded_segments(std::move(contexts), open, close);
+}
+
+}  // namespace detail
+
+/**
+ * Encode a large array on multiple threads. The elements are split into
+ * partitions that are each encoded into their own encode context, which are
+ * then joined together. The output is identical to encode(codec, array).
+ */
+template <typename T, typename inner_codec_type>
+std::string parallel_encode(
+    const codec::array_t<T, inner_codec_type> &codec,
+    const T &array,
+    const parallel_options &options = parallel_options()) {
+  return detail::parallel_encode(codec, array, options, "[", "]");
+}
+
+/**
+ * Encode a large map on multiple threads; see parallel_encode(array_t, ...).
+ */
+template <typename T, typename inner_codec_type, typename key_codec_type>
+std::string parallel_encode(
+    const codec::map_t<T, inner_codec_type, key_codec_type> &codec,
+    const T &map,
+    const parallel_options &options = parallel_options()) {
+  return detail::parallel_encode(codec, map, options, "{", "}");
+}
+
+template <typename value_type>
+std::string parallel_encode(const value_type &value, const parallel_options &options = parallel_options()) {
+  return parallel_encode(cached_default_codec<value_type>(), value, options);
+}
+
+/**
+ * Encode a large array on multiple threads, like parallel_encode(...), but
+ * leave the output in the buffers of the partitions instead of copying it into
+ * one string. Values of at least reference_threshold bytes are referenced
+ * rather than copied; see encode_context::set_reference_threshold(...). With
+ * one thread, the value is encoded with codec.encode(...) into one context.
+ */
+template <typename T, typename inner_codec_type>
+encoded_segments parallel_encode_segments(
+    const codec::array_t<T, inner_codec_type> &codec,
+    const T &array,
+    const parallel_options &options = parallel_options(),
+    const std::size_t reference_threshold = std::numeric_limits<std::size_t>::max()) {
+  return detail::parallel_encode_segments(codec, array, options, reference_threshold, "[", "]");
+}
+
+template <typename T, typename inner_codec_type, typename key_codec_type>
+encoded_segments parallel_encode_segments(
+    const codec::map_t<T, inner_codec_type, key_codec_type> &codec,
+    const T &map,
+    const parallel_options &options = parallel_options(),
+    const std::size_t reference_threshold = std::numeric_limits<std::size_t>::max()) {
+  return detail::parallel_encode_segments(codec, map, options, reference_threshold, "{", "}");
+}
+
+}  // namespace json
+}  // namespace spotify
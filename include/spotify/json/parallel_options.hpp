@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace spotify {
+namespace json {
+
+/**
+ * Tuning knobs for the parallel decoding and encoding functions. When decoding,
+ * the input is split into chunks of about chunk_size bytes, which are handed
+ * out to the threads. Smaller chunks balance the load better, larger chunks
+ * have less overhead per chunk. When encoding, the size of the output is not
+ * known up front, so the elements are instead split into a fixed number of
+ * partitions per thread.
+ */
+struct parallel_options final {
+  std::size_t threads = 0;  // zero means one thread per hardware thread
+  std::size_t chunk_size = 1024 * 1024;
+};
+
+}  // namespace json
+}  // namespace spotify
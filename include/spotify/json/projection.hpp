@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * The selected fields of an object, with the projections of their values. A
+ * field that maps to nullptr is decoded in full.
+ */
+struct projection_node {
+  std::unordered_map<std::string, std::unique_ptr<projection_node>> fields;
+};
+
+/**
+ * Sets the projection of a decode_context for as long as it lives, and then
+ * restores the previous one, also when decoding fails with an exception.
+ */
+struct projection_scope final {
+  projection_scope(decode_context &context, const projection_node *projection)
+      : _context(context),
+        _previous(context.projection) {
+    context.projection = projection;
+  }
+
+  projection_scope(const projection_scope &) = delete;
+  projection_scope &operator=(const projection_scope &) = delete;
+
+  ~projection_scope() {
+    _context.projection = _previous;
+  }
+
+ private:
+  decode_context &_context;
+  const projection_node *_previous;
+};
+
+}  // namespace detail
+
+/**
+ * A runtime selection of the fields that object_t codecs should decode. Fields
+ * that are not selected are skipped with skip_value, and are left as they were
+ * constructed, even if they are required. A projection is given as a list of
+ * field paths, such as { "id", "album/name", "tracks/uri" }, where each path
+ * selects a field and, unless a shorter path selects all of it, the fields of
+ * its value. Arrays, maps and smart pointers are transparent, so "tracks/uri"
+ * selects the "uri" field of every track in "tracks". '~' and '/' in field
+ * names are written as "~0" and "~1", as in JSON pointers.
+ *
+ * The paths are parsed once into a tree that can be used with any number of
+ * codecs and decodings, also concurrently. Throws std::invalid_argument if a
+ * path is malformed.
+ */
+class projection final {
+ public:
+  projection(std::initializer_list<std::string> paths);
+  explicit projection(const std::vector<std::string> &paths);
+
+  const detail::projection_node &root() const { return _root; }
+
+ private:
+  void add(const std::string &path);
+
+  detail::projection_node _root;
+};
+
+template <typename codec_type>
+typename codec_type::object_type decode(
+    const codec_type &codec,
+    const char *data,
+    const size_t size,
+    const projection &projection) {
+  decode_context c(data, data + size);
+  c.projection = &projection.root();
+  detail::skip_any_whitespace(c);
+  const auto result = codec.decode(c);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+  return result;
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode(
+    const codec_type &codec,
+    const std::string &string,
+    const projection &projection) {
+  return decode(codec, string.data(), string.size(), projection);
+}
+
+template <typename Value>
+Value decode(const char *data, const size_t size, const projection &projection) {
+  return decode(cached_default_codec<Value>(), data, size, projection);
+}
+
+template <typename Value>
+Value decode(const std::string &string, const projection &projection) {
+  return decode(cached_default_codec<Value>(), string, projection);
+}
+
+template <typename codec_type>
+bool try_decode(
+    typename codec_type::object_type &object,
+    const codec_type &codec,
+    const std::string &string,
+    const projection &projection) {
+  try {
+    object = decode(codec, string, projection);
+    return true;
+  } catch (const decode_exception &) {
+    return false;
+  }
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <spotify/json/extract.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+struct record_predicate {
+  virtual ~record_predicate() = default;
+  virtual bool matches(const char *data, std::size_t size) const = 0;
+};
+
+}  // namespace detail
+
+/**
+ * A predicate on the raw bytes of a JSON record, for discarding records before
+ * they are decoded. The fields that the predicate looks at are found with the
+ * skip machinery (see extract(...)), and strings are compared in place, so
+ * evaluating a predicate is much cheaper than decoding a record. Predicates
+ * are combined with !, && and ||, which evaluate their operands lazily.
+ *
+ * A record only has to be valid JSON up to the fields that are looked at; if
+ * it is not, a decode_exception is thrown. A field that is missing, or that has
+ * a value of the wrong type, does not match.
+ *
+ *   const auto filter = !field_equals("/event", "heartbeat");
+ *   if (filter(data, size)) { ... }
+ */
+class record_filter final {
+ public:
+  explicit record_filter(std::shared_ptr<const detail::record_predicate> predicate)
+      : _predicate(std::move(predicate)) {}
+
+  bool operator()(const char *data, const std::size_t size) const {
+    return _predicate->matches(data, size);
+  }
+
+  bool operator()(const std::string &string) const {
+    return _predicate->matches(string.data(), string.size());
+  }
+
+ private:
+  std::shared_ptr<const detail::record_predicate> _predicate;
+};
+
+/**
+ * Matches records where the field is a string that is equal to 'value'.
+ */
+record_filter field_equals(const json_pointer &pointer, std::string value);
+
+/**
+ * Matches records where the field is a string that starts with 'prefix'.
+ */
+record_filter field_starts_with(const json_pointer &pointer, std::string prefix);
+
+/**
+ * Matches records where the field is a number in the range [min, max].
+ */
+record_filter field_in_range(const json_pointer &pointer, double min, double max);
+
+/**
+ * Matches records where the field exists, whatever its value is, even null.
+ */
+record_filter field_exists(const json_pointer &pointer);
+
+/**
+ * Matches records that the filter does not match.
+ */
+record_filter negate(record_filter filter);
+
+/**
+ * Matches records that both filters match. 'b' is only evaluated on records
+ * that 'a' matches.
+ */
+record_filter all_of(record_filter a, record_filter b);
+
+/**
+ * Matches records that either filter matches. 'b' is only evaluated on records
+ * that 'a' does not match.
+ */
+record_filter any_of(record_filter a, record_filter b);
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/container_stack.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A string or object key, as it appears in the input, without the quotes. If
+ * the string has escape sequences, they are still escaped; str() unescapes it.
+ */
+struct sax_string final {
+  const char *data;
+  std::size_t size;
+  bool has_escapes;
+
+  std::string str() const {
+    if (json_likely(!has_escapes)) {
+      return std::string(data, size);
+    }
+
+    decode_context context(data - 1, data + size + 1);  // include the quotes
+    return codec::string_t().decode(context);
+  }
+};
+
+/**
+ * A number, as it appears in the input. as<T>() parses it like number_t<T>.
+ */
+struct sax_number final {
+  const char *data;
+  std::size_t size;
+
+  template <typename T>
+  T as() const {
+    return decode(codec::number<T>(), data, size);
+  }
+};
+
+/**
+ * A handler for sax_parse(...) that ignores all events. Handlers can derive
+ * from it and hide the functions for the events they are interested in; the
+ * calls are resolved at compile time, so ignored events cost nothing.
+ */
+struct sax_handler {
+  void start_object() {}
+  void end_object() {}
+  void start_array() {}
+  void end_array() {}
+  void key(const sax_string &key) {}
+  void string(const sax_string &value) {}
+  void number(const sax_number &value) {}
+  void boolean(bool value) {}
+  void null() {}
+};
+
+namespace detail {
+
+json_force_inline sax_string sax_read_string(decode_context &context) {
+  skip_unchecked_1(context);  // the opening '"'
+  const auto begin = context.position;
+  const auto has_escapes = skip_string_body(context);
+  return sax_string{ begin, std::size_t(context.position - begin - 1), has_escapes };
+}
+
+json_force_inline sax_number sax_read_number(decode_context &context) {
+  const auto begin = context.position;
+  skip_number(context);
+  return sax_number{ begin, std::size_t(context.position - begin) };
+}
+
+}  // namespace detail
+
+/**
+ * Parse one JSON value at the context position and push the events for it to
+ * the handler, which must have the functions of sax_handler. The input is
+ * fully validated, with the same skipping machinery that the codecs use, and
+ * a decode_exception is thrown at the first error, after the events for the
+ * input before it have been pushed. Containers are tracked on an explicit
+ * stack rather than by recursion, so any depth of nesting can be parsed. The
+ * parser does not allocate any memory, and it is an inline template so that
+ * the whole loop, handler calls included, can be inlined into the caller.
+ */
+template <typename handler_type>
+inline void sax_parse(decode_context &context, handler_type &handler) {
+  enum class expect { value, key, separator };
+  detail::container_stack stack;
+  auto state = expect::value;
+
+  for (;;) {
+    if (state == expect::value) {
+      detail::require_bytes<1>(context);
+      switch (detail::peek_unchecked(context)) {
+        case '{':
+          detail::skip_unchecked_1(context);
+          handler.start_object();
+          detail::skip_any_whitespace(context);
+          if (detail::peek(context) == '}') {
+            detail::skip_unchecked_1(context);
+            handler.end_object();
+            state = expect::separator;
+          } else {
+            stack.push(true);
+            state = expect::key;
+          }
+          break;
+        case '[':
+          detail::skip_unchecked_1(context);
+          handler.start_array();
+          detail::skip_any_whitespace(context);
+          if (detail::peek(context) == ']') {
+            detail::skip_unchecked_1(context);
+            handler.end_array();
+            state = expect::separator;
+          } else {
+            stack.push(false);
+          }
+          break;
+        case '"':
+          handler.string(detail::sax_read_string(context));
+          state = expect::separator;
+          break;
+        case 't':
+          detail::skip_true(context);
+          handler.boolean(true);
+          state = expect::separator;
+          break;
+        case 'f':
+          detail::skip_false(context);
+          handler.boolean(false);
+          state = expect::separator;
+          break;
+        case 'n':
+          detail::skip_null(context);
+          handler.null();
+          state = expect::separator;
+          break;
+        case '-':  // fallthrough
+        case '0': case '1': case '2': case '3': case '4':  // fallthrough
+        case '5': case '6': case '7': case '8': case '9':
+          handler.number(detail::sax_read_number(context));
+          state = expect::separator;
+          break;
+        default:
+          detail::fail(context, std::string("Encountered token '") + detail::peek(context) + "'");
+      }
+    } else if (state == expect::key) {
+      detail::fail_if(context, detail::peek(context) != '"', "Expected '\"'");
+      handler.key(detail::sax_read_string(context));
+      detail::skip_any_whitespace(context);
+      detail::skip_1(context, ':');
+      detail::skip_any_whitespace(context);
+      state = expect::value;
+    } else {
+      if (stack.empty()) {
+        return;
+      }
+
+      detail::skip_any_whitespace(context);
+      const auto is_object = stack.is_object();
+      const auto c = detail::next(context, is_object ? "Expected '}'" : "Expected ']'");
+      if (c == ',') {
+        detail::skip_any_whitespace(context);
+        state = (is_object ? expect::key : expect::value);
+      } else if (c == (is_object ? '}' : ']')) {
+        stack.pop();
+        if (is_object) {
+          handler.end_object();
+        } else {
+          handler.end_array();
+        }
+      } else {
+        detail::fail(context, is_object ? "Expected ',' or '}'" : "Expected ',' or ']'", -1);
+      }
+    }
+  }
+}
+
+/**
+ * Parse a whole document, which must hold exactly one JSON value.
+ */
+template <typename handler_type>
+void sax_parse(const char *data, const std::size_t size, handler_type &handler) {
+  decode_context context(data, size);
+  detail::skip_any_whitespace(context);
+  sax_parse(context, handler);
+  detail::skip_any_whitespace(context);
+  detail::fail_if(context, context.position != context.end, "Unexpected trailing input");
+}
+
+template <typename handler_type>
+void sax_parse(const std::string &string, handler_type &handler) {
+  sax_parse(string.data(), string.size(), handler);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A range of bytes in a reference counted buffer. The slice keeps the whole
+ * buffer alive, so, unlike a raw pointer into the input, it can never dangle.
+ * Copying a slice only increments the reference count.
+ *
+ * A small slice of a large buffer keeps all of the buffer in memory. When such
+ * a slice is kept for long, compact() makes a slice with a copy of just its
+ * own bytes; pinned_size() is the size of the buffer that the slice keeps
+ * alive. A default constructed slice is empty.
+ */
+class shared_slice final {
+ public:
+  shared_slice() : _size(0), _pinned_size(0) {}
+
+  shared_slice(std::shared_ptr<const char> data, std::size_t size, std::size_t pinned_size)
+      : _data(std::move(data)),
+        _size(size),
+        _pinned_size(pinned_size) {}
+
+  /**
+   * A slice with its own copy of the given bytes.
+   */
+  static shared_slice copy(const char *data, const std::size_t size) {
+    const auto string = std::make_shared<std::string>(data, size);
+    return shared_slice(std::shared_ptr<const char>(string, string->data()), size, size);
+  }
+
+  const char *data() const { return _data.get(); }
+  std::size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  std::size_t pinned_size() const { return _pinned_size; }
+
+  std::string str() const {
+    return std::string(data(), size());
+  }
+
+  shared_slice compact() const {
+    return (_pinned_size == _size ? *this : copy(data(), size()));
+  }
+
+  friend bool operator==(const shared_slice &a, const shared_slice &b) {
+    return a.size() == b.size() &&
+        (a.data() == b.data() || a.empty() || std::memcmp(a.data(), b.data(), a.size()) == 0);
+  }
+
+  friend bool operator!=(const shared_slice &a, const shared_slice &b) {
+    return !(a == b);
+  }
+
+ private:
+  std::shared_ptr<const char> _data;  // shares ownership with the whole buffer
+  std::size_t _size;
+  std::size_t _pinned_size;
+};
+
+/**
+ * An immutable, reference counted buffer of JSON input. Decoding from a
+ * shared_buffer lets shared_slice values point into the input instead of
+ * copying it.
+ */
+class shared_buffer final {
+ public:
+  explicit shared_buffer(std::string data) {
+    const auto string = std::make_shared<std::string>(std::move(data));
+    _data = std::shared_ptr<const char>(string, string->data());
+    _size = string->size();
+  }
+
+  /**
+   * A buffer with a custom owner, e.g., a memory mapped file, that is kept
+   * alive until the last slice is gone.
+   */
+  shared_buffer(std::shared_ptr<const char> data, std::size_t size)
+      : _data(std::move(data)),
+        _size(size) {}
+
+  static shared_buffer copy(const char *data, const std::size_t size) {
+    return shared_buffer(std::string(data, size));
+  }
+
+  const char *data() const { return _data.get(); }
+  std::size_t size() const { return _size; }
+
+  bool contains(const char *begin, const char *end) const {
+    return (begin >= data() && end <= data() + size());
+  }
+
+  shared_slice slice(const char *begin, const char *end) const {
+    return shared_slice(std::shared_ptr<const char>(_data, begin), end - begin, _size);
+  }
+
+ private:
+  std::shared_ptr<const char> _data;
+  std::size_t _size;
+};
+
+namespace detail {
+
+/**
+ * A slice of the shared input buffer, if there is one, or a copy otherwise.
+ */
+json_force_inline shared_slice make_slice(const decode_context &context, const char *begin, const char *end) {
+  if (json_likely(context.buffer && context.buffer->contains(begin, end))) {
+    return context.buffer->slice(begin, end);
+  }
+  return shared_slice::copy(begin, end - begin);
+}
+
+template <>
+struct make_raw_value<shared_slice> {
+  static shared_slice make(const decode_context &context, const char *begin, const char *end) {
+    return make_slice(context, begin, end);
+  }
+};
+
+}  // namespace detail
+
+namespace codec {
+
+/**
+ * A codec for strings as shared_slices. Strings without escape sequences are
+ * slices of the input; strings with escape sequences, and strings that are
+ * shorter than 'copy_below' bytes, are unescaped into (or copied to) slices of
+ * their own, so that they do not keep the input alive.
+ */
+class shared_slice_t final {
+ public:
+  using object_type = json::shared_slice;
+
+  explicit shared_slice_t(const std::size_t copy_below = 0)
+      : _copy_below(copy_below) {}
+
+  object_type decode(decode_context &context) const {
+    const auto begin = context.position;
+    detail::skip_1(context, '"');
+    const auto has_escapes = detail::skip_string_body(context);
+    const auto string_begin = begin + 1;
+    const auto string_end = context.position - 1;
+    if (json_unlikely(has_escapes)) {
+      context.position = begin;
+      const auto unescaped = string_t().decode(context);
+      return object_type::copy(unescaped.data(), unescaped.size());
+    } else if (std::size_t(string_end - string_begin) < _copy_below) {
+      return object_type::copy(string_begin, string_end - string_begin);
+    } else {
+      return detail::make_slice(context, string_begin, string_end);
+    }
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    detail::encode_string(context, value.data(), value.size());
+  }
+
+  std::size_t measure(const encode_context &context, const object_type &value) const {
+    return detail::measure_string(context, value.data(), value.size());
+  }
+
+ private:
+  std::size_t _copy_below;
+};
+
+inline shared_slice_t shared_slice(const std::size_t copy_below = 0) {
+  return shared_slice_t(copy_below);
+}
+
+}  // namespace codec
+
+namespace detail {
+
+template <>
+struct is_string_codec<codec::shared_slice_t> : std::true_type {};
+
+}  // namespace detail
+
+template <>
+struct default_codec_t<shared_slice> {
+  static codec::shared_slice_t codec() {
+    return codec::shared_slice_t();
+  }
+};
+
+/**
+ * Decode a shared buffer. shared_slice values, from shared_slice_t and
+ * raw_t<shared_slice>, point into the buffer and keep it alive.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode(const codec_type &codec, const shared_buffer &buffer) {
+  decode_context c(buffer.data(), buffer.size());
+  c.buffer = &buffer;
+  detail::skip_any_whitespace(c);
+  auto result = codec.decode(c);
+  detail::skip_any_whitespace(c);
+  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
+  return result;
+}
+
+template <typename Value>
+Value decode(const shared_buffer &buffer) {
+  return decode(cached_default_codec<Value>(), buffer);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/container_stack.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/escape.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/encode_exception.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * Writes JSON imperatively into an encode_context, for output that is not
+ * naturally held in a C++ value, such as the rows of a database cursor:
+ *
+ *   writer w(context);
+ *   w.begin_object().key("rows").begin_array();
+ *   while (cursor.next()) {
+ *     w.value(row_codec, cursor.row());
+ *   }
+ *   w.end_array().field("count", cursor.count()).end_object();
+ *
+ * Commas are written automatically, and values are written with codecs, so
+ * any existing codec can be used for subvalues. The writer checks that calls
+ * come in a valid order, and throws encode_exception if they do not; for
+ * example, every value in an object must be preceded by a key.
+ */
+class writer final {
+ public:
+  explicit writer(encode_context &context)
+      : _context(context) {}
+
+  writer(const writer &) = delete;
+  writer &operator=(const writer &) = delete;
+
+  writer &begin_object() {
+    before_value();
+    _context.append('{');
+    _stack.push(true);
+    return *this;
+  }
+
+  writer &end_object() {
+    detail::fail_if(_context, _stack.empty() || !_stack.is_object() || _has_key, "Unexpected end of object");
+    _context.append_or_replace(',', '}');
+    _stack.pop();
+    after_value();
+    return *this;
+  }
+
+  writer &begin_array() {
+    before_value();
+    _context.append('[');
+    _stack.push(false);
+    return *this;
+  }
+
+  writer &end_array() {
+    detail::fail_if(_context, _stack.empty() || _stack.is_object(), "Unexpected end of array");
+    _context.append_or_replace(',', ']');
+    _stack.pop();
+    after_value();
+    return *this;
+  }
+
+  writer &key(const char *data, const std::size_t size) {
+    detail::fail_if(_context, _stack.empty() || !_stack.is_object() || _has_key, "Unexpected key");
+    write_string(data, size);
+    _context.append(':');
+    _has_key = true;
+    return *this;
+  }
+
+  writer &key(const std::string &key) {
+    return this->key(key.data(), key.size());
+  }
+
+  writer &key(const char *key) {
+    return this->key(key, std::strlen(key));
+  }
+
+  /**
+   * Write a value with a codec.
+   */
+  template <typename codec_type>
+  writer &value(const codec_type &codec, const typename codec_type::object_type &value) {
+    before_value();
+    codec.encode(_context, value);
+    after_value();
+    return *this;
+  }
+
+  /**
+   * Write a value with its default codec.
+   */
+  template <typename value_type>
+  writer &value(const value_type &value) {
+    return this->value(cached_default_codec<value_type>(), value);
+  }
+
+  /**
+   * Write a string, without first copying it into an std::string.
+   */
+  writer &value(const char *data, const std::size_t size) {
+    before_value();
+    write_string(data, size);
+    after_value();
+    return *this;
+  }
+
+  writer &value(const char *string) {
+    return value(string, std::strlen(string));
+  }
+
+  writer &null() {
+    before_value();
+    _context.append("null", 4);
+    after_value();
+    return *this;
+  }
+
+  /**
+   * Write a key and its value; shorthand for key(name).value(...).
+   */
+  template <typename... args_type>
+  writer &field(const std::string &name, args_type &&...args) {
+    key(name);
+    return value(std::forward<args_type>(args)...);
+  }
+
+  /**
+   * Whether one complete value has been written.
+   */
+  bool is_complete() const {
+    return _is_complete;
+  }
+
+ private:
+  json_force_inline void before_value() {
+    detail::fail_if(_context, _is_complete, "A complete value has already been written");
+    if (!_stack.empty() && _stack.is_object()) {
+      detail::fail_if(_context, !_has_key, "Expected a key");
+      _has_key = false;
+    }
+  }
+
+  json_force_inline void after_value() {
+    if (json_likely(!_stack.empty())) {
+      _context.append(',');
+    } else {
+      _is_complete = true;
+    }
+  }
+
+  void write_string(const char *data, const std::size_t size) {
+    const auto begin = reinterpret_cast<const uint8_t *>(data);
+    _context.append('"');
+    detail::write_escaped(_context, begin, begin + size);
+    _context.append('"');
+  }
+
+  encode_context &_context;
+  detail::container_stack _stack;
+  bool _has_key = false;
+  bool _is_complete = false;
+};
+
+}  // namespace json
+}  // namespace spotify
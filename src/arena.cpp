@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/arena.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace spotify {
+namespace json {
+namespace {
+
+const std::size_t max_block_size = 1024 * 1024;
+const std::size_t max_allocation_size = json_size_t_max / 2;
+
+}  // namespace
+
+struct monotonic_arena::block {
+  block *next;
+  std::size_t size;
+  alignas(std::max_align_t) char data[1];
+};
+
+monotonic_arena::monotonic_arena(monotonic_arena &&other) noexcept
+    : _blocks(other._blocks),
+      _position(other._position),
+      _end(other._end),
+      _next_block_size(other._next_block_size),
+      _capacity(other._capacity) {
+  other._blocks = nullptr;
+  other._position = nullptr;
+  other._end = nullptr;
+  other._capacity = 0;
+}
+
+monotonic_arena &monotonic_arena::operator=(monotonic_arena &&other) noexcept {
+  if (this != &other) {
+    release(_blocks);
+    _blocks = other._blocks;
+    _position = other._position;
+    _end = other._end;
+    _next_block_size = other._next_block_size;
+    _capacity = other._capacity;
+    other._blocks = nullptr;
+    other._position = nullptr;
+    other._end = nullptr;
+    other._capacity = 0;
+  }
+  return *this;
+}
+
+monotonic_arena::~monotonic_arena() {
+  release(_blocks);
+}
+
+void monotonic_arena::reset() {
+  if (!_blocks) {
+    return;
+  }
+
+  release(_blocks->next);
+  _blocks->next = nullptr;
+  _position = _blocks->data;
+  _end = _blocks->data + _blocks->size;
+  _capacity = _blocks->size;
+}
+
+void *monotonic_arena::allocate_slow(const std::size_t size, const std::size_t alignment) {
+  if (size > max_allocation_size) {
+    throw std::bad_alloc();
+  }
+
+  // Oversized blocks are linked in behind the current block, so that the rest
+  // of the current block can still be used for the allocations that follow.
+  const auto padding = (alignment > alignof(std::max_align_t) ? alignment : 0);
+  const auto is_oversized = (size + padding > _next_block_size);
+  const auto block_size = (is_oversized ? size + padding : _next_block_size);
+  const auto memory = std::malloc(offsetof(block, data) + block_size);
+  if (!memory) {
+    throw std::bad_alloc();
+  }
+
+  const auto new_block = static_cast<block *>(memory);
+  new_block->size = block_size;
+  _capacity += block_size;
+
+  const auto data = reinterpret_cast<uintptr_t>(new_block->data);
+  const auto aligned = (data + alignment - 1) & ~uintptr_t(alignment - 1);
+  if (is_oversized && _blocks) {
+    new_block->next = _blocks->next;
+    _blocks->next = new_block;
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  new_block->next = _blocks;
+  _blocks = new_block;
+  _position = reinterpret_cast<char *>(aligned + size);
+  _end = new_block->data + block_size;
+  _next_block_size = std::min(_next_block_size * 2, std::max(max_block_size, _next_block_size));
+  return reinterpret_cast<void *>(aligned);
+}
+
+void monotonic_arena::release(block *first) {
+  while (first) {
+    const auto next = first->next;
+    std::free(first);
+    first = next;
+  }
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -28,7 +28,7 @@ void write_escaped_scalar(
     encode_context &context,
     const uint8_t *begin,
     const uint8_t *end) {
-  const auto buf = context.reserve(6 * (end - begin));  // 6 is the length of \u00xx
+  const auto buf = reserve_escaped(context, begin, end);
   auto ptr = buf;
 
   if (json_unaligned_2(begin) && (end - begin) >= 1) { write_escaped_1(ptr, begin); }
@@ -42,6 +42,14 @@ void write_escaped_scalar(
   context.advance(ptr - buf);
 }
 
+std::size_t escaped_size_scalar(const uint8_t *begin, const uint8_t *end) {
+  std::size_t size = 0;
+  for (; begin != end; ++begin) {
+    size += escaped_size_c(*begin);
+  }
+  return size;
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
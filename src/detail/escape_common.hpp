@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
@@ -83,6 +84,22 @@ json_force_inline void write_escaped_c(uint8_t *&out, const uint8_t c) {
   }
 }
 
+/**
+ * The number of bytes that write_escaped_c(...) writes for the character c.
+ */
+json_force_inline std::size_t escaped_size_c(const uint8_t c) {
+  if (json_likely(c >= 0x30)) {
+    return 1 + std::size_t(c == '\\');
+  }
+
+  if (json_likely(c >= 0x20)) {
+    return 1 + std::size_t(c == '"');
+  }
+
+  const auto is_popular = (c == '\b' || c == '\t' || c == '\n' || c == '\f' || c == '\r');
+  return (is_popular ? 2 : 6);
+}
+
 json_force_inline void write_escaped_1(uint8_t *&out, const uint8_t *&begin) {
   struct blob_1_t { uint8_t a; };
   const auto b = *reinterpret_cast<const blob_1_t *>(begin);
@@ -45,19 +45,27 @@ json_force_inline void write_escaped_16_sse42(uint8_t *&out, const __m128i chunk
   write_escaped_c(out, _mm_extract_epi8(chunk, 15));
 }
 
-void write_escaped_sse42(
-    encode_context &context,
-    const uint8_t *begin,
-    const uint8_t *end) {
-  const auto buf = context.reserve(6 * (end - begin));  // 6 is the length of \u00xx
-  auto out = buf;
-
+/**
+ * Check if any of the 16 bytes in the chunk needs escaping. The lengths are
+ * given explicitly so that null bytes in the chunk, which need escaping, do not
+ * terminate the comparison early.
+ */
+json_force_inline bool has_escaped_character(const __m128i chunk) {
   const __m128i ranges = _mm_setr_epi8(
-    0x01, 0x1F,  // control characters
+    0x00, 0x1F,  // control characters
     0x22, 0x22,  // double quotation mark
     0x5C, 0x5C,  // reverse solidus (backslash)
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0
   );
+  return _mm_cmpestrc(ranges, 6, chunk, 16, _SIDD_CMP_RANGES);
+}
+
+void write_escaped_sse42(
+    encode_context &context,
+    const uint8_t *begin,
+    const uint8_t *end) {
+  const auto buf = reserve_escaped(context, begin, end);
+  auto out = buf;
 
   if (json_unaligned_2(begin) && (end - begin) >= 1) { write_escaped_1(out, begin); }
   if (json_unaligned_4(begin) && (end - begin) >= 2) { write_escaped_2(out, begin); }
@@ -66,7 +74,7 @@ void write_escaped_sse42(
 
   for (; begin <= end - 16; begin += 16) {
     const __m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(begin));
-    const unsigned has_character_in_ranges = _mm_cmpistrc(ranges, chunk, _SIDD_CMP_RANGES);
+    const unsigned has_character_in_ranges = has_escaped_character(chunk);
     if (json_likely(!has_character_in_ranges)) {
       _mm_storeu_si128(reinterpret_cast<__m128i *>(out), chunk);
       out += 16;
@@ -83,6 +91,26 @@ void write_escaped_sse42(
   context.advance(out - buf);
 }
 
+std::size_t escaped_size_sse42(const uint8_t *begin, const uint8_t *end) {
+  std::size_t size = 0;
+  for (; (end - begin) >= 16; begin += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    if (json_likely(!has_escaped_character(chunk))) {
+      size += 16;
+    } else {
+      for (auto i = 0; i < 16; i++) {
+        size += escaped_size_c(begin[i]);
+      }
+    }
+  }
+
+  for (; begin != end; ++begin) {
+    size += escaped_size_c(*begin);
+  }
+
+  return size;
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
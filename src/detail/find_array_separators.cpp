@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/find_array_separators.hpp>
+
+#include <algorithm>
+#include <utility>
+
+#include <spotify/json/detail/parallel_for.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+bool is_whitespace(const char c) {
+  return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+}
+
+/**
+ * The outcome of scanning one chunk from a given quote state. Depths are
+ * relative to the depth at the start of the chunk. Only the commas and closing
+ * brackets that are at or below the starting depth are kept, since those are
+ * the only ones that can be at the top level of the array.
+ */
+struct chunk_scan final {
+  std::vector<std::pair<const char *, long>> candidates;
+  long depth = 0;
+  bool ends_in_string = false;
+};
+
+void scan_chunk(
+    const char *position,
+    const char *const end,
+    bool in_string,
+    bool escaped,
+    chunk_scan &scan) {
+  long depth = 0;
+  for (; position != end; position++) {
+    const auto c = *position;
+    if (in_string) {
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+      } else if (c == '"') {
+        in_string = false;
+      }
+      continue;
+    }
+
+    switch (c) {
+      case '"':
+        in_string = true;
+        break;
+      case '[':
+      case '{':
+        depth++;
+        break;
+      case ']':
+      case '}':
+        if (--depth < 0) {
+          scan.candidates.emplace_back(position, depth);
+        }
+        break;
+      case ',':
+        if (depth <= 0) {
+          scan.candidates.emplace_back(position, depth);
+        }
+        break;
+    }
+  }
+
+  scan.depth = depth;
+  scan.ends_in_string = in_string;
+}
+
+/**
+ * Whether the character at position is escaped, assuming that it is inside of
+ * a string: that is the case when it follows an odd number of backslashes.
+ */
+bool is_escaped(const char *position, const char *const begin) {
+  std::size_t backslashes = 0;
+  while (position != begin && *--position == '\\') {
+    backslashes++;
+  }
+  return (backslashes % 2);
+}
+
+}  // namespace
+
+bool find_array_separators(
+    const char *begin,
+    const char *end,
+    const std::size_t threads,
+    std::size_t chunk_size,
+    std::vector<const char *> &separators) {
+  while (begin != end && is_whitespace(*begin)) {
+    begin++;
+  }
+  if (begin == end || *begin != '[') {
+    return false;
+  }
+
+  const auto contents = begin + 1;
+  chunk_size = std::max<std::size_t>(chunk_size, 1);
+  const auto num_chunks = (std::size_t(end - contents) + chunk_size - 1) / chunk_size;
+  std::vector<chunk_scan> outside(num_chunks);
+  std::vector<chunk_scan> inside(num_chunks);
+  parallel_for(threads, num_chunks, [&](const std::size_t i) {
+    const auto chunk_begin = contents + i * chunk_size;
+    const auto chunk_end = chunk_begin + std::min<std::size_t>(chunk_size, end - chunk_begin);
+    scan_chunk(chunk_begin, chunk_end, false, false, outside[i]);
+    if (i != 0) {  // the first chunk is known to start outside of a string
+      scan_chunk(chunk_begin, chunk_end, true, is_escaped(chunk_begin, contents), inside[i]);
+    }
+  });
+
+  separators.clear();
+  separators.push_back(begin);
+
+  long depth = 1;
+  auto in_string = false;
+  for (std::size_t i = 0; i < num_chunks; i++) {
+    const auto &scan = (in_string ? inside[i] : outside[i]);
+    for (const auto &candidate : scan.candidates) {
+      const auto candidate_depth = depth + candidate.second;
+      if (*candidate.first == ',' && candidate_depth == 1) {
+        separators.push_back(candidate.first);
+      } else if (*candidate.first != ',' && candidate_depth == 0) {
+        separators.push_back(candidate.first);
+        return (*candidate.first == ']' && std::all_of(candidate.first + 1, end, is_whitespace));
+      }
+    }
+
+    depth += scan.depth;
+    in_string = scan.ends_in_string;
+  }
+
+  return false;  // the array is not closed
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/find_line_end.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include "find_line_end_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+const char *find_line_end_scalar(const char *begin, const char *end) {
+  auto in_string = false;
+  return find_line_end_c(begin, end, in_string);
+}
+
+std::vector<std::pair<const char *, const char *>> split_lines(
+    const char *begin,
+    const char *end,
+    std::size_t chunk_size) {
+  std::vector<std::pair<const char *, const char *>> chunks;
+  chunk_size = std::max<std::size_t>(chunk_size, 1);
+
+  while (begin != end) {
+    const auto split = begin + std::min<std::size_t>(chunk_size - 1, end - begin - 1);
+    const auto newline = static_cast<const char *>(std::memchr(split, '\n', end - split));
+    const auto chunk_end = (newline ? newline + 1 : end);
+    chunks.emplace_back(begin, chunk_end);
+    begin = chunk_end;
+  }
+
+  return chunks;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Scan [begin, end) for a '\n' outside of strings, one byte at a time. Returns
+ * end if there is none, in which case 'in_string' tells whether the scan ended
+ * inside a string. A '\' inside a string also skips the next byte.
+ */
+json_force_inline const char *find_line_end_c(const char *begin, const char *end, bool &in_string) {
+  for (auto p = begin; p < end; p++) {
+    const auto c = *p;
+    if (in_string) {
+      if (c == '\\') {
+        p++;
+      } else if (c == '"') {
+        in_string = false;
+      }
+    } else if (c == '\n') {
+      return p;
+    } else if (c == '"') {
+      in_string = true;
+    }
+  }
+  return end;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
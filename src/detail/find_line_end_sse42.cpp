@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/find_line_end.hpp>
+
+#if defined(json_arch_x86)
+
+#include <algorithm>
+
+#include <nmmintrin.h>
+
+#include "find_line_end_common.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+const char *find_line_end_sse42(const char *begin, const char *end) {
+  alignas(16) static const char CHARS[16] = "\n\"\\";
+  const auto chars = _mm_load_si128(reinterpret_cast<const __m128i *>(&CHARS[0]));
+  constexpr auto flags = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_POSITIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT;
+
+  auto in_string = false;
+  auto pos = begin;
+  while (end - pos >= 16) {
+    // The explicit length versions of the string instructions are used, since
+    // the implicit length ones would stop at '\0' bytes in the input.
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    const auto index = _mm_cmpestri(chars, 3, chunk, 16, flags);
+    if (index == 16) {
+      pos += 16;
+      continue;
+    }
+
+    pos += index;
+    switch (*pos) {
+      case '\n':
+        if (!in_string) {
+          return pos;
+        }
+        pos++;
+        break;
+      case '"':
+        in_string = !in_string;
+        pos++;
+        break;
+      default:  // '\'
+        pos += (in_string ? 2 : 1);
+        break;
+    }
+  }
+
+  return find_line_end_c(std::min(pos, end), end, in_string);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86)
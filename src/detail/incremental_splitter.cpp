@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/incremental_splitter.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+json_force_inline bool is_whitespace(const char c) {
+  return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+}
+
+json_force_inline bool is_end_of_scalar(const char c) {
+  return (is_whitespace(c) || c == ',' || c == ']' || c == '}');
+}
+
+}  // namespace
+
+incremental_splitter::incremental_splitter(const char open)
+    : _open(open),
+      _close(open == '{' ? '}' : ']') {}
+
+void incremental_splitter::finish() const {
+  if (json_unlikely(_state != state::done)) {
+    throw decode_exception("Unexpected end of input", _chunk_offset);
+  }
+}
+
+void incremental_splitter::reset() {
+  _state = state::before_open;
+  _is_escaped = false;
+  _depth = 0;
+  _chunk_offset = 0;
+  _element_offset = 0;
+  _buffer.clear();
+}
+
+void incremental_splitter::fail(const char *position, const char *error) const {
+  throw decode_exception(error, _chunk_offset + (position - _chunk));
+}
+
+const char *incremental_splitter::scan_string(
+    const char *position,
+    const char *end,
+    bool &is_closed) {
+  for (; position != end; position++) {
+    if (json_unlikely(_is_escaped)) {
+      _is_escaped = false;
+    } else if (*position == '\\') {
+      _is_escaped = true;
+    } else if (*position == '"') {
+      is_closed = true;
+      return position + 1;
+    }
+  }
+  return position;
+}
+
+incremental_splitter::event incremental_splitter::scan(const char *&position, const char *end) {
+  auto p = position;
+  while (p != end) {
+    const auto c = *p;
+    switch (_state) {
+      case state::before_open:
+        if (json_unlikely(c != _open && !is_whitespace(c))) {
+          fail(p, _open == '[' ? "Unexpected input, expected '['" : "Unexpected input, expected '{'");
+        }
+        _state = (c == _open ? state::after_open : state::before_open);
+        p++;
+        break;
+
+      case state::after_open:
+      case state::before_element:
+        if (is_whitespace(c)) {
+          p++;
+        } else if (c == _close && _state == state::after_open) {
+          _state = state::done;
+          p++;
+        } else {
+          _state = (_open == '{' ? state::key_begin : state::value_begin);
+          position = p;
+          return event::element_begin;
+        }
+        break;
+
+      case state::key_begin:
+        if (json_unlikely(c != '"')) {
+          fail(p, "Unexpected input, expected '\"'");
+        }
+        _state = state::key;
+        p++;
+        break;
+
+      case state::key: {
+        auto is_closed = false;
+        p = scan_string(p, end, is_closed);
+        _state = (is_closed ? state::after_key : state::key);
+        break;
+      }
+
+      case state::after_key:
+        if (json_unlikely(c != ':' && !is_whitespace(c))) {
+          fail(p, "Unexpected input, expected ':'");
+        }
+        _state = (c == ':' ? state::value_begin : state::after_key);
+        p++;
+        break;
+
+      case state::value_begin:
+        if (is_whitespace(c)) {
+          p++;
+          break;
+        }
+
+        switch (c) {
+          case '"': _state = state::string_value; break;
+          case '[': _state = state::nested_value; _depth = 1; break;
+          case '{': _state = state::nested_value; _depth = 1; break;
+          case ']': fail(p, "Unexpected input");
+          case '}': fail(p, "Unexpected input");
+          case ',': fail(p, "Unexpected input");
+          case ':': fail(p, "Unexpected input");
+          default: _state = state::scalar_value; break;
+        }
+        p++;
+        break;
+
+      case state::string_value: {
+        auto is_closed = false;
+        p = scan_string(p, end, is_closed);
+        if (is_closed) {
+          _state = state::after_element;
+          position = p;
+          return event::element_end;
+        }
+        break;
+      }
+
+      case state::nested_value:
+        for (; p != end; p++) {
+          const auto n = *p;
+          if (n == '"') {
+            _state = state::nested_string;
+            p++;
+            break;
+          } else if (n == '[' || n == '{') {
+            _depth++;
+          } else if ((n == ']' || n == '}') && --_depth == 0) {
+            _state = state::after_element;
+            position = p + 1;
+            return event::element_end;
+          }
+        }
+        break;
+
+      case state::nested_string: {
+        auto is_closed = false;
+        p = scan_string(p, end, is_closed);
+        _state = (is_closed ? state::nested_value : state::nested_string);
+        break;
+      }
+
+      case state::scalar_value:
+        while (p != end && !is_end_of_scalar(*p)) {
+          p++;
+        }
+        if (p != end) {
+          _state = state::after_element;
+          position = p;
+          return event::element_end;
+        }
+        break;
+
+      case state::after_element:
+        if (c == ',') {
+          _state = state::before_element;
+        } else if (c == _close) {
+          _state = state::done;
+        } else if (json_unlikely(!is_whitespace(c))) {
+          fail(p, _close == ']' ? "Unexpected input, expected ',' or ']'" : "Unexpected input, expected ',' or '}'");
+        }
+        p++;
+        break;
+
+      case state::done:
+        if (json_unlikely(!is_whitespace(c))) {
+          fail(p, "Unexpected trailing input");
+        }
+        p++;
+        break;
+    }
+  }
+
+  position = p;
+  return event::need_more_input;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/detail/parallel_for.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+/**
+ * The indexes [begin, end) that are left for one participant of a run, packed
+ * into one atomic word so that taking and stealing indexes does not need any
+ * locks. The owner takes indexes from the front and thieves take half of the
+ * remaining ones from the back. The padding keeps the ranges of different
+ * participants on different cache lines.
+ */
+struct task_range final {
+  std::atomic<uint64_t> packed;
+  char padding[64 - sizeof(std::atomic<uint64_t>)];
+
+  static uint64_t pack(const uint64_t begin, const uint64_t end) {
+    return (begin << 32) | end;
+  }
+
+  void assign(const std::size_t begin, const std::size_t end) {
+    packed.store(pack(begin, end), std::memory_order_release);
+  }
+
+  bool pop(std::size_t &index) {
+    auto range = packed.load(std::memory_order_acquire);
+    for (;;) {
+      const auto begin = range >> 32;
+      const auto end = range & 0xFFFFFFFF;
+      if (begin == end) {
+        return false;
+      }
+      if (packed.compare_exchange_weak(range, pack(begin + 1, end), std::memory_order_acq_rel)) {
+        index = begin;
+        return true;
+      }
+    }
+  }
+
+  bool steal_into(task_range &thief) {
+    auto range = packed.load(std::memory_order_acquire);
+    for (;;) {
+      const auto begin = range >> 32;
+      const auto end = range & 0xFFFFFFFF;
+      if (begin == end) {
+        return false;
+      }
+      const auto middle = end - (end - begin + 1) / 2;
+      if (packed.compare_exchange_weak(range, pack(begin, middle), std::memory_order_acq_rel)) {
+        thief.assign(middle, end);  // only the (idle) thief itself writes its range
+        return true;
+      }
+    }
+  }
+};
+
+/**
+ * One call to parallel_for(...). The calling thread is the first participant;
+ * pool workers join as the other participants when they are free. A run does
+ * not depend on any worker joining, since the participants that do steal the
+ * indexes of the ones that do not.
+ */
+class parallel_run final {
+ public:
+  parallel_run(
+      const std::size_t participants,
+      const std::size_t num_tasks,
+      const std::function<void (std::size_t)> &task)
+      : _participants(participants),
+        _ranges(new task_range[participants]),
+        _task(task) {
+    for (std::size_t i = 0; i < participants; i++) {
+      _ranges[i].assign(num_tasks * i / participants, num_tasks * (i + 1) / participants);
+    }
+  }
+
+  /**
+   * Run tasks on the calling thread until there are none left, then wait for
+   * the workers that joined to finish theirs, and rethrow the first error.
+   */
+  void run() {
+    work(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _closed = true;
+    _idle.wait(lock, [this]{ return _active == 0; });
+    if (_error) {
+      std::rethrow_exception(_error);
+    }
+  }
+
+  /**
+   * Called by a pool worker to join the run, unless it is already over.
+   */
+  void help() {
+    std::size_t participant;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_closed || _joined == _participants) {
+        return;
+      }
+      participant = _joined++;
+      _active++;
+    }
+
+    work(participant);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (--_active == 0) {
+      _idle.notify_all();
+    }
+  }
+
+ private:
+  void work(const std::size_t participant) {
+    auto &own = _ranges[participant];
+    std::size_t index;
+    while (!_failed.load(std::memory_order_relaxed)) {
+      if (own.pop(index)) {
+        execute(index);
+      } else if (!steal(participant)) {
+        return;
+      }
+    }
+  }
+
+  void execute(const std::size_t index) {
+    try {
+      _task(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_error) {
+        _error = std::current_exception();
+      }
+      _failed = true;
+    }
+  }
+
+  bool steal(const std::size_t participant) {
+    for (std::size_t i = 1; i < _participants; i++) {
+      if (_ranges[(participant + i) % _participants].steal_into(_ranges[participant])) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const std::size_t _participants;
+  std::unique_ptr<task_range[]> _ranges;
+  const std::function<void (std::size_t)> &_task;
+  std::atomic<bool> _failed{ false };
+
+  std::mutex _mutex;
+  std::condition_variable _idle;
+  std::size_t _joined = 1;  // the calling thread
+  std::size_t _active = 0;
+  bool _closed = false;
+  std::exception_ptr _error;
+};
+
+/**
+ * The process wide pool of worker threads. Threads are started the first time
+ * they are needed and then kept, so parallel_for(...) does not pay for thread
+ * creation. Runs wait in a queue until enough workers have picked them up.
+ */
+class thread_pool final {
+ public:
+  static thread_pool &instance() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopping = true;
+    }
+    _wakeup.notify_all();
+    for (auto &worker : _workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * Queue the run for up to 'helpers' workers. The pool never grows past
+   * max_thread_count() - 1 workers, so that a single call with a large thread
+   * count does not leave idle threads behind for the rest of the process. The
+   * run completes with fewer helpers, since the participants that join steal
+   * the indexes of those that do not.
+   */
+  void submit(const std::shared_ptr<parallel_run> &run, std::size_t helpers) {
+    helpers = std::min(helpers, max_thread_count() - 1);
+    if (helpers == 0) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      try {
+        while (_workers.size() < helpers) {
+          _workers.emplace_back([this]{ work(); });
+        }
+      } catch (...) {
+        // Could not start more threads; the run works with fewer helpers.
+      }
+      _queue.push_back(queued_run{ run, helpers });
+    }
+    _wakeup.notify_all();
+  }
+
+  void withdraw(const std::shared_ptr<parallel_run> &run) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _queue.erase(
+        std::remove_if(_queue.begin(), _queue.end(), [&](const queued_run &queued) {
+          return queued.run == run;
+        }),
+        _queue.end());
+  }
+
+ private:
+  struct queued_run {
+    std::shared_ptr<parallel_run> run;
+    std::size_t helpers;
+  };
+
+  thread_pool() = default;
+
+  void work() {
+    for (;;) {
+      std::shared_ptr<parallel_run> run;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wakeup.wait(lock, [this]{ return _stopping || !_queue.empty(); });
+        if (_stopping) {
+          return;
+        }
+
+        auto &front = _queue.front();
+        run = front.run;
+        if (--front.helpers == 0) {
+          _queue.pop_front();
+        }
+      }
+      run->help();
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _wakeup;
+  std::deque<queued_run> _queue;
+  std::vector<std::thread> _workers;
+  bool _stopping = false;
+};
+
+/**
+ * The indexes of a run are packed into 32 bits each; larger loops are run in
+ * batches.
+ */
+constexpr std::size_t max_tasks_per_run = std::numeric_limits<uint32_t>::max();
+
+void run_in_pool(
+    const std::size_t threads,
+    const std::size_t num_tasks,
+    const std::function<void (std::size_t)> &task) {
+  const auto run = std::make_shared<parallel_run>(threads, num_tasks, task);
+  auto &pool = thread_pool::instance();
+  pool.submit(run, threads - 1);
+  try {
+    run->run();
+  } catch (...) {
+    pool.withdraw(run);
+    throw;
+  }
+  pool.withdraw(run);
+}
+
+}  // namespace
+
+std::size_t default_thread_count() {
+  return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+std::size_t max_thread_count() {
+  return std::max<std::size_t>(default_thread_count(), 8);
+}
+
+void parallel_for(
+    std::size_t threads,
+    const std::size_t num_tasks,
+    const std::function<void (std::size_t)> &task) {
+  threads = std::min(threads ? threads : default_thread_count(), num_tasks);
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < num_tasks; i++) {
+      task(i);
+    }
+    return;
+  }
+
+  for (std::size_t offset = 0; offset < num_tasks; offset += max_tasks_per_run) {
+    const auto batch = std::min(num_tasks - offset, max_tasks_per_run);
+    if (offset == 0 && batch == num_tasks) {
+      run_in_pool(threads, num_tasks, task);
+    } else {
+      run_in_pool(threads, batch, [&](const std::size_t index) { task(offset + index); });
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -27,88 +27,6 @@ namespace json {
 namespace detail {
 namespace {
 
-json_force_inline bool is_digit(const char c) {
-  return (c >= '0' && c <= '9');
-}
-
-json_force_inline bool is_hex_digit(const char c) {
-  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
-}
-
-void skip_unicode_escape(decode_context &context) {
-  require_bytes<4>(context, "\\u must be followed by 4 hex digits");
-  const bool h0 = is_hex_digit(*(context.position++));
-  const bool h1 = is_hex_digit(*(context.position++));
-  const bool h2 = is_hex_digit(*(context.position++));
-  const bool h3 = is_hex_digit(*(context.position++));
-  fail_if(context, !(h0 && h1 && h2 && h3), "\\u must be followed by 4 hex digits");
-}
-
-void skip_escape(decode_context &context) {
-  switch (next(context, "Unterminated string")) {
-    case '"':  break;
-    case '/':  break;
-    case 'b':  break;
-    case 'f':  break;
-    case 'n':  break;
-    case 'r':  break;
-    case 't':  break;
-    case '\\': break;
-    case 'u': skip_unicode_escape(context); break;
-    default: detail::fail(context, "Invalid escape character", -1);
-  }
-}
-
-void skip_string(decode_context &context) {
-  skip_1(context, '"');
-
-  while (json_likely(context.remaining())) {
-    detail::skip_any_simple_characters(context);
-    switch (next(context, "Unterminated string")) {
-      case '"': return;
-      case '\\': skip_escape(context); break;
-      default: json_unreachable();
-    }
-  }
-
-  detail::fail(context, "Unterminated string");
-}
-
-void skip_number(decode_context &context) {
-  // Parse negative sign
-  if (peek(context) == '-') {
-    ++context.position;
-  }
-
-  // Parse integer part
-  if (peek(context) == '0') {
-    ++context.position;
-  } else {
-    fail_if(context, !is_digit(peek(context)), "Expected digit");
-    do { ++context.position; } while (is_digit(peek(context)));
-  }
-
-  // Parse fractional part
-  if (peek(context) == '.') {
-    ++context.position;
-    fail_if(context, !is_digit(peek(context)), "Expected digit after decimal point");
-    do { ++context.position; } while (is_digit(peek(context)));
-  }
-
-  // Parse exp part
-  const char maybe_e = peek(context);
-  if (maybe_e == 'e' || maybe_e == 'E') {
-    ++context.position;
-    const char maybe_plus_minus = peek(context);
-    if (maybe_plus_minus == '+' || maybe_plus_minus == '-') {
-      ++context.position;
-    }
-
-    fail_if(context, !is_digit(peek(context)), "Expected digit after exponent sign");
-    do { ++context.position; } while (is_digit(peek(context)));
-  }
-}
-
 /**
  * Advance past one simple JSON value, that is any value that is not an object
  * {} or an array []. If parsing fails, context will be set to that it has
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/document_index.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+
+namespace spotify {
+namespace json {
+namespace {
+
+using detail::index_node;
+
+struct key_ref {
+  const char *data;
+  std::size_t size;
+};
+
+bool operator<(const key_ref &a, const key_ref &b) {
+  const auto result = std::memcmp(a.data, b.data, std::min(a.size, b.size));
+  return (result < 0 || (result == 0 && a.size < b.size));
+}
+
+key_ref key_of(const index_node &node, const char *data, const std::string &escaped_keys) {
+  if (node.key_size & index_node::escaped_key) {
+    return key_ref{ escaped_keys.data() + node.key_begin, node.key_size & ~index_node::escaped_key };
+  } else {
+    return key_ref{ data + node.key_begin, node.key_size };
+  }
+}
+
+}  // namespace
+
+constexpr uint32_t detail::index_node::not_indexed;
+constexpr uint32_t detail::index_node::escaped_key;
+constexpr std::size_t document_index::default_max_depth;
+
+/**
+ * Builds the nodes of an index in a single pass over the document. The nodes
+ * of the children of the containers that are being indexed are collected on a
+ * stack, and are moved to the index, next to each other, when the container
+ * ends. The root node is therefore the last node of the index.
+ */
+class document_index::builder final {
+ public:
+  builder(document_index &index, const std::size_t max_depth)
+      : _index(index),
+        _max_depth(max_depth),
+        _context(index._data, index._size) {}
+
+  void build() {
+    detail::skip_any_whitespace(_context);
+    const auto root = index_value(0);
+    detail::skip_any_whitespace(_context);
+    detail::fail_if(_context, _context.position != _context.end, "Unexpected trailing input");
+    _index._nodes.push_back(root);
+    _index._nodes.shrink_to_fit();
+  }
+
+ private:
+  uint32_t offset() const {
+    return uint32_t(_context.offset());
+  }
+
+  index_node index_value(const std::size_t depth) {
+    auto node = index_node{ offset(), 0, 0, 0, 0, 0 };
+    const auto c = detail::peek(_context);
+    const auto is_container = (c == '{' || c == '[');
+    if (is_container && depth < _max_depth) {
+      index_children(node, c, depth + 1);
+    } else {
+      detail::skip_value(_context);
+      node.first_child = (is_container ? index_node::not_indexed : 0);
+    }
+
+    node.end = offset();
+    return node;
+  }
+
+  void index_children(index_node &node, const char intro, const std::size_t depth) {
+    const auto is_object = (intro == '{');
+    const auto outro = char(intro + 2);  // '{' + 2 == '}', '[' + 2 == ']'
+    const auto mark = _stack.size();
+
+    detail::decode_comma_separated(_context, intro, outro, [&]{
+      if (is_object) {
+        const auto key = index_key();
+        detail::skip_any_whitespace(_context);
+        detail::skip_1(_context, ':');
+        detail::skip_any_whitespace(_context);
+        auto child = index_value(depth);
+        child.key_begin = key.key_begin;
+        child.key_size = key.key_size;
+        _stack.push_back(child);
+      } else {
+        _stack.push_back(index_value(depth));
+      }
+    });
+
+    auto &nodes = _index._nodes;
+    node.first_child = uint32_t(nodes.size());
+    node.num_children = uint32_t(_stack.size() - mark);
+    nodes.insert(nodes.end(), _stack.begin() + mark, _stack.end());
+    _stack.resize(mark);
+
+    if (is_object) {
+      const auto data = _index._data;
+      const auto &escaped_keys = _index._escaped_keys;
+      std::stable_sort(nodes.begin() + node.first_child, nodes.end(), [&](const index_node &a, const index_node &b) {
+        return key_of(a, data, escaped_keys) < key_of(b, data, escaped_keys);
+      });
+    }
+  }
+
+  index_node index_key() {
+    const auto begin = _context.position;
+    detail::skip_1(_context, '"');
+    detail::skip_any_simple_characters(_context);
+    if (json_likely(detail::next(_context, "Unterminated string") == '"')) {
+      const auto key_begin = uint32_t(begin + 1 - _context.begin);
+      return index_node{ 0, 0, key_begin, uint32_t(_context.position - begin - 2), 0, 0 };
+    }
+
+    _context.position = begin;
+    const auto key = codec::string_t().decode(_context);
+    const auto key_begin = uint32_t(_index._escaped_keys.size());
+    _index._escaped_keys.append(key);
+    return index_node{ 0, 0, key_begin, uint32_t(key.size()) | index_node::escaped_key, 0, 0 };
+  }
+
+  document_index &_index;
+  const std::size_t _max_depth;
+  decode_context _context;
+  std::vector<index_node> _stack;
+};
+
+document_index::document_index(const char *data, const std::size_t size, const std::size_t max_depth)
+    : _data(data),
+      _size(size) {
+  if (size >= index_node::not_indexed) {
+    throw std::length_error("Document is too large to be indexed");
+  }
+
+  builder(*this, max_depth).build();
+}
+
+bool document_index::find(const json_pointer &pointer, codec::raw_ref &value) const {
+  const auto &tokens = pointer.tokens();
+  auto node = uint32_t(_nodes.size() - 1);
+  for (auto token = tokens.begin(); token != tokens.end(); ++token) {
+    const auto &parent = _nodes[node];
+    if (parent.first_child == index_node::not_indexed) {
+      decode_context context(_data + parent.begin, _data + _size);
+      if (!detail::find_tokens(context, token, tokens.end())) {
+        return false;
+      }
+
+      const auto begin = context.position;
+      detail::skip_value(context);
+      value = codec::raw_ref(begin, context.position);
+      return true;
+    }
+
+    const auto is_found = (_data[parent.begin] == '{' ?
+        find_member(parent, *token, node) :
+        find_element(parent, *token, node));
+    if (!is_found) {
+      return false;
+    }
+  }
+
+  value = codec::raw_ref(_data + _nodes[node].begin, _data + _nodes[node].end);
+  return true;
+}
+
+bool document_index::find_member(const index_node &node, const std::string &token, uint32_t &child) const {
+  const auto begin = _nodes.begin() + node.first_child;
+  const auto end = begin + node.num_children;
+  const auto key = key_ref{ token.data(), token.size() };
+  const auto it = std::lower_bound(begin, end, key, [&](const index_node &member, const key_ref &key) {
+    return key_of(member, _data, _escaped_keys) < key;
+  });
+
+  if (it == end || key < key_of(*it, _data, _escaped_keys)) {
+    return false;
+  }
+
+  child = uint32_t(it - _nodes.begin());
+  return true;
+}
+
+bool document_index::find_element(const index_node &node, const std::string &token, uint32_t &child) const {
+  const auto index = detail::parse_array_index(token);
+  if (index >= node.num_children) {
+    return false;
+  }
+
+  child = uint32_t(node.first_child + index);
+  return true;
+}
+
+}  // namespace json
+}  // namespace spotify
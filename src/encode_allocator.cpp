@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/encode_allocator.hpp>
+
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif  // defined(__linux__)
+
+namespace spotify {
+namespace json {
+namespace {
+
+#if defined(__linux__)
+
+const std::size_t huge_page_size = 2 * 1024 * 1024;
+
+std::size_t round_to_huge_pages(const std::size_t capacity) {
+  return (capacity + huge_page_size - 1) & ~(huge_page_size - 1);
+}
+
+void advise_huge_pages(void *ptr, const std::size_t mapped_size) {
+#if defined(MADV_HUGEPAGE)
+  madvise(ptr, mapped_size, MADV_HUGEPAGE);  // only a hint, failure is fine
+#endif  // defined(MADV_HUGEPAGE)
+}
+
+void *map_huge(const std::size_t capacity) {
+  const auto mapped_size = round_to_huge_pages(capacity);
+  const auto ptr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    return nullptr;
+  }
+
+  advise_huge_pages(ptr, mapped_size);
+  return ptr;
+}
+
+void *remap_huge(void *ptr, const std::size_t old_capacity, const std::size_t new_capacity) {
+  const auto old_mapped_size = round_to_huge_pages(old_capacity);
+  const auto new_mapped_size = round_to_huge_pages(new_capacity);
+  if (new_mapped_size == old_mapped_size) {
+    return ptr;
+  }
+
+  const auto new_ptr = mremap(ptr, old_mapped_size, new_mapped_size, MREMAP_MAYMOVE);
+  if (new_ptr == MAP_FAILED) {
+    return nullptr;
+  }
+
+  advise_huge_pages(new_ptr, new_mapped_size);
+  return new_ptr;
+}
+
+void unmap_huge(void *ptr, const std::size_t capacity) {
+  munmap(ptr, round_to_huge_pages(capacity));
+}
+
+#endif  // defined(__linux__)
+
+}  // namespace
+
+void *huge_page_encode_allocator::allocate(std::size_t capacity) {
+#if defined(__linux__)
+  if (is_huge(capacity)) {
+    return map_huge(capacity);
+  }
+#endif  // defined(__linux__)
+  return std::malloc(capacity);
+}
+
+void *huge_page_encode_allocator::reallocate(
+    void *ptr,
+    std::size_t size,
+    std::size_t old_capacity,
+    std::size_t new_capacity) {
+#if defined(__linux__)
+  if (is_huge(old_capacity) && is_huge(new_capacity)) {
+    return remap_huge(ptr, old_capacity, new_capacity);
+  }
+
+  if (is_huge(old_capacity) || is_huge(new_capacity)) {
+    return encode_allocator::reallocate(ptr, size, old_capacity, new_capacity);
+  }
+#endif  // defined(__linux__)
+  return std::realloc(ptr, new_capacity);
+}
+
+void huge_page_encode_allocator::deallocate(void *ptr, std::size_t capacity) {
+#if defined(__linux__)
+  if (is_huge(capacity)) {
+    if (ptr) {
+      unmap_huge(ptr, capacity);
+    }
+    return;
+  }
+#endif  // defined(__linux__)
+  std::free(ptr);
+}
+
+}  // namespace json
+}  // namespace spotify
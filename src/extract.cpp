@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/extract.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+namespace {
+
+const auto npos = std::numeric_limits<std::size_t>::max();
+
+json_force_inline bool operator==(const string_chars &key, const std::string &token) {
+  return (key.size == token.size() && std::memcmp(key.data, token.data(), key.size) == 0);
+}
+
+/**
+ * Read past an object key and the ':' that follows it. The key points into
+ * the input, or into 'scratch'; see read_string_chars(...).
+ */
+string_chars read_key(decode_context &context, std::string &scratch) {
+  const auto key = read_string_chars(context, scratch);
+  skip_any_whitespace(context);
+  skip_1(context, ':');
+  skip_any_whitespace(context);
+  return key;
+}
+
+/**
+ * Read past the separator after an object member or array element. Returns
+ * false if the container ended instead.
+ */
+bool next_member(decode_context &context, const char closer, const char *error) {
+  skip_any_whitespace(context);
+  const auto c = next(context);
+  if (c == closer) {
+    return false;
+  }
+
+  fail_if(context, c != ',', error, -1);
+  skip_any_whitespace(context);
+  return true;
+}
+
+bool find_member(decode_context &context, const std::string &token, std::string &scratch) {
+  skip_1(context, '{');
+  skip_any_whitespace(context);
+  if (peek(context) == '}') {
+    return false;
+  }
+
+  do {
+    if (read_key(context, scratch) == token) {
+      return true;
+    }
+    skip_value(context);
+  } while (next_member(context, '}', "Expected ',' or '}'"));
+  return false;
+}
+
+bool find_element(decode_context &context, const std::size_t index) {
+  skip_1(context, '[');
+  skip_any_whitespace(context);
+  if (index == npos || peek(context) == ']') {
+    return false;
+  }
+
+  auto i = std::size_t(0);
+  do {
+    if (i++ == index) {
+      return true;
+    }
+    skip_value(context);
+  } while (next_member(context, ']', "Expected ',' or ']'"));
+  return false;
+}
+
+bool find_token(decode_context &context, const std::string &token, std::string &scratch) {
+  switch (peek(context)) {
+    case '{': return find_member(context, token, scratch);
+    case '[': return find_element(context, parse_array_index(token));
+    default: return false;
+  }
+}
+
+/**
+ * The nodes that have been entered during one extraction. The bits are kept
+ * inline for extractors with up to 256 nodes, so that extracting from a
+ * document does not allocate anything.
+ */
+class node_set final {
+ public:
+  explicit node_set(const std::size_t size) {
+    if (json_unlikely(size > inline_capacity)) {
+      _heap.resize((size + 63) / 64);
+    }
+  }
+
+  /**
+   * Add the node to the set. Returns false if it was already in the set.
+   */
+  bool insert(const std::size_t node) {
+    auto &word = (_heap.empty() ? _inline[node / 64] : _heap[node / 64]);
+    const auto bit = uint64_t(1) << (node % 64);
+    const auto is_new = !(word & bit);
+    word |= bit;
+    return is_new;
+  }
+
+ private:
+  static constexpr std::size_t inline_capacity = 256;
+  std::array<uint64_t, inline_capacity / 64> _inline = {};
+  std::vector<uint64_t> _heap;
+};
+
+struct extract_state {
+  const std::vector<extract_node> &nodes;
+  const std::vector<std::shared_ptr<const extract_target>> &targets;
+  node_set entered;
+  std::size_t remaining;
+  std::string scratch;
+};
+
+bool walk(decode_context &context, extract_state &state, const extract_node &node);
+
+/**
+ * Walk the members of an object, entering the ones that match a child of the
+ * node and skipping the others. Returns true once all targets have been found.
+ */
+bool walk_object(decode_context &context, extract_state &state, const extract_node &node) {
+  skip_1(context, '{');
+  skip_any_whitespace(context);
+  if (peek(context) == '}') {
+    skip_unchecked_1(context);
+    return false;
+  }
+
+  do {
+    const auto key = read_key(context, state.scratch);
+    const extract_node *match = nullptr;
+    for (const auto child : node.children) {
+      if (key == state.nodes[child].token) {
+        match = &state.nodes[child];
+        break;
+      }
+    }
+
+    if (!match) {
+      skip_value(context);
+    } else if (walk(context, state, *match)) {
+      return true;
+    }
+  } while (next_member(context, '}', "Expected ',' or '}'"));
+  return false;
+}
+
+/**
+ * Like walk_object, for the elements of an array.
+ */
+bool walk_array(decode_context &context, extract_state &state, const extract_node &node) {
+  skip_1(context, '[');
+  skip_any_whitespace(context);
+  if (peek(context) == ']') {
+    skip_unchecked_1(context);
+    return false;
+  }
+
+  auto i = std::size_t(0);
+  do {
+    const extract_node *match = nullptr;
+    for (const auto child : node.children) {
+      if (state.nodes[child].index == i) {
+        match = &state.nodes[child];
+        break;
+      }
+    }
+
+    if (!match) {
+      skip_value(context);
+    } else if (walk(context, state, *match)) {
+      return true;
+    }
+    i++;
+  } while (next_member(context, ']', "Expected ',' or ']'"));
+  return false;
+}
+
+/**
+ * Decode the targets of the node from the value at the context position, and
+ * then walk into the value for the children of the node. Afterwards, the
+ * context is positioned after the value. Each node is only entered once, so
+ * later occurrences of a duplicate key are skipped, like in find_tokens.
+ * Returns true once all targets have been found, in which case the rest of the
+ * document is left unread.
+ */
+bool walk(decode_context &context, extract_state &state, const extract_node &node) {
+  if (!state.entered.insert(std::size_t(&node - state.nodes.data()))) {
+    skip_value(context);
+    return false;
+  }
+
+  const auto begin = context.position;
+  for (const auto target : node.targets) {
+    context.position = begin;
+    state.targets[target]->decode(context);
+    state.remaining--;
+  }
+  const auto is_consumed = !node.targets.empty();
+
+  if (state.remaining == 0) {
+    return true;
+  }
+
+  if (node.children.empty()) {
+    if (!is_consumed) {
+      skip_value(context);
+    }
+    return false;
+  }
+
+  context.position = begin;
+  switch (peek(context)) {
+    case '{': return walk_object(context, state, node);
+    case '[': return walk_array(context, state, node);
+    default: skip_value(context); return false;
+  }
+}
+
+}  // namespace
+
+std::size_t parse_array_index(const std::string &token) {
+  if (token.empty() || token.size() > 18 || (token[0] == '0' && token.size() > 1)) {
+    return npos;
+  }
+
+  auto index = std::size_t(0);
+  for (const auto c : token) {
+    if (c < '0' || c > '9') {
+      return npos;
+    }
+    index = index * 10 + (c - '0');
+  }
+  return index;
+}
+
+bool find_pointer(decode_context &context, const json_pointer &pointer) {
+  return find_tokens(context, pointer.tokens().begin(), pointer.tokens().end());
+}
+
+bool find_tokens(
+    decode_context &context,
+    std::vector<std::string>::const_iterator begin,
+    std::vector<std::string>::const_iterator end) {
+  std::string scratch;
+  skip_any_whitespace(context);
+  for (auto token = begin; token != end; ++token) {
+    const auto value = context.position;
+    if (!find_token(context, *token, scratch)) {
+      context.position = value;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace detail
+
+json_pointer::json_pointer(const char *pointer)
+    : json_pointer(std::string(pointer)) {}
+
+json_pointer::json_pointer(std::string pointer)
+    : _pointer(std::move(pointer)) {
+  if (_pointer.empty()) {
+    return;
+  }
+
+  if (_pointer[0] != '/') {
+    throw std::invalid_argument("JSON pointer must start with '/': " + _pointer);
+  }
+
+  for (std::size_t i = 0; i < _pointer.size(); i++) {
+    const auto c = _pointer[i];
+    if (c == '/') {
+      _tokens.emplace_back();
+    } else if (c == '~') {
+      const auto escaped = (i + 1 < _pointer.size() ? _pointer[++i] : '\0');
+      if (escaped != '0' && escaped != '1') {
+        throw std::invalid_argument("JSON pointer has invalid escape sequence: " + _pointer);
+      }
+      _tokens.back().push_back(escaped == '0' ? '~' : '/');
+    } else {
+      _tokens.back().push_back(c);
+    }
+  }
+}
+
+extractor::extractor()
+    : _nodes(1, detail::extract_node{ std::string(), detail::npos, {}, {} }) {}
+
+void extractor::add_target(
+    const json_pointer &pointer,
+    std::shared_ptr<const detail::extract_target> target) {
+  auto node = std::size_t(0);
+  for (const auto &token : pointer.tokens()) {
+    auto next = detail::npos;
+    for (const auto child : _nodes[node].children) {
+      if (_nodes[child].token == token) {
+        next = child;
+        break;
+      }
+    }
+
+    if (next == detail::npos) {
+      next = _nodes.size();
+      _nodes.push_back(detail::extract_node{ token, detail::parse_array_index(token), {}, {} });
+      _nodes[node].children.push_back(next);
+    }
+
+    node = next;
+  }
+
+  _nodes[node].targets.push_back(_targets.size());
+  _targets.push_back(std::move(target));
+}
+
+std::size_t extractor::extract(const char *data, const std::size_t size) const {
+  if (_targets.empty()) {
+    return 0;
+  }
+
+  detail::extract_state state{ _nodes, _targets, detail::node_set(_nodes.size()), _targets.size(), std::string() };
+
+  decode_context context(data, size);
+  detail::skip_any_whitespace(context);
+  detail::walk(context, state, _nodes[0]);
+  return _targets.size() - state.remaining;
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/interned_string.hpp>
+
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace spotify {
+namespace json {
+namespace {
+
+const std::size_t num_shards = 16;  // must match the shard index in intern(...)
+
+uint64_t read_8(const char *data) {
+  uint64_t word;
+  std::memcpy(&word, data, 8);
+  return word;
+}
+
+/**
+ * A fast hash for short strings that reads 8 bytes at a time.
+ */
+uint64_t hash_bytes(const char *data, const std::size_t size) {
+  const uint64_t k = 0x9E3779B97F4A7C15ULL;
+  auto hash = uint64_t(size) * k;
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    hash = (hash ^ read_8(data + i)) * k;
+    hash ^= (hash >> 32);
+  }
+
+  uint64_t tail = 0;
+  std::memcpy(&tail, data + i, size - i);
+  hash = (hash ^ tail) * k;
+  return hash ^ (hash >> 29);
+}
+
+using generation = std::unordered_multimap<uint64_t, std::shared_ptr<const std::string>>;
+
+generation::iterator find(
+    generation &strings,
+    const uint64_t hash,
+    const char *data,
+    const std::size_t size) {
+  const auto range = strings.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const auto &string = *it->second;
+    if (string.size() == size && std::memcmp(string.data(), data, size) == 0) {
+      return it;
+    }
+  }
+  return strings.end();
+}
+
+}  // namespace
+
+struct intern_table::shard {
+  std::mutex mutex;
+  generation current;
+  generation previous;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+};
+
+intern_table::intern_table(const std::size_t max_size, const std::size_t max_string_size)
+    : _max_shard_size(max_size / num_shards / 2 + 1),
+      _max_string_size(max_string_size),
+      _shards(new shard[num_shards]) {}
+
+intern_table::~intern_table() = default;
+
+interned_string intern_table::intern(const char *data, const std::size_t size) {
+  if (json_unlikely(size > _max_string_size)) {
+    return interned_string(std::make_shared<const std::string>(data, size));
+  }
+
+  const auto hash = hash_bytes(data, size);
+  auto &shard = _shards[hash >> 60];  // the top 4 bits; the map buckets use the low bits
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  const auto current = find(shard.current, hash, data, size);
+  if (current != shard.current.end()) {
+    shard.hits++;
+    return interned_string(current->second);
+  }
+
+  std::shared_ptr<const std::string> string;
+  const auto previous = find(shard.previous, hash, data, size);
+  if (previous != shard.previous.end()) {
+    shard.hits++;
+    string = std::move(previous->second);
+    shard.previous.erase(previous);
+  } else {
+    shard.misses++;
+    string = std::make_shared<const std::string>(data, size);
+  }
+
+  if (shard.current.size() >= _max_shard_size) {
+    shard.evictions += shard.previous.size();
+    shard.previous.clear();
+    shard.previous.swap(shard.current);
+  }
+
+  shard.current.emplace(hash, string);
+  return interned_string(std::move(string));
+}
+
+void intern_table::clear() {
+  for (std::size_t i = 0; i < num_shards; i++) {
+    auto &shard = _shards[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.current.clear();
+    shard.previous.clear();
+    shard.hits = 0;
+    shard.misses = 0;
+    shard.evictions = 0;
+  }
+}
+
+intern_statistics intern_table::statistics() const {
+  intern_statistics statistics;
+  for (std::size_t i = 0; i < num_shards; i++) {
+    auto &shard = _shards[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    statistics.hits += shard.hits;
+    statistics.misses += shard.misses;
+    statistics.evictions += shard.evictions;
+    statistics.size += shard.current.size() + shard.previous.size();
+  }
+  return statistics;
+}
+
+intern_table &intern_table::instance() {
+  static intern_table *table = new intern_table();
+  return *table;
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/mapped_file.hpp>
+
+#include <cerrno>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(_WIN32)
+
+namespace spotify {
+namespace json {
+namespace {
+
+#if !defined(_WIN32)
+
+void throw_error(const char *what, const std::string &path) {
+  throw std::system_error(errno, std::generic_category(), what + path);
+}
+
+/**
+ * Closes the file descriptor when done, also when mapping the file fails. The
+ * mapping stays valid after the descriptor has been closed.
+ */
+struct file_descriptor final {
+  explicit file_descriptor(const int fd) : fd(fd) {}
+  ~file_descriptor() { close(fd); }
+
+  const int fd;
+};
+
+#endif  // !defined(_WIN32)
+
+}  // namespace
+
+mapped_file::mapped_file(const std::string &path)
+    : _data(""),  // not nullptr, which the decoders do not expect
+      _size(0),
+      _is_mapped(false) {
+#if defined(_WIN32)
+  std::ifstream stream(path, std::ios::in | std::ios::binary);
+  if (!stream) {
+    throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "Could not open " + path);
+  }
+  _buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  _data = (_buffer.empty() ? "" : _buffer.data());
+  _size = _buffer.size();
+#else
+  const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw_error("Could not open ", path);
+  }
+
+  const file_descriptor file(fd);
+  struct stat info;
+  if (fstat(fd, &info) == -1) {
+    throw_error("Could not stat ", path);
+  }
+
+  _size = static_cast<std::size_t>(info.st_size);
+  if (_size == 0) {
+    return;  // mmap(...) does not accept empty mappings
+  }
+
+  const auto mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (mapping == MAP_FAILED) {
+    throw_error("Could not map ", path);
+  }
+
+  // These are only hints, so failure is fine.
+  madvise(mapping, _size, MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+  madvise(mapping, _size, MADV_HUGEPAGE);
+#endif  // defined(MADV_HUGEPAGE)
+
+  _data = static_cast<const char *>(mapping);
+  _is_mapped = true;
+#endif  // defined(_WIN32)
+}
+
+mapped_file::mapped_file(mapped_file &&other)
+    : _data(other._data),
+      _size(other._size),
+      _is_mapped(other._is_mapped),
+      _buffer(std::move(other._buffer)) {
+  if (!_is_mapped && !_buffer.empty()) {
+    _data = _buffer.data();
+  }
+  other._data = "";
+  other._size = 0;
+  other._is_mapped = false;
+}
+
+mapped_file::~mapped_file() {
+#if !defined(_WIN32)
+  if (_is_mapped) {
+    munmap(const_cast<char *>(_data), _size);
+  }
+#endif  // !defined(_WIN32)
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/projection.hpp>
+
+#include <spotify/json/extract.hpp>
+
+namespace spotify {
+namespace json {
+
+projection::projection(std::initializer_list<std::string> paths) {
+  for (const auto &path : paths) {
+    add(path);
+  }
+}
+
+projection::projection(const std::vector<std::string> &paths) {
+  for (const auto &path : paths) {
+    add(path);
+  }
+}
+
+void projection::add(const std::string &path) {
+  // Field paths are parsed as JSON pointers without the leading '/'.
+  const auto pointer = json_pointer("/" + path);
+  auto node = &_root;
+  const auto &tokens = pointer.tokens();
+  for (auto token = tokens.begin(); token != tokens.end(); ++token) {
+    const auto is_last = (token + 1 == tokens.end());
+    auto it = node->fields.find(*token);
+    if (it == node->fields.end()) {
+      auto child = (is_last ? nullptr : new detail::projection_node());
+      it = node->fields.emplace(*token, std::unique_ptr<detail::projection_node>(child)).first;
+    } else if (!it->second) {
+      return;  // a shorter path already selects all of the value
+    } else if (is_last) {
+      it->second.reset();
+    }
+
+    node = it->second.get();
+  }
+}
+
+}  // namespace json
+}  // namespace spotify
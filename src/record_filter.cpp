@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/record_filter.hpp>
+
+#include <cstring>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+
+namespace spotify {
+namespace json {
+namespace {
+
+using detail::record_predicate;
+
+/**
+ * Compares the string value of a field in place; see read_string_chars(...).
+ */
+template <typename compare_function>
+class string_predicate final : public record_predicate {
+ public:
+  string_predicate(const json_pointer &pointer, std::string value)
+      : _pointer(pointer),
+        _value(std::move(value)) {}
+
+  bool matches(const char *data, const std::size_t size) const override {
+    decode_context context(data, size);
+    if (!detail::find_pointer(context, _pointer) || detail::peek(context) != '"') {
+      return false;
+    }
+
+    std::string scratch;
+    const auto string = detail::read_string_chars(context, scratch);
+    return compare_function()(string.data, string.size, _value);
+  }
+
+ private:
+  const json_pointer _pointer;
+  const std::string _value;
+};
+
+struct equals final {
+  bool operator()(const char *data, const std::size_t size, const std::string &value) const {
+    return (size == value.size() && std::memcmp(data, value.data(), size) == 0);
+  }
+};
+
+struct starts_with final {
+  bool operator()(const char *data, const std::size_t size, const std::string &prefix) const {
+    return (size >= prefix.size() && std::memcmp(data, prefix.data(), prefix.size()) == 0);
+  }
+};
+
+class range_predicate final : public record_predicate {
+ public:
+  range_predicate(const json_pointer &pointer, const double min, const double max)
+      : _pointer(pointer),
+        _min(min),
+        _max(max) {}
+
+  bool matches(const char *data, const std::size_t size) const override {
+    decode_context context(data, size);
+    if (!detail::find_pointer(context, _pointer)) {
+      return false;
+    }
+
+    const auto c = detail::peek(context);
+    if (c != '-' && (c < '0' || c > '9')) {
+      return false;
+    }
+
+    const auto value = codec::number<double>().decode(context);
+    return (value >= _min && value <= _max);
+  }
+
+ private:
+  const json_pointer _pointer;
+  const double _min;
+  const double _max;
+};
+
+class exists_predicate final : public record_predicate {
+ public:
+  explicit exists_predicate(const json_pointer &pointer)
+      : _pointer(pointer) {}
+
+  bool matches(const char *data, const std::size_t size) const override {
+    decode_context context(data, size);
+    return detail::find_pointer(context, _pointer);
+  }
+
+ private:
+  const json_pointer _pointer;
+};
+
+class not_predicate final : public record_predicate {
+ public:
+  explicit not_predicate(record_filter filter)
+      : _filter(std::move(filter)) {}
+
+  bool matches(const char *data, const std::size_t size) const override {
+    return !_filter(data, size);
+  }
+
+ private:
+  const record_filter _filter;
+};
+
+template <bool is_and>
+class binary_predicate final : public record_predicate {
+ public:
+  binary_predicate(record_filter a, record_filter b)
+      : _a(std::move(a)),
+        _b(std::move(b)) {}
+
+  bool matches(const char *data, const std::size_t size) const override {
+    return (is_and ?
+        (_a(data, size) && _b(data, size)) :
+        (_a(data, size) || _b(data, size)));
+  }
+
+ private:
+  const record_filter _a;
+  const record_filter _b;
+};
+
+}  // namespace
+
+record_filter field_equals(const json_pointer &pointer, std::string value) {
+  return record_filter(std::make_shared<string_predicate<equals>>(pointer, std::move(value)));
+}
+
+record_filter field_starts_with(const json_pointer &pointer, std::string prefix) {
+  return record_filter(std::make_shared<string_predicate<starts_with>>(pointer, std::move(prefix)));
+}
+
+record_filter field_in_range(const json_pointer &pointer, const double min, const double max) {
+  return record_filter(std::make_shared<range_predicate>(pointer, min, max));
+}
+
+record_filter field_exists(const json_pointer &pointer) {
+  return record_filter(std::make_shared<exists_predicate>(pointer));
+}
+
+record_filter negate(record_filter filter) {
+  return record_filter(std::make_shared<not_predicate>(std::move(filter)));
+}
+
+record_filter all_of(record_filter a, record_filter b) {
+  return record_filter(std::make_shared<binary_predicate<true>>(std::move(a), std::move(b)));
+}
+
+record_filter any_of(record_filter a, record_filter b) {
+  return record_filter(std::make_shared<binary_predicate<false>>(std::move(a), std::move(b)));
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/arena.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/encode_allocator.hpp>
+#include <spotify/json/encode_context.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+bool is_aligned(const void *ptr, const std::size_t alignment) {
+  return (reinterpret_cast<uintptr_t>(ptr) % alignment) == 0;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_monotonic_arena_should_allocate_consecutively) {
+  monotonic_arena arena(64);
+  const auto a = static_cast<char *>(arena.allocate(4, 1));
+  const auto b = static_cast<char *>(arena.allocate(4, 1));
+  BOOST_CHECK(b == a + 4);
+  BOOST_CHECK_EQUAL(arena.capacity(), 64);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_arena_should_align_allocations) {
+  monotonic_arena arena(256);
+  arena.allocate(1, 1);
+  BOOST_CHECK(is_aligned(arena.allocate(8, 8), 8));
+  arena.allocate(1, 1);
+  BOOST_CHECK(is_aligned(arena.allocate_array<double>(3), alignof(double)));
+  BOOST_CHECK(is_aligned(arena.allocate(1, 64), 64));
+  BOOST_CHECK(is_aligned(arena.allocate(1024, 128), 128));
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_arena_should_grow_blocks) {
+  monotonic_arena arena(16);
+  for (int i = 0; i < 100; i++) {
+    std::memset(arena.allocate(10, 1), i, 10);
+  }
+  BOOST_CHECK_GE(arena.capacity(), 1000);
+  BOOST_CHECK_LT(arena.capacity(), 4000);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_arena_should_keep_using_block_after_oversized_allocation) {
+  monotonic_arena arena(64);
+  const auto a = static_cast<char *>(arena.allocate(4, 1));
+  std::memset(arena.allocate(1000, 1), 0, 1000);
+  const auto b = static_cast<char *>(arena.allocate(4, 1));
+  BOOST_CHECK(b == a + 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_arena_should_reuse_block_after_reset) {
+  monotonic_arena arena(64);
+  arena.allocate(1000, 1);
+  arena.allocate(32, 1);
+  const auto capacity = arena.capacity();
+  arena.reset();
+  BOOST_CHECK_LT(arena.capacity(), capacity);
+  BOOST_CHECK(arena.allocate(8, 8) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_arena_should_move_blocks) {
+  monotonic_arena arena(64);
+  const auto a = static_cast<char *>(arena.allocate(4, 1));
+  monotonic_arena moved(std::move(arena));
+  BOOST_CHECK_EQUAL(arena.capacity(), 0);
+  BOOST_CHECK_EQUAL(moved.capacity(), 64);
+  BOOST_CHECK(static_cast<char *>(moved.allocate(4, 1)) == a + 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_arena_should_fail_on_huge_allocation) {
+  monotonic_arena arena;
+  BOOST_CHECK_THROW(arena.allocate(json_size_t_max - 8, 1), std::bad_alloc);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_arena_should_back_encode_context) {
+  monotonic_arena arena;
+  auto allocator = arena_allocator(arena);
+  encode_context context(allocator, 0);
+  default_codec<std::vector<int>>().encode(context, std::vector<int>{ 1, 2, 3 });
+  BOOST_CHECK_EQUAL(std::string(static_cast<const char *>(context.data()), context.size()), "[1,2,3]");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/decode_file.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+/**
+ * A file with the given contents in the working directory, which is removed
+ * again when the temporary_file is destroyed.
+ */
+struct temporary_file final {
+  explicit temporary_file(const std::string &contents)
+      : path("spotify_json_test_decode_file_" + std::to_string(counter()++) + ".json") {
+    std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream << contents;
+  }
+
+  ~temporary_file() {
+    std::remove(path.c_str());
+  }
+
+  static int &counter() {
+    static int counter = 0;
+    return counter;
+  }
+
+  const std::string path;
+};
+
+const std::string missing_path = "spotify_json_test_decode_file_missing.json";
+
+}  // namespace
+
+/*
+ * mapped_file
+ */
+
+BOOST_AUTO_TEST_CASE(json_mapped_file_should_map_file_contents) {
+  const temporary_file file("[1,2,3]");
+  const mapped_file mapped(file.path);
+  BOOST_CHECK_EQUAL(std::string(mapped.data(), mapped.size()), "[1,2,3]");
+}
+
+BOOST_AUTO_TEST_CASE(json_mapped_file_should_map_empty_file) {
+  const temporary_file file("");
+  const mapped_file mapped(file.path);
+  BOOST_CHECK_EQUAL(mapped.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_mapped_file_should_be_movable) {
+  const temporary_file file("true");
+  mapped_file mapped(file.path);
+  const auto data = mapped.data();
+  const mapped_file moved(std::move(mapped));
+  BOOST_CHECK_EQUAL(moved.data(), data);
+  BOOST_CHECK_EQUAL(std::string(moved.data(), moved.size()), "true");
+  BOOST_CHECK_EQUAL(mapped.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_mapped_file_should_throw_for_missing_file) {
+  BOOST_CHECK_THROW(mapped_file mapped(missing_path), std::system_error);
+}
+
+/*
+ * decode_file
+ */
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_decode_file) {
+  const temporary_file file(" {\"a\":[1,2],\"b\":[]}\n");
+  const auto map = decode_file<std::map<std::string, std::vector<int>>>(file.path);
+  BOOST_REQUIRE_EQUAL(map.size(), 2);
+  BOOST_CHECK(map.at("a") == std::vector<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_decode_file_with_codec) {
+  const temporary_file file("[1,2,3]");
+  BOOST_CHECK(decode_file(default_codec<std::vector<int>>(), file.path) == std::vector<int>({ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_reference_mapped_file) {
+  const temporary_file file("[{\"a\":1}, [2]]");
+  const mapped_file mapped(file.path);
+  const auto values = decode_file(codec::array<std::vector<codec::raw_ref>>(codec::raw<codec::raw_ref>()), mapped);
+  BOOST_REQUIRE_EQUAL(values.size(), 2);
+  BOOST_CHECK_EQUAL(values[0].data(), mapped.data() + 1);
+  BOOST_CHECK_EQUAL(std::string(values[1].data(), values[1].size()), "[2]");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_throw_for_invalid_json) {
+  const temporary_file file("[1,2,");
+  BOOST_CHECK_THROW(decode_file<std::vector<int>>(file.path), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_throw_for_empty_file) {
+  const temporary_file file("");
+  BOOST_CHECK_THROW(decode_file<std::vector<int>>(file.path), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_throw_for_missing_file) {
+  BOOST_CHECK_THROW(decode_file<std::vector<int>>(missing_path), std::system_error);
+}
+
+/*
+ * try_decode_file
+ */
+
+BOOST_AUTO_TEST_CASE(json_try_decode_file_should_decode_file) {
+  const temporary_file file("[1]");
+  std::vector<int> values;
+  BOOST_CHECK(try_decode_file(values, file.path));
+  BOOST_CHECK(values == std::vector<int>({ 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_try_decode_file_should_return_false_for_invalid_json) {
+  const temporary_file file("[x]");
+  std::vector<int> values;
+  BOOST_CHECK(!try_decode_file(values, default_codec<std::vector<int>>(), file.path));
+}
+
+BOOST_AUTO_TEST_CASE(json_try_decode_file_should_return_false_for_missing_file) {
+  std::vector<int> values;
+  BOOST_CHECK(!try_decode_file(values, missing_path));
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/document_index.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+const std::string document =
+    " {\"user\":{\"name\":\"Alice\",\"id\":42,\"deep\":{\"x\":{\"y\":[7,8]}}},"
+    "\"items\":[{\"uri\":\"spotify:track:1\"},{\"uri\":\"spotify:track:2\"}],"
+    "\"a/b\":1,\"m~n\":2,\"esc\\u0061ped\":3,\"\":4,\"dup\":5,\"dup\":6,\"empty\":{}} ";
+
+std::string find(const document_index &index, const json_pointer &pointer) {
+  codec::raw_ref value;
+  BOOST_REQUIRE(index.find(pointer, value));
+  return std::string(value.data(), value.size());
+}
+
+bool has(const document_index &index, const json_pointer &pointer) {
+  codec::raw_ref value;
+  return index.find(pointer, value);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_find_values) {
+  const document_index index(document.data(), document.size());
+  BOOST_CHECK_EQUAL(find(index, ""), document.substr(1, document.size() - 2));
+  BOOST_CHECK_EQUAL(find(index, "/user/name"), "\"Alice\"");
+  BOOST_CHECK_EQUAL(find(index, "/user/id"), "42");
+  BOOST_CHECK_EQUAL(find(index, "/items/1"), "{\"uri\":\"spotify:track:2\"}");
+  BOOST_CHECK_EQUAL(find(index, "/items/0/uri"), "\"spotify:track:1\"");
+  BOOST_CHECK_EQUAL(find(index, "/a~1b"), "1");
+  BOOST_CHECK_EQUAL(find(index, "/m~0n"), "2");
+  BOOST_CHECK_EQUAL(find(index, "/escaped"), "3");
+  BOOST_CHECK_EQUAL(find(index, "/"), "4");
+  BOOST_CHECK_EQUAL(find(index, "/empty"), "{}");
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_use_first_duplicate_key) {
+  const document_index index(document.data(), document.size());
+  BOOST_CHECK_EQUAL(find(index, "/dup"), "5");
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_find_values_below_indexed_depth) {
+  const document_index index(document.data(), document.size(), 2);
+  BOOST_CHECK_EQUAL(find(index, "/user/deep/x"), "{\"y\":[7,8]}");
+  BOOST_CHECK_EQUAL(find(index, "/user/deep/x/y/1"), "8");
+  BOOST_CHECK(!has(index, "/user/deep/z"));
+  BOOST_CHECK(!has(index, "/user/deep/x/y/2"));
+
+  const document_index root_only(document.data(), document.size(), 0);
+  BOOST_CHECK_EQUAL(root_only.size(), 1);
+  BOOST_CHECK_EQUAL(find(root_only, "/items/1/uri"), "\"spotify:track:2\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_not_find_missing_values) {
+  const document_index index(document.data(), document.size());
+  BOOST_CHECK(!has(index, "/nope"));
+  BOOST_CHECK(!has(index, "/user/age"));
+  BOOST_CHECK(!has(index, "/items/2"));
+  BOOST_CHECK(!has(index, "/items/-"));
+  BOOST_CHECK(!has(index, "/items/01"));
+  BOOST_CHECK(!has(index, "/user/id/0"));
+  BOOST_CHECK(!has(index, "/empty/a"));
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_index_up_to_max_depth) {
+  const std::string json = "{\"a\":[1,[2,3]],\"b\":{}}";
+  BOOST_CHECK_EQUAL(document_index(json.data(), json.size(), 0).size(), 1);
+  BOOST_CHECK_EQUAL(document_index(json.data(), json.size(), 1).size(), 3);
+  BOOST_CHECK_EQUAL(document_index(json.data(), json.size(), 2).size(), 5);
+  BOOST_CHECK_EQUAL(document_index(json.data(), json.size(), 3).size(), 7);
+  BOOST_CHECK_EQUAL(document_index(json.data(), json.size(), 4).size(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_decode_values) {
+  const document_index index(document.data(), document.size());
+  BOOST_CHECK_EQUAL(index.decode<int>("/user/id"), 42);
+  BOOST_CHECK_EQUAL(index.decode<std::string>("/items/1/uri"), "spotify:track:2");
+  BOOST_CHECK(index.decode<std::vector<int>>("/user/deep/x/y") == std::vector<int>({ 7, 8 }));
+  BOOST_CHECK_EQUAL(index.decode("/user/id", codec::number<int64_t>()), 42);
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_fail_to_decode_missing_or_invalid_values) {
+  const document_index index(document.data(), document.size());
+  BOOST_CHECK_THROW(index.decode<int>("/user/age"), decode_exception);
+  BOOST_CHECK_THROW(index.decode<int>("/user/name"), decode_exception);
+
+  int value = 0;
+  BOOST_CHECK(index.try_decode(value, "/user/id"));
+  BOOST_CHECK_EQUAL(value, 42);
+  BOOST_CHECK(!index.try_decode(value, "/user/name"));
+  BOOST_CHECK(!index.try_decode(value, "/user/age", codec::number<int>()));
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_report_offsets_relative_to_document) {
+  size_t value_offset = 0;
+  try {
+    decode<int>("\"Alice\"");
+  } catch (const decode_exception &exception) {
+    value_offset = exception.offset();
+  }
+
+  const document_index index(document.data(), document.size());
+  try {
+    index.decode<int>("/user/name");
+    BOOST_FAIL("decode should have failed");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.offset(), document.find("\"Alice\"") + value_offset);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_validate_document) {
+  const auto fails = [](const std::string &json) {
+    try {
+      document_index(json.data(), json.size());
+      return false;
+    } catch (const decode_exception &) {
+      return true;
+    }
+  };
+
+  BOOST_CHECK(fails(""));
+  BOOST_CHECK(fails("{\"a\":1"));
+  BOOST_CHECK(fails("{\"a\":1,}"));
+  BOOST_CHECK(fails("{\"a\" 1}"));
+  BOOST_CHECK(fails("[1 2]"));
+  BOOST_CHECK(fails("[[[[[[[1,]]]]]]]"));
+  BOOST_CHECK(fails("[1] x"));
+  BOOST_CHECK(!fails(" 1 "));
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_be_smaller_than_document) {
+  std::string json = "[";
+  for (int i = 0; i < 1000; i++) {
+    json += (i ? "," : "");
+    json += "{\"uri\":\"spotify:track:" + std::to_string(i) + "\",\"name\":\"Track number " + std::to_string(i) + "\"}";
+  }
+  json += "]";
+
+  const document_index index(json.data(), json.size(), 1);
+  BOOST_CHECK_EQUAL(index.size(), 1001);
+  BOOST_CHECK_LT(index.memory_usage(), json.size() / 2);
+  BOOST_CHECK_EQUAL(index.decode<std::string>("/999/uri"), "spotify:track:999");
+}
+
+BOOST_AUTO_TEST_CASE(json_document_index_should_be_usable_from_several_threads) {
+  const document_index index(document.data(), document.size());
+  std::vector<std::thread> threads;
+  std::vector<int> results(4);
+  for (size_t i = 0; i < results.size(); i++) {
+    threads.emplace_back([&index, &results, i]{
+      for (int j = 0; j < 100; j++) {
+        results[i] += index.decode<int>("/user/id");
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK(results == std::vector<int>(4, 4200));
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
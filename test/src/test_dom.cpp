@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/arena.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/dom.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+std::string round_trip(const std::string &json) {
+  return encode(decode_dom(json).root());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_dom_value_should_be_16_bytes) {
+  BOOST_CHECK_EQUAL(sizeof(dom_value), 16);
+  BOOST_CHECK_EQUAL(sizeof(dom_member), 32);
+}
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_dom_should_decode_scalars) {
+  BOOST_CHECK(decode_dom("null").root().is_null());
+  BOOST_CHECK_EQUAL(decode_dom("true").root().as_bool(), true);
+  BOOST_CHECK_EQUAL(decode_dom("false").root().as_bool(), false);
+  BOOST_CHECK_EQUAL(decode_dom("\"abc\"").root().str(), "abc");
+  BOOST_CHECK_EQUAL(decode_dom(" \"a\\nb\" ").root().str(), "a\nb");
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_decode_numbers) {
+  BOOST_CHECK_EQUAL(decode_dom("-17").root().as_int64(), -17);
+  BOOST_CHECK_EQUAL(decode_dom("123456789012345678").root().as_int64(), 123456789012345678LL);
+  BOOST_CHECK_EQUAL(decode_dom("-9223372036854775808").root().as_int64(), INT64_MIN);
+  BOOST_CHECK_EQUAL(decode_dom("1.5").root().as_double(), 1.5);
+  BOOST_CHECK_EQUAL(decode_dom("2e3").root().as_double(), 2000.0);
+  BOOST_CHECK_EQUAL(decode_dom("17").root().as_double(), 17.0);
+
+  const auto &big = decode_dom("18446744073709551616").root();
+  BOOST_CHECK(big.type() == dom_type::number);
+  BOOST_CHECK_EQUAL(big.as_double(), 18446744073709551616.0);
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_decode_arrays) {
+  const auto document = decode_dom("[1,[2,3],[],\"x\"]");
+  const auto &root = document.root();
+  BOOST_REQUIRE(root.is_array());
+  BOOST_REQUIRE_EQUAL(root.size(), 4);
+  BOOST_CHECK_EQUAL(root[0].as_int64(), 1);
+  BOOST_CHECK_EQUAL(root[1].size(), 2);
+  BOOST_CHECK_EQUAL(root[1][1].as_int64(), 3);
+  BOOST_CHECK_EQUAL(root[2].size(), 0);
+  BOOST_CHECK_EQUAL(root[3].str(), "x");
+  BOOST_CHECK_THROW(root[4], std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_decode_objects_in_order) {
+  const auto document = decode_dom(R"({"b":1,"a":{"c":[true]},"b":2})");
+  const auto &root = document.root();
+  BOOST_REQUIRE(root.is_object());
+  BOOST_REQUIRE_EQUAL(root.size(), 3);
+  BOOST_CHECK_EQUAL(root.members_begin()[0].key.str(), "b");
+  BOOST_CHECK_EQUAL(root.members_begin()[1].key.str(), "a");
+  BOOST_CHECK_EQUAL(root.find("b")->as_int64(), 1);
+  BOOST_CHECK_EQUAL(root.find("a")->find("c")->begin()->as_bool(), true);
+  BOOST_CHECK(root.find("d") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_decode_escaped_keys) {
+  const auto document = decode_dom(R"({"a\"b":1})");
+  BOOST_CHECK_EQUAL(document.root().find("a\"b")->as_int64(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_decode_deeply_nested_arrays) {
+  const auto json = std::string(10000, '[') + std::string(10000, ']');
+  const auto document = decode_dom(json);
+  auto value = &document.root();
+  for (int i = 0; i < 9999; i++) {
+    BOOST_REQUIRE_EQUAL(value->size(), 1);
+    value = value->begin();
+  }
+  BOOST_CHECK_EQUAL(value->size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_fail_on_invalid_input) {
+  BOOST_CHECK_THROW(decode_dom("[1,"), decode_exception);
+  BOOST_CHECK_THROW(decode_dom("{\"a\"}"), decode_exception);
+  BOOST_CHECK_THROW(decode_dom("1 2"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_fail_to_decode_without_arena) {
+  BOOST_CHECK_THROW(decode(codec::dom_t(), "1"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_throw_on_type_mismatch) {
+  const auto document = decode_dom("[1]");
+  BOOST_CHECK_THROW(document.root().as_bool(), std::invalid_argument);
+  BOOST_CHECK_THROW(document.root().find("a"), std::invalid_argument);
+  BOOST_CHECK_THROW(document.root()[0].str(), std::invalid_argument);
+}
+
+/*
+ * Strings
+ */
+
+BOOST_AUTO_TEST_CASE(json_dom_should_copy_strings_into_arena) {
+  monotonic_arena arena;
+  const std::string json = "[\"abc\"]";
+  const auto value = decode(codec::dom(arena), json);
+  const auto string = value[0].string_data();
+  BOOST_CHECK(string < json.data() || string >= json.data() + json.size());
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_borrow_strings_from_input) {
+  monotonic_arena arena;
+  const std::string json = "[\"abc\",\"a\\tb\"]";
+  const auto value = decode(codec::dom(arena, true), json);
+  BOOST_CHECK(value[0].string_data() == json.data() + 2);
+  BOOST_CHECK_EQUAL(value[1].str(), "a\tb");
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_dom_should_encode_values) {
+  BOOST_CHECK_EQUAL(round_trip("null"), "null");
+  BOOST_CHECK_EQUAL(round_trip("[true,false]"), "[true,false]");
+  BOOST_CHECK_EQUAL(round_trip("[-5,0.5]"), "[-5,0.5]");
+  BOOST_CHECK_EQUAL(round_trip("\"a\\\"b\""), "\"a\\\"b\"");
+  BOOST_CHECK_EQUAL(round_trip("[]"), "[]");
+  BOOST_CHECK_EQUAL(round_trip("{}"), "{}");
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_round_trip_documents) {
+  const std::string json = R"({"id":"x","tags":["a","b"],"n":{"m":[1,{"k":null}]}})";
+  BOOST_CHECK_EQUAL(round_trip(json), json);
+  BOOST_CHECK_EQUAL(round_trip(" { \"a\" : [ 1 , 2 ] } "), "{\"a\":[1,2]}");
+}
+
+BOOST_AUTO_TEST_CASE(json_dom_should_encode_constructed_values) {
+  const dom_value elements[] = {
+      dom_value::integer(1),
+      dom_value::string("x", 1),
+      dom_value() };
+  BOOST_CHECK_EQUAL(encode(dom_value::array(elements, 3)), "[1,\"x\",null]");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/element_iterator.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+std::vector<int> collect(const std::string &json) {
+  std::vector<int> values;
+  BOOST_CHECK(for_each_element(codec::number<int>(), json.data(), json.size(), [&](int value) {
+    values.push_back(value);
+  }));
+  return values;
+}
+
+std::vector<int> iterate(const std::string &json) {
+  std::vector<int> values;
+  for (const auto value : elements(codec::number<int>(), json.data(), json.size())) {
+    values.push_back(value);
+  }
+  return values;
+}
+
+}  // namespace
+
+/*
+ * for_each_element
+ */
+
+BOOST_AUTO_TEST_CASE(json_for_each_element_should_decode_each_element) {
+  BOOST_CHECK(collect("[]") == std::vector<int>());
+  BOOST_CHECK(collect(" [ ] ") == std::vector<int>());
+  BOOST_CHECK(collect("[1]") == std::vector<int>({ 1 }));
+  BOOST_CHECK(collect(" [ 1 , 2,3 ] ") == std::vector<int>({ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_for_each_element_should_stop_when_callback_returns_false) {
+  const std::string json = "[1,2,3,x,5";  // the invalid part is never read
+  std::vector<int> values;
+  const auto completed = for_each_element(codec::number<int>(), json.data(), json.size(), [&](int value) {
+    values.push_back(value);
+    return value < 2;
+  });
+  BOOST_CHECK(!completed);
+  BOOST_CHECK(values == std::vector<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_for_each_element_should_leave_context_after_array) {
+  const std::string json = "[[1,2],[3]]";
+  decode_context context(json.data(), json.size());
+  detail::skip_1(context, '[');
+  std::vector<int> values;
+  BOOST_CHECK(for_each_element(codec::number<int>(), context, [&](int value) { values.push_back(value); }));
+  BOOST_CHECK_EQUAL(context.offset(), 6);
+  BOOST_CHECK(values == std::vector<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_for_each_element_should_decode_nested_array_through_raw_ref) {
+  const std::string json = "{\"items\":[\"a\",\"b\"],\"other\":1}";
+  const auto codec = codec::map<std::map<std::string, codec::raw_ref>>(codec::raw<codec::raw_ref>());
+  const auto items = decode(codec, json).at("items");
+
+  std::vector<std::string> values;
+  auto context = static_cast<decode_context>(items);
+  BOOST_CHECK(for_each_element(codec::string(), context, [&](std::string &&value) { values.push_back(value); }));
+  BOOST_CHECK(values == std::vector<std::string>({ "a", "b" }));
+}
+
+BOOST_AUTO_TEST_CASE(json_for_each_element_should_fail_on_invalid_input) {
+  const auto fails = [](const std::string &json) {
+    try {
+      for_each_element(codec::number<int>(), json.data(), json.size(), [](int) {});
+      return false;
+    } catch (const decode_exception &) {
+      return true;
+    }
+  };
+
+  BOOST_CHECK(fails(""));
+  BOOST_CHECK(fails("{}"));
+  BOOST_CHECK(fails("[1,]"));
+  BOOST_CHECK(fails("[1 2]"));
+  BOOST_CHECK(fails("[1,2"));
+  BOOST_CHECK(fails("[1,\"2\"]"));
+  BOOST_CHECK(fails("[1] x"));
+}
+
+BOOST_AUTO_TEST_CASE(json_for_each_element_should_report_same_offsets_as_decode) {
+  const std::string json = "[1, 2, \"3\"]";
+  size_t decode_offset = 0;
+  size_t for_each_offset = 0;
+  try {
+    decode<std::vector<int>>(json);
+  } catch (const decode_exception &exception) {
+    decode_offset = exception.offset();
+  }
+  try {
+    for_each_element(codec::number<int>(), json.data(), json.size(), [](int) {});
+  } catch (const decode_exception &exception) {
+    for_each_offset = exception.offset();
+  }
+  BOOST_CHECK_EQUAL(for_each_offset, decode_offset);
+}
+
+/*
+ * elements
+ */
+
+BOOST_AUTO_TEST_CASE(json_elements_should_iterate_over_elements) {
+  BOOST_CHECK(iterate("[]") == std::vector<int>());
+  BOOST_CHECK(iterate("[1]") == std::vector<int>({ 1 }));
+  BOOST_CHECK(iterate("\n[1, 2, 3]\n") == std::vector<int>({ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_elements_should_stop_early) {
+  const std::string json = "[{\"a\":1},{\"a\":2},garbage";
+  const auto codec = default_codec<std::map<std::string, int>>();
+  int found = 0;
+  for (const auto &element : elements(codec, json.data(), json.size())) {
+    if (element.at("a") == 2) {
+      found = 2;
+      break;
+    }
+  }
+  BOOST_CHECK_EQUAL(found, 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_elements_should_work_with_temporary_codec) {
+  const std::string json = "[\"a\",\"b\"]";
+  std::vector<std::string> values;
+  for (const auto &value : elements(default_codec<std::string>(), json.data(), json.size())) {
+    values.push_back(value);
+  }
+  BOOST_CHECK(values == std::vector<std::string>({ "a", "b" }));
+}
+
+BOOST_AUTO_TEST_CASE(json_elements_should_iterate_over_nested_array) {
+  const std::string json = "{\"a\":[4,5]}";
+  decode_context context(json.data(), json.size());
+  context.position += 5;
+  std::vector<int> values;
+  for (const auto value : elements(codec::number<int>(), context)) {
+    values.push_back(value);
+  }
+  BOOST_CHECK(values == std::vector<int>({ 4, 5 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_elements_should_throw_when_advancing_to_invalid_element) {
+  const std::string json = "[1,x]";
+  auto range = elements(codec::number<int>(), json.data(), json.size());
+  auto it = range.begin();
+  BOOST_CHECK_EQUAL(*it, 1);
+  BOOST_CHECK_THROW(++it, decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_elements_should_check_trailing_input_at_end) {
+  const std::string json = "[1] x";
+  BOOST_CHECK_THROW(iterate(json), decode_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
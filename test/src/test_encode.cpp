@@ -14,12 +14,29 @@
  * the License.
  */
 
+#include <map>
+#include <memory>
+#include <new>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/any.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/enumeration.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/null.hpp>
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/omit.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/transform.hpp>
+#include <spotify/json/codec/tuple.hpp>
 #include <spotify/json/encode.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
@@ -37,6 +54,28 @@ codec::object_t<custom_obj> custom_codec() {
   return codec;
 }
 
+template <typename codec_type>
+void check_measure(const codec_type &codec, const typename codec_type::object_type &value) {
+  const auto encoded = encode(codec, value);
+  BOOST_CHECK_EQUAL(measure(codec, value), encoded.size());
+  BOOST_CHECK_EQUAL(encode_exact(codec, value), encoded);
+}
+
+template <typename value_type>
+void check_measure(const value_type &value) {
+  check_measure(default_codec<value_type>(), value);
+}
+
+int to_milli(int value) { return value * 1000; }
+int from_milli(int value, std::size_t) { return value / 1000; }
+
+struct no_measure_t {
+  using object_type = int;
+  void encode(encode_context &context, const object_type value) const {
+    context.append("\"custom\"", 8);
+  }
+};
+
 }
 
 template <>
@@ -60,5 +99,109 @@ BOOST_AUTO_TEST_CASE(json_encode_should_encode_into_string) {
   BOOST_CHECK_EQUAL(encode(obj), R"({"x":"d"})");
 }
 
+/*
+ * Measuring
+ */
+
+BOOST_AUTO_TEST_CASE(json_measure_should_measure_scalars) {
+  check_measure(true);
+  check_measure(false);
+  check_measure(null_type());
+  check_measure(0);
+  check_measure(9);
+  check_measure(10);
+  check_measure(-1);
+  check_measure(-10);
+  check_measure(std::numeric_limits<int8_t>::min());
+  check_measure(std::numeric_limits<int64_t>::min());
+  check_measure(std::numeric_limits<int64_t>::max());
+  check_measure(std::numeric_limits<uint64_t>::max());
+  check_measure(0.5);
+  check_measure(-1.0e-300);
+  check_measure(1.5f);
+}
+
+BOOST_AUTO_TEST_CASE(json_measure_should_measure_strings) {
+  check_measure(std::string());
+  check_measure(std::string("hello"));
+  check_measure(std::string("\"\\\n\x01 \xC3\xA5"));
+  check_measure(std::string(5000, '\t'));
+  check_measure(codec::raw<std::string>(), "[1, 2]");
+}
+
+BOOST_AUTO_TEST_CASE(json_measure_should_measure_containers) {
+  check_measure(std::vector<int>());
+  check_measure(std::vector<int>{ 1, 22, 333 });
+  check_measure(std::map<std::string, bool>());
+  check_measure(std::map<std::string, bool>{ { "a", true }, { "\n", false } });
+  check_measure(std::make_tuple(1, std::string("a"), false));
+  check_measure(std::vector<std::shared_ptr<int>>{ nullptr, nullptr });
+  check_measure(std::vector<std::shared_ptr<int>>{ std::make_shared<int>(5), nullptr });
+}
+
+BOOST_AUTO_TEST_CASE(json_measure_should_measure_objects) {
+  custom_obj obj;
+  obj.val = "value";
+  check_measure(custom_codec(), obj);
+  check_measure(obj);
+
+  auto codec = codec::object<custom_obj>();
+  codec.optional("a", &custom_obj::val);
+  codec.optional("b", codec::omit<std::string>());
+  codec.optional("c", codec::null());
+  check_measure(codec, obj);
+
+  auto omitting_codec = codec::object<custom_obj>();
+  omitting_codec.optional("b", codec::omit<std::string>());
+  check_measure(omitting_codec, obj);
+}
+
+BOOST_AUTO_TEST_CASE(json_measure_should_measure_wrapping_codecs) {
+  check_measure(codec::any(codec::number<int>()), 123);
+  check_measure(codec::enumeration<int, std::string>({ { 1, "one" } }), 1);
+  check_measure(codec::transform(&to_milli, &from_milli), 7);
+}
+
+BOOST_AUTO_TEST_CASE(json_measure_should_measure_codecs_without_measure_method) {
+  check_measure(no_measure_t(), 1);
+  check_measure(codec::array<std::vector<int>>(no_measure_t()), { 1, 2 });
+}
+
+BOOST_AUTO_TEST_CASE(json_measure_should_fail_when_encoding_fails) {
+  const auto codec = codec::enumeration<int, std::string>({ { 1, "one" } });
+  BOOST_CHECK_THROW(measure(codec, 2), encode_exception);
+}
+
+/*
+ * Encoding into a fixed buffer
+ */
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_into_buffer_of_exact_size) {
+  const std::vector<double> value{ 1.5, -2.25, 1.0e100 };
+  const auto expected = encode(value);
+  std::vector<char> buffer(measure(value));
+  BOOST_REQUIRE_EQUAL(encode(value, buffer.data(), buffer.size()), expected.size());
+  BOOST_CHECK_EQUAL(std::string(buffer.data(), buffer.size()), expected);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_into_larger_buffer) {
+  char buffer[64];
+  const auto size = encode(std::string("a\nb"), buffer, sizeof(buffer));
+  BOOST_CHECK_EQUAL(std::string(buffer, size), "\"a\\nb\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_escape_long_strings_into_buffer_of_exact_size) {
+  const std::string value(3000, '\x1F');
+  std::vector<char> buffer(measure(value));
+  BOOST_REQUIRE_EQUAL(encode(value, buffer.data(), buffer.size()), buffer.size());
+  BOOST_CHECK_EQUAL(std::string(buffer.data(), buffer.size()), encode(value));
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_should_fail_when_buffer_is_too_small) {
+  const std::vector<int> value{ 1, 2, 3 };
+  char buffer[6];
+  BOOST_CHECK_THROW(encode(value, buffer, sizeof(buffer)), std::bad_alloc);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/encode_allocator.hpp>
+#include <spotify/json/encode_context.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct test_arena {
+  void *allocate(std::size_t size) {
+    blocks.emplace_back(new uint8_t[size]);
+    return blocks.back().get();
+  }
+
+  std::vector<std::unique_ptr<uint8_t[]>> blocks;
+};
+
+std::string to_string(const encode_context &context) {
+  return std::string(static_cast<const char *>(context.data()), context.size());
+}
+
+void fill(encode_context &context, const std::size_t size) {
+  for (std::size_t i = 0; i < size; i++) {
+    context.append(static_cast<uint8_t>('a' + (i % 26)));
+  }
+}
+
+void verify_filled(const encode_context &context, const std::size_t size) {
+  BOOST_REQUIRE_EQUAL(context.size(), size);
+  const auto data = static_cast<const uint8_t *>(context.data());
+  for (std::size_t i = 0; i < size; i++) {
+    BOOST_REQUIRE_EQUAL(data[i], static_cast<uint8_t>('a' + (i % 26)));
+  }
+}
+
+}  // namespace
+
+/*
+ * arena_encode_allocator
+ */
+
+BOOST_AUTO_TEST_CASE(json_arena_encode_allocator_should_allocate_from_arena) {
+  test_arena arena;
+  auto allocator = arena_allocator(arena);
+  encode_context context(allocator, 16);
+  BOOST_REQUIRE_EQUAL(arena.blocks.size(), 1);
+  BOOST_CHECK_EQUAL(context.data(), arena.blocks[0].get());
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_encode_allocator_should_grow_by_copying) {
+  test_arena arena;
+  auto allocator = arena_allocator(arena);
+  encode_context context(allocator, 4);
+  fill(context, 100);
+  verify_filled(context, 100);
+  BOOST_CHECK_GT(arena.blocks.size(), 1);
+  BOOST_CHECK_EQUAL(context.data(), arena.blocks.back().get());
+}
+
+BOOST_AUTO_TEST_CASE(json_arena_encode_allocator_should_encode_with_codec) {
+  test_arena arena;
+  auto allocator = arena_allocator(arena);
+  encode_context context(allocator, 0);
+  default_codec<std::vector<int>>().encode(context, std::vector<int>{ 1, 2, 3 });
+  BOOST_CHECK_EQUAL(to_string(context), "[1,2,3]");
+}
+
+/*
+ * fixed_encode_allocator
+ */
+
+BOOST_AUTO_TEST_CASE(json_fixed_encode_allocator_should_write_into_buffer) {
+  uint8_t buffer[16];
+  fixed_encode_allocator allocator(buffer, sizeof(buffer));
+  encode_context context(allocator, sizeof(buffer));
+  fill(context, 16);
+  verify_filled(context, 16);
+  BOOST_CHECK_EQUAL(context.data(), buffer);
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_encode_allocator_should_not_grow_past_buffer) {
+  uint8_t buffer[16];
+  fixed_encode_allocator allocator(buffer, sizeof(buffer));
+  encode_context context(allocator, sizeof(buffer));
+  fill(context, 16);
+  BOOST_CHECK_THROW(context.append('x'), std::bad_alloc);
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_encode_allocator_should_reject_too_large_capacity) {
+  uint8_t buffer[16];
+  fixed_encode_allocator allocator(buffer, sizeof(buffer));
+  BOOST_CHECK_THROW(encode_context(allocator, 17), std::bad_alloc);
+}
+
+/*
+ * huge_page_encode_allocator
+ */
+
+BOOST_AUTO_TEST_CASE(json_huge_page_encode_allocator_should_allocate_small_buffers) {
+  huge_page_encode_allocator allocator(4096);
+  encode_context context(allocator, 16);
+  fill(context, 1000);
+  verify_filled(context, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(json_huge_page_encode_allocator_should_grow_into_huge_buffers) {
+  huge_page_encode_allocator allocator(4096);
+  encode_context context(allocator, 16);
+  fill(context, 100000);
+  verify_filled(context, 100000);
+}
+
+BOOST_AUTO_TEST_CASE(json_huge_page_encode_allocator_should_grow_huge_buffers) {
+  huge_page_encode_allocator allocator(4096);
+  encode_context context(allocator, 8192);
+  fill(context, 5 * 1024 * 1024);
+  verify_filled(context, 5 * 1024 * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(json_huge_page_encode_allocator_should_have_shared_instance) {
+  encode_context context(huge_page_encode_allocator::instance(), 0);
+  fill(context, 10);
+  verify_filled(context, 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
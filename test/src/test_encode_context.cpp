@@ -14,6 +14,8 @@
  * the License.
  */
 
+#include <cstdlib>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -24,6 +26,25 @@
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 
+namespace {
+
+struct counting_allocator final : public encode_allocator {
+  void *allocate(std::size_t capacity) override {
+    num_allocations++;
+    return std::malloc(capacity);
+  }
+
+  void deallocate(void *ptr, std::size_t capacity) override {
+    num_deallocations += (ptr ? 1 : 0);
+    std::free(ptr);
+  }
+
+  int num_allocations = 0;
+  int num_deallocations = 0;
+};
+
+}  // namespace
+
 BOOST_AUTO_TEST_CASE(json_encode_context_should_construct_without_capacity) {
   const encode_context ctx;
   BOOST_CHECK_EQUAL(ctx.size(), 0);
@@ -140,5 +161,101 @@ BOOST_AUTO_TEST_CASE(json_encode_context_should_saturate_capacity_on_overflow) {
   BOOST_CHECK_EQUAL(ctx.capacity(), UINT16_MAX);
 }
 
+BOOST_AUTO_TEST_CASE(json_encode_context_should_allocate_with_custom_allocator) {
+  counting_allocator allocator;
+  {
+    encode_context ctx(allocator, 16);
+    BOOST_CHECK_EQUAL(allocator.num_allocations, 1);
+    BOOST_CHECK_EQUAL(ctx.capacity(), 16);
+  }
+  BOOST_CHECK_EQUAL(allocator.num_deallocations, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_grow_with_custom_allocator) {
+  counting_allocator allocator;
+  {
+    encode_context ctx(allocator, 4);
+    ctx.append("abcd", 4);
+    ctx.append("efgh", 4);
+    BOOST_CHECK_EQUAL(std::string(static_cast<const char *>(ctx.data()), ctx.size()), "abcdefgh");
+    BOOST_CHECK_EQUAL(allocator.num_allocations, 2);
+    BOOST_CHECK_EQUAL(allocator.num_deallocations, 1);
+  }
+  BOOST_CHECK_EQUAL(allocator.num_deallocations, 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_allocate_lazily_with_custom_allocator) {
+  counting_allocator allocator;
+  encode_context ctx(allocator, 0);
+  BOOST_CHECK_EQUAL(allocator.num_allocations, 0);
+  ctx.append('x');
+  BOOST_CHECK_EQUAL(allocator.num_allocations, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_use_custom_allocator_with_small_size_type) {
+  counting_allocator allocator;
+  detail::base_encode_context<uint16_t> ctx(allocator, 0);
+  ctx.reserve(UINT16_MAX);
+  BOOST_CHECK_EQUAL(allocator.num_allocations, 1);
+  BOOST_CHECK_EQUAL(ctx.capacity(), UINT16_MAX);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_not_reference_by_default) {
+  encode_context ctx;
+  BOOST_CHECK(!ctx.should_reference(std::numeric_limits<std::size_t>::max() - 1));
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_reference_above_threshold) {
+  encode_context ctx;
+  ctx.set_reference_threshold(10);
+  BOOST_CHECK(!ctx.should_reference(9));
+  BOOST_CHECK(ctx.should_reference(10));
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_have_single_segment_without_references) {
+  encode_context ctx;
+  ctx.append("abc", 3);
+  const auto segments = ctx.segments();
+  BOOST_REQUIRE_EQUAL(segments.size(), 1);
+  BOOST_CHECK_EQUAL(segments[0].data, ctx.data());
+  BOOST_CHECK_EQUAL(segments[0].size, 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_have_single_segment_when_empty) {
+  encode_context ctx;
+  const auto segments = ctx.segments();
+  BOOST_REQUIRE_EQUAL(segments.size(), 1);
+  BOOST_CHECK_EQUAL(segments[0].size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_interleave_references_with_buffer) {
+  const std::string a = "AAAA";
+  const std::string b = "BBBB";
+
+  encode_context ctx(0);
+  ctx.append_reference(a.data(), a.size());
+  ctx.append("1", 1);
+  ctx.append_reference(a.data(), a.size());
+  ctx.append_reference(b.data(), b.size());
+  ctx.append("23", 2);
+
+  std::string output;
+  for (const auto &segment : ctx.segments()) {
+    output.append(static_cast<const char *>(segment.data), segment.size);
+  }
+
+  BOOST_CHECK_EQUAL(ctx.segments().size(), 5);
+  BOOST_CHECK_EQUAL(output, "AAAA1AAAABBBB23");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_should_forget_references_when_cleared) {
+  const std::string a = "AAAA";
+  encode_context ctx;
+  ctx.append_reference(a.data(), a.size());
+  ctx.clear();
+  ctx.append('x');
+  BOOST_CHECK_EQUAL(ctx.segments().size(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
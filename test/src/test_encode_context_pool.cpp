@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/detail/encode_context_pool.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+template <int n>
+struct tagged_codec_t {};
+
+}  // namespace
+
+/*
+ * encode_context_pool
+ */
+
+BOOST_AUTO_TEST_CASE(json_encode_context_pool_should_reuse_released_context) {
+  const void *first_data = nullptr;
+  {
+    pooled_encode_context context;
+    context->append('x');
+    first_data = context->data();
+  }
+
+  pooled_encode_context context;
+  BOOST_CHECK_EQUAL(context->data(), first_data);
+  BOOST_CHECK(context->empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_pool_should_hand_out_distinct_contexts_when_nested) {
+  pooled_encode_context outer;
+  pooled_encode_context inner;
+  BOOST_CHECK_NE(&*outer, &*inner);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_pool_should_reserve_capacity_hint) {
+  pooled_encode_context context(100000);
+  BOOST_CHECK_GE(context->capacity(), 100000);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_pool_should_not_keep_huge_contexts) {
+  const void *huge_data = nullptr;
+  {
+    pooled_encode_context context(max_pooled_encode_context_capacity + 1);
+    huge_data = context->data();
+  }
+
+  pooled_encode_context context;
+  BOOST_CHECK_LE(context->capacity(), max_pooled_encode_context_capacity);
+  BOOST_CHECK_NE(context->data(), huge_data);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_pool_should_return_context_on_exception) {
+  const void *first_data = nullptr;
+  try {
+    pooled_encode_context context;
+    first_data = context->data();
+    throw std::runtime_error("failure");
+  } catch (const std::runtime_error &) {
+  }
+
+  pooled_encode_context context;
+  BOOST_CHECK_EQUAL(context->data(), first_data);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_context_pool_should_be_thread_local) {
+  pooled_encode_context context;
+  context->append('x');
+
+  const void *other_data = nullptr;
+  std::thread thread([&]{
+    pooled_encode_context other;
+    other_data = &*other;
+  });
+  thread.join();
+
+  BOOST_CHECK_NE(other_data, &*context);
+}
+
+/*
+ * encode_size_hint
+ */
+
+BOOST_AUTO_TEST_CASE(json_encode_size_hint_should_start_at_zero) {
+  BOOST_CHECK_EQUAL(encode_size_hint<tagged_codec_t<0>>::get(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_size_hint_should_follow_growth_immediately) {
+  using hint = encode_size_hint<tagged_codec_t<1>>;
+  hint::update(8000);
+  BOOST_CHECK_EQUAL(hint::get(), 9000);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_size_hint_should_decay_slowly) {
+  using hint = encode_size_hint<tagged_codec_t<2>>;
+  hint::update(8000);
+  hint::update(0);
+  BOOST_CHECK_EQUAL(hint::get(), 7875);  // 8000 - 8000 / 8 = 7000, plus 1/8
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_size_hint_should_be_clamped) {
+  using hint = encode_size_hint<tagged_codec_t<3>>;
+  hint::update(max_pooled_encode_context_capacity * 4);
+  BOOST_CHECK_EQUAL(hint::get(), max_pooled_encode_context_capacity);
+}
+
+/*
+ * encode
+ */
+
+BOOST_AUTO_TEST_CASE(json_encode_should_encode_with_pooled_contexts_repeatedly) {
+  const std::string big(10000, 'a');
+  for (int i = 0; i < 3; i++) {
+    BOOST_CHECK_EQUAL(encode(big), "\"" + big + "\"");
+    BOOST_CHECK_EQUAL(encode(std::string("b")), "\"b\"");
+  }
+  BOOST_CHECK_GE(encode_size_hint<codec::string_t>::get(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
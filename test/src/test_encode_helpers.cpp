@@ -36,6 +36,19 @@ BOOST_AUTO_TEST_CASE(json_encode_helpers_should_encode_should_respect_should_enc
   BOOST_CHECK(!should_encode(codec::only_true_t(), false));
 }
 
+BOOST_AUTO_TEST_CASE(json_encode_helpers_measure_should_use_measure_method) {
+  static_assert(has_measure_method<codec::boolean_t>::value, "boolean_t should have measure");
+  const encode_context context;
+  BOOST_CHECK_EQUAL(measure(context, codec::boolean(), true), 4);
+  BOOST_CHECK_EQUAL(measure(context, codec::boolean(), false), 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_helpers_measure_should_encode_without_measure_method) {
+  static_assert(!has_measure_method<codec::only_true_t>::value, "only_true_t has no measure");
+  const encode_context context;
+  BOOST_CHECK_EQUAL(measure(context, codec::only_true_t(), false), 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
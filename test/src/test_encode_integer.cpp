@@ -32,6 +32,7 @@ namespace {
 template <typename T>
 void verify_encode_one_negative(encode_context &context, T value) {
   encode_negative_integer(context, value);
+  BOOST_REQUIRE_EQUAL(context.size(), negative_integer_size(value));
   context.append(0);  // null terminator for std::strtoll
   const auto begin = static_cast<const char *>(context.data());
   const auto encoded_value = std::strtoll(begin, nullptr, 10);
@@ -42,6 +43,7 @@ void verify_encode_one_negative(encode_context &context, T value) {
 template <typename T>
 void verify_encode_one_positive(encode_context &context, T value) {
   encode_positive_integer(context, value);
+  BOOST_REQUIRE_EQUAL(context.size(), positive_integer_size(value));
   context.append(0);  // null terminator for std::strtoull
   const auto begin = static_cast<const char *>(context.data());
   const auto encoded_value = std::strtoull(begin, nullptr, 10);
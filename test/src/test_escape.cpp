@@ -65,6 +65,40 @@ BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_other_control_characters)
   }
 }
 
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_null_characters_in_long_strings) {
+  check_escaped(
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\\u0000\\u0001aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+      std::string(31, 'a') + std::string("\0\x01", 2) + std::string(31, 'a'));
+}
+
+/*
+ * escaped_size
+ */
+
+void check_escaped_size(const std::string &input) {
+  for (const auto use_sse42 : { false, true }) {
+    encode_context context;
+    *const_cast<bool *>(&context.has_sse42) &= use_sse42;
+    const auto begin = reinterpret_cast<const uint8_t *>(input.data());
+    write_escaped(context, begin, begin + input.size());
+    BOOST_CHECK_EQUAL(escaped_size(context, begin, begin + input.size()), context.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_escaped_size_should_match_written_size) {
+  check_escaped_size("");
+  check_escaped_size("a");
+  check_escaped_size("simple string that needs no escaping at all");
+  check_escaped_size("\"\\/\b\t\n\f\r");
+  check_escaped_size(std::string("0123456789abcdef\0\x01\x1f" "0123456789abcdef", 35));
+
+  std::string all_characters;
+  for (int i = 0; i < 256; i++) {
+    all_characters += static_cast<char>(i);
+  }
+  check_escaped_size(all_characters);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
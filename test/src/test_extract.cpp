@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/extract.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+const std::string document =
+    "{\"user\":{\"name\":\"Alice\",\"id\":42},"
+    "\"items\":[{\"uri\":\"spotify:track:1\"},{\"uri\":\"spotify:track:2\"}],"
+    "\"a/b\":1,\"m~n\":2,\"esc\\u0061ped\":3,\"\":4}";
+
+template <typename Value>
+Value extract_from_document(const json_pointer &pointer) {
+  return extract<Value>(pointer, document);
+}
+
+}  // namespace
+
+/*
+ * json_pointer
+ */
+
+BOOST_AUTO_TEST_CASE(json_pointer_should_split_tokens) {
+  BOOST_CHECK(json_pointer("").tokens() == std::vector<std::string>());
+  BOOST_CHECK(json_pointer("/").tokens() == std::vector<std::string>({ "" }));
+  BOOST_CHECK(json_pointer("/a/0").tokens() == std::vector<std::string>({ "a", "0" }));
+  BOOST_CHECK(json_pointer("/a//b").tokens() == std::vector<std::string>({ "a", "", "b" }));
+  BOOST_CHECK_EQUAL(json_pointer("/a/0").str(), "/a/0");
+}
+
+BOOST_AUTO_TEST_CASE(json_pointer_should_unescape_tokens) {
+  BOOST_CHECK(json_pointer("/a~1b/m~0n").tokens() == std::vector<std::string>({ "a/b", "m~n" }));
+  BOOST_CHECK(json_pointer("/~01").tokens() == std::vector<std::string>({ "~1" }));
+}
+
+BOOST_AUTO_TEST_CASE(json_pointer_should_reject_invalid_pointers) {
+  BOOST_CHECK_THROW(json_pointer("a"), std::invalid_argument);
+  BOOST_CHECK_THROW(json_pointer("/a~"), std::invalid_argument);
+  BOOST_CHECK_THROW(json_pointer("/a~2"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(json_parse_array_index_should_accept_only_valid_indices) {
+  BOOST_CHECK_EQUAL(detail::parse_array_index("0"), 0);
+  BOOST_CHECK_EQUAL(detail::parse_array_index("17"), 17);
+  BOOST_CHECK_EQUAL(detail::parse_array_index(""), std::size_t(-1));
+  BOOST_CHECK_EQUAL(detail::parse_array_index("-"), std::size_t(-1));
+  BOOST_CHECK_EQUAL(detail::parse_array_index("01"), std::size_t(-1));
+  BOOST_CHECK_EQUAL(detail::parse_array_index("1a"), std::size_t(-1));
+}
+
+/*
+ * extract
+ */
+
+BOOST_AUTO_TEST_CASE(json_extract_should_extract_values) {
+  BOOST_CHECK_EQUAL(extract_from_document<int>("/user/id"), 42);
+  BOOST_CHECK_EQUAL(extract_from_document<std::string>("/user/name"), "Alice");
+  BOOST_CHECK_EQUAL(extract_from_document<std::string>("/items/1/uri"), "spotify:track:2");
+  BOOST_CHECK_EQUAL(extract_from_document<int>("/a~1b"), 1);
+  BOOST_CHECK_EQUAL(extract_from_document<int>("/m~0n"), 2);
+  BOOST_CHECK_EQUAL(extract_from_document<int>("/escaped"), 3);
+  BOOST_CHECK_EQUAL(extract_from_document<int>("/"), 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_extract_should_extract_whole_document) {
+  BOOST_CHECK(extract<std::vector<int>>("", " [1,2] ") == std::vector<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_extract_should_extract_with_codec) {
+  const auto raw = extract("/items/0", codec::raw<codec::raw_ref>(), document);
+  BOOST_CHECK_EQUAL(std::string(raw.data(), raw.size()), "{\"uri\":\"spotify:track:1\"}");
+}
+
+BOOST_AUTO_TEST_CASE(json_extract_should_not_read_past_value) {
+  BOOST_CHECK_EQUAL(extract<int>("/a", "{\"a\":1, garbage"), 1);
+  BOOST_CHECK_EQUAL(extract<int>("/1", "[0, 1, garbage"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_extract_should_skip_complex_values) {
+  const std::string json = "{\"x\":{\"a\":[1,{\"b\":\"}\"}]},\"a\":\"]\",\"y\":[[],{}],\"b\":5}";
+  BOOST_CHECK_EQUAL(extract<int>("/b", json), 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_extract_should_use_first_duplicate_key) {
+  BOOST_CHECK_EQUAL(extract<int>("/a", "{\"a\":1,\"a\":2}"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_extract_should_fail_for_missing_values) {
+  BOOST_CHECK_THROW(extract_from_document<int>("/user/age"), decode_exception);
+  BOOST_CHECK_THROW(extract_from_document<int>("/items/2"), decode_exception);
+  BOOST_CHECK_THROW(extract_from_document<int>("/items/-"), decode_exception);
+  BOOST_CHECK_THROW(extract_from_document<int>("/items/x"), decode_exception);
+  BOOST_CHECK_THROW(extract_from_document<int>("/user/id/0"), decode_exception);
+  BOOST_CHECK_THROW(extract<int>("/a", "{}"), decode_exception);
+  BOOST_CHECK_THROW(extract<int>("/0", "[]"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_extract_should_report_offset_of_value_without_match) {
+  try {
+    extract_from_document<int>("/user/age");
+    BOOST_FAIL("extract should have failed");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.offset(), 8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_extract_should_fail_for_invalid_documents) {
+  BOOST_CHECK_THROW(extract<int>("/b", "{\"a\":[1,}"), decode_exception);
+  BOOST_CHECK_THROW(extract<int>("/b", "{\"a\":1 \"b\":2}"), decode_exception);
+  BOOST_CHECK_THROW(extract<int>("/b", "{\"a\" 1,\"b\":2}"), decode_exception);
+  BOOST_CHECK_THROW(extract<int>("/1", "[1 2]"), decode_exception);
+  BOOST_CHECK_THROW(extract<int>("/a", "{\"a\":\"1\"}"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_try_extract_should_return_false_on_failure) {
+  int value = 0;
+  BOOST_CHECK(try_extract(value, "/user/id", document));
+  BOOST_CHECK_EQUAL(value, 42);
+  BOOST_CHECK(!try_extract(value, "/user/age", document));
+  BOOST_CHECK(!try_extract(value, "/user/name", codec::number<int>(), document));
+}
+
+/*
+ * extractor
+ */
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_extract_several_values) {
+  int id = 0;
+  std::string name;
+  std::vector<std::string> uris;
+
+  extractor extractor;
+  extractor.add("/user/id", id);
+  extractor.add("/user/name", name);
+  extractor.add("/items/1/uri", codec::string(), [&](std::string &&uri) { uris.push_back(uri); });
+  extractor.add("/items/0/uri", codec::string(), [&](std::string &&uri) { uris.push_back(uri); });
+
+  BOOST_CHECK_EQUAL(extractor.extract(document), 4);
+  BOOST_CHECK_EQUAL(id, 42);
+  BOOST_CHECK_EQUAL(name, "Alice");
+  BOOST_CHECK(uris == std::vector<std::string>({ "spotify:track:1", "spotify:track:2" }));
+}
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_extract_nested_and_parent_values) {
+  codec::raw_ref user;
+  int id = 0;
+  extractor extractor;
+  extractor.add("/user", codec::raw<codec::raw_ref>(), [&](codec::raw_ref &&raw) { user = raw; });
+  extractor.add("/user/id", id);
+
+  BOOST_CHECK_EQUAL(extractor.extract(document), 2);
+  BOOST_CHECK_EQUAL(std::string(user.data(), user.size()), "{\"name\":\"Alice\",\"id\":42}");
+  BOOST_CHECK_EQUAL(id, 42);
+}
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_extract_same_pointer_twice) {
+  int a = 0;
+  int b = 0;
+  extractor extractor;
+  extractor.add("/user/id", a);
+  extractor.add("/user/id", b);
+  BOOST_CHECK_EQUAL(extractor.extract(document), 2);
+  BOOST_CHECK_EQUAL(a, 42);
+  BOOST_CHECK_EQUAL(b, 42);
+}
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_count_found_values) {
+  int a = 0;
+  int b = 0;
+  extractor extractor;
+  extractor.add("/a", a);
+  extractor.add("/b", b);
+  BOOST_CHECK_EQUAL(extractor.extract("{\"b\":2,\"c\":3}"), 1);
+  BOOST_CHECK_EQUAL(a, 0);
+  BOOST_CHECK_EQUAL(b, 2);
+  BOOST_CHECK_EQUAL(extractor.extract("[]"), 0);
+  BOOST_CHECK_EQUAL(json::extractor().extract("{}"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_stop_when_all_values_are_found) {
+  int a = 0;
+  extractor extractor;
+  extractor.add("/a", a);
+  BOOST_CHECK_EQUAL(extractor.extract("{\"a\":1, garbage"), 1);
+  BOOST_CHECK_EQUAL(a, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_use_first_duplicate_key) {
+  std::vector<int> values;
+  extractor extractor;
+  extractor.add("/a", codec::number<int>(), [&](int value) { values.push_back(value); });
+  extractor.add("/b", codec::number<int>(), [&](int value) { values.push_back(value); });
+  BOOST_CHECK_EQUAL(extractor.extract("{\"a\":1,\"a\":2,\"b\":3}"), 2);
+  BOOST_CHECK(values == std::vector<int>({ 1, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_not_enter_later_duplicate_keys) {
+  const std::string json = "{\"a\":{\"x\":1},\"a\":{\"b\":2}}";
+  int b = 0;
+  extractor extractor;
+  extractor.add("/a/b", b);
+  BOOST_CHECK_EQUAL(extractor.extract(json), 0);
+  BOOST_CHECK_EQUAL(b, 0);
+  BOOST_CHECK(!try_extract(b, "/a/b", json));
+}
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_extract_with_many_nodes) {
+  std::string json = "{";
+  std::vector<int> values(300);
+  extractor extractor;
+  for (int i = 0; i < 300; i++) {
+    json += (i ? ",\"" : "\"") + std::to_string(i) + "\":" + std::to_string(i);
+    extractor.add("/" + std::to_string(i), values[i]);
+  }
+  json += ",\"299\":0}";
+  BOOST_CHECK_EQUAL(extractor.extract(json), 300);
+  BOOST_CHECK_EQUAL(values[299], 299);
+}
+
+BOOST_AUTO_TEST_CASE(json_extractor_should_fail_for_invalid_documents) {
+  int a = 0;
+  extractor extractor;
+  extractor.add("/a", a);
+  extractor.add("/b", a);
+  BOOST_CHECK_THROW(extractor.extract("{\"a\":1,\"c\":[}"), decode_exception);
+  BOOST_CHECK_THROW(extractor.extract("{\"a\":\"x\"}"), decode_exception);
+  BOOST_CHECK_THROW(extractor.extract("{\"a\":1"), decode_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/find_array_separators.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+/**
+ * The offsets of the separators, or an empty vector if there are none, for all
+ * chunk sizes from 1 to the size of the input (which must all agree).
+ */
+std::vector<std::size_t> separator_offsets(const std::string &json) {
+  std::vector<std::size_t> first_offsets;
+  for (std::size_t chunk_size = 1; chunk_size <= json.size() + 1; chunk_size++) {
+    std::vector<const char *> separators;
+    std::vector<std::size_t> offsets;
+    if (find_array_separators(json.data(), json.data() + json.size(), 4, chunk_size, separators)) {
+      for (const auto separator : separators) {
+        offsets.push_back(separator - json.data());
+      }
+    }
+
+    if (chunk_size == 1) {
+      first_offsets = offsets;
+    } else {
+      BOOST_REQUIRE(offsets == first_offsets);
+    }
+  }
+  return first_offsets;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_find_array_separators_should_find_top_level_separators) {
+  BOOST_CHECK(separator_offsets("[]") == std::vector<std::size_t>({ 0, 1 }));
+  BOOST_CHECK(separator_offsets(" [ 1 , 2 ] ") == std::vector<std::size_t>({ 1, 5, 9 }));
+  BOOST_CHECK(separator_offsets("[[1,2],{\"a\":[3,4]},5]") == std::vector<std::size_t>({ 0, 6, 18, 20 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_find_array_separators_should_ignore_strings) {
+  BOOST_CHECK(separator_offsets("[\",]\",\"[{\"]") == std::vector<std::size_t>({ 0, 5, 10 }));
+  BOOST_CHECK(separator_offsets("[\"\\\",\",\"\\\\\",1]") == std::vector<std::size_t>({ 0, 6, 11, 13 }));
+  BOOST_CHECK(separator_offsets("[\"\\\\\\\"]\",1]") == std::vector<std::size_t>({ 0, 8, 10 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_find_array_separators_should_reject_non_arrays) {
+  BOOST_CHECK(separator_offsets("").empty());
+  BOOST_CHECK(separator_offsets("{}").empty());
+  BOOST_CHECK(separator_offsets("[1,2").empty());
+  BOOST_CHECK(separator_offsets("[\"]").empty());
+  BOOST_CHECK(separator_offsets("[1}").empty());
+  BOOST_CHECK(separator_offsets("[1] x").empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/cpuid.hpp>
+#include <spotify/json/detail/find_line_end.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+void check_line_end(const std::string &input, const size_t expected) {
+  const auto begin = input.data();
+  const auto end = begin + input.size();
+  BOOST_CHECK_EQUAL(find_line_end_scalar(begin, end) - begin, expected);
+#if defined(json_arch_x86)
+  if (cpuid().has_sse42()) {
+    BOOST_CHECK_EQUAL(find_line_end_sse42(begin, end) - begin, expected);
+  }
+#endif  // defined(json_arch_x86)
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_find_line_end_should_find_newline) {
+  check_line_end("", 0);
+  check_line_end("\n", 0);
+  check_line_end("{}\n{}", 2);
+  check_line_end("{}", 2);
+  check_line_end(std::string(100, ' ') + "\n", 100);
+  check_line_end(std::string(31, 'x') + "\n" + std::string(40, 'x'), 31);
+}
+
+BOOST_AUTO_TEST_CASE(json_find_line_end_should_skip_newlines_in_strings) {
+  check_line_end("\"\n\"\n", 3);
+  check_line_end("[\"" + std::string(40, '\n') + "\"]\n", 44);
+  check_line_end("\"\\\"\n\"\n", 5);
+  check_line_end("\"\\\\\"\n", 4);
+  check_line_end("\"" + std::string(20, 'a') + "\\\"" + std::string(20, '\n') + "\"\n", 44);
+}
+
+BOOST_AUTO_TEST_CASE(json_find_line_end_should_handle_unterminated_strings) {
+  check_line_end("\"\n", 2);
+  check_line_end("\"" + std::string(40, '\n'), 41);
+  check_line_end("\"\\", 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_find_line_end_should_handle_null_bytes) {
+  check_line_end(std::string("\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\n", 18), 17);
+  check_line_end(std::string("\"\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\n\"\n", 19), 18);
+}
+
+/*
+ * split_lines
+ */
+
+namespace {
+
+std::vector<std::string> split(const std::string &input, const std::size_t chunk_size) {
+  std::vector<std::string> chunks;
+  for (const auto &chunk : split_lines(input.data(), input.data() + input.size(), chunk_size)) {
+    chunks.emplace_back(chunk.first, chunk.second);
+  }
+  return chunks;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_split_lines_should_split_after_newlines) {
+  const auto expected = std::vector<std::string>({ "aaa\n", "bb\nc\n", "dddd" });
+  BOOST_CHECK(split("aaa\nbb\nc\ndddd", 4) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(json_split_lines_should_not_split_lines) {
+  const auto expected = std::vector<std::string>({ "aaaaaaaa\n", "b" });
+  BOOST_CHECK(split("aaaaaaaa\nb", 2) == expected);
+  BOOST_CHECK(split("a\nb\n", 1) == std::vector<std::string>({ "a\n", "b\n" }));
+  BOOST_CHECK(split("a\nb\n", 0) == std::vector<std::string>({ "a\n", "b\n" }));
+}
+
+BOOST_AUTO_TEST_CASE(json_split_lines_should_return_whole_input_for_large_chunks) {
+  BOOST_CHECK(split("a\nb\n", 100) == std::vector<std::string>({ "a\nb\n" }));
+  BOOST_CHECK(split("", 100).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
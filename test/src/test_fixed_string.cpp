@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_allocator.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/fixed_string.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct track_t {
+  fixed_string<22> id;
+  fixed_string<2> country;
+};
+
+}  // namespace
+
+template <>
+struct default_codec_t<track_t> {
+  static codec::object_t<track_t> codec() {
+    auto codec = codec::object<track_t>();
+    codec.required("id", &track_t::id);
+    codec.required("country", &track_t::country);
+    return codec;
+  }
+};
+
+/*
+ * fixed_string
+ */
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_should_be_stored_inline) {
+  BOOST_CHECK_EQUAL(sizeof(fixed_string<22>), 24);
+  BOOST_CHECK_EQUAL(sizeof(fixed_string<2>), 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_should_hold_strings_up_to_capacity) {
+  const fixed_string<3> string("abc");
+  BOOST_CHECK_EQUAL(string.str(), "abc");
+  BOOST_CHECK_EQUAL(string.size(), 3);
+  BOOST_CHECK(fixed_string<3>().empty());
+  BOOST_CHECK_THROW(fixed_string<3>("abcd"), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_should_know_if_it_is_clean) {
+  BOOST_CHECK(fixed_string<8>("abc").is_clean());
+  BOOST_CHECK(fixed_string<8>("\xC3\xA5").is_clean());
+  BOOST_CHECK(!fixed_string<8>("a\"b").is_clean());
+  BOOST_CHECK(!fixed_string<8>("a\\b").is_clean());
+  BOOST_CHECK(!fixed_string<8>("a\nb").is_clean());
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_should_compare_and_hash) {
+  BOOST_CHECK(fixed_string<4>("ab") == fixed_string<4>("ab"));
+  BOOST_CHECK(fixed_string<4>("ab") != fixed_string<4>("abc"));
+  BOOST_CHECK(fixed_string<4>("ab") < fixed_string<4>("abc"));
+  BOOST_CHECK(fixed_string<4>("ab") < fixed_string<4>("b"));
+  BOOST_CHECK(!(fixed_string<4>("b") < fixed_string<4>("ab")));
+
+  std::unordered_set<fixed_string<4>> set{ "SE", "US", "SE" };
+  BOOST_CHECK_EQUAL(set.size(), 2);
+}
+
+/*
+ * fixed_string_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_decode) {
+  const auto string = decode<fixed_string<22>>("\"4uLU6hMCjMI75M1A2tKUQC\"");
+  BOOST_CHECK_EQUAL(string.str(), "4uLU6hMCjMI75M1A2tKUQC");
+  BOOST_CHECK(string.is_clean());
+  BOOST_CHECK(decode<fixed_string<2>>("\"\"").empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_decode_escaped_strings) {
+  const auto string = decode<fixed_string<3>>("\"a\\nb\"");
+  BOOST_CHECK_EQUAL(string.str(), "a\nb");
+  BOOST_CHECK(!string.is_clean());
+  BOOST_CHECK_EQUAL(decode<fixed_string<2>>("\"\\u00e5\"").str(), "\xC3\xA5");
+  BOOST_CHECK(decode<fixed_string<2>>("\"\\/\"").is_clean());
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_reject_too_long_strings) {
+  BOOST_CHECK_THROW(decode<fixed_string<2>>("\"SWE\""), decode_exception);
+  BOOST_CHECK_THROW(decode<fixed_string<2>>("\"S\\nE\""), decode_exception);
+
+  try {
+    decode<fixed_string<2>>("  \"SWE\"");
+    BOOST_FAIL("Expected decode_exception");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.offset(), 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_fail_on_invalid_strings) {
+  BOOST_CHECK_THROW(decode<fixed_string<8>>("\"abc"), decode_exception);
+  BOOST_CHECK_THROW(decode<fixed_string<2>>("\"ab"), decode_exception);
+  BOOST_CHECK_THROW(decode<fixed_string<8>>("abc"), decode_exception);
+  BOOST_CHECK_THROW(decode<fixed_string<8>>("\"\\x\""), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_encode) {
+  BOOST_CHECK_EQUAL(encode(fixed_string<8>("abc")), "\"abc\"");
+  BOOST_CHECK_EQUAL(encode(fixed_string<8>("a\"b\n")), "\"a\\\"b\\n\"");
+  BOOST_CHECK_EQUAL(encode(fixed_string<8>()), "\"\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_encode_into_exactly_sized_buffer) {
+  uint8_t buffer[5];
+  fixed_encode_allocator allocator(buffer, sizeof(buffer));
+  encode_context context(allocator, sizeof(buffer));
+  default_codec<fixed_string<22>>().encode(context, fixed_string<22>("abc"));
+  BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char *>(buffer), context.size()), "\"abc\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_measure) {
+  const auto codec = default_codec<fixed_string<8>>();
+  BOOST_CHECK_EQUAL(measure(codec, fixed_string<8>("abc")), 5);
+  BOOST_CHECK_EQUAL(measure(codec, fixed_string<8>("a\"b\n")), 8);
+  BOOST_CHECK_EQUAL(measure(codec, fixed_string<8>()), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_encode_exact_map_keys) {
+  const std::map<fixed_string<8>, int> map{ { fixed_string<8>("a"), 1 }, { fixed_string<8>("b\n"), 2 } };
+  BOOST_CHECK_EQUAL(encode_exact(map), R"({"a":1,"b\n":2})");
+}
+
+BOOST_AUTO_TEST_CASE(json_fixed_string_codec_should_round_trip_structs) {
+  const std::string json = R"([{"id":"4uLU6hMCjMI75M1A2tKUQC","country":"SE"},{"id":"x","country":"US"}])";
+  const auto tracks = decode<std::vector<track_t>>(json);
+  BOOST_REQUIRE_EQUAL(tracks.size(), 2);
+  BOOST_CHECK_EQUAL(tracks[1].country.str(), "US");
+  BOOST_CHECK_EQUAL(encode(tracks), json);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/incremental_decoder.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+template <typename codec_type>
+std::vector<typename codec_type::object_type> decode_in_chunks(
+    const codec_type &codec,
+    const std::string &json,
+    const size_t chunk_size) {
+  std::vector<typename codec_type::object_type> values;
+  auto decoder = incremental_array(codec);
+  for (size_t i = 0; i < json.size(); i += chunk_size) {
+    const auto size = std::min(chunk_size, json.size() - i);
+    decoder.feed(json.data() + i, size, [&](typename codec_type::object_type &&value) {
+      values.push_back(std::move(value));
+    });
+  }
+  decoder.finish();
+  return values;
+}
+
+template <typename codec_type>
+void verify_chunked_decoding(const codec_type &codec, const std::string &json) {
+  const auto expected = decode(codec::array<std::vector<typename codec_type::object_type>>(codec), json);
+  for (size_t chunk_size = 1; chunk_size <= json.size(); chunk_size++) {
+    BOOST_REQUIRE(decode_in_chunks(codec, json, chunk_size) == expected);
+  }
+}
+
+size_t decode_fail_offset(const std::string &json, const size_t chunk_size) {
+  try {
+    decode_in_chunks(codec::number<int>(), json, chunk_size);
+  } catch (const decode_exception &exception) {
+    return exception.offset();
+  }
+  BOOST_FAIL("Expected decode_exception");
+  return 0;
+}
+
+}  // namespace
+
+/*
+ * incremental_array_decoder
+ */
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_decode_empty_array) {
+  verify_chunked_decoding(codec::number<int>(), "[]");
+  verify_chunked_decoding(codec::number<int>(), " \n[ \t] ");
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_decode_numbers) {
+  verify_chunked_decoding(codec::number<int>(), "[1,-22,333]");
+  verify_chunked_decoding(codec::number<double>(), " [ 1.5e3 , -0.25 ,7 ] ");
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_decode_strings) {
+  verify_chunked_decoding(codec::string(), R"(["a","b\"]}","\\","\u00e5",""])");
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_decode_nested_values) {
+  verify_chunked_decoding(
+      default_codec<std::map<std::string, std::vector<int>>>(),
+      R"([{"a":[1,2],"]":[]},{},{"\"{":[3]}])");
+  verify_chunked_decoding(
+      codec::raw<std::string>(),
+      R"([ true, null, {"x": [false, "]"]}, [[[]]], "s" ])");
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_only_buffer_unfinished_element) {
+  auto decoder = incremental_array(codec::string());
+  std::vector<std::string> values;
+  const auto callback = [&](std::string &&value) { values.push_back(std::move(value)); };
+
+  decoder.feed(R"(["first","second","th)", callback);
+  BOOST_CHECK_EQUAL(values.size(), 2);
+  BOOST_CHECK_EQUAL(decoder.buffered(), 3);
+
+  decoder.feed(R"(ird"  ,  "fourth"]  )", callback);
+  BOOST_CHECK_EQUAL(decoder.buffered(), 0);
+  BOOST_CHECK(decoder.is_done());
+  decoder.finish();
+  BOOST_CHECK(values == std::vector<std::string>({ "first", "second", "third", "fourth" }));
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_wait_for_end_of_number) {
+  auto decoder = incremental_array(codec::number<int>());
+  std::vector<int> values;
+  const auto callback = [&](int value) { values.push_back(value); };
+
+  decoder.feed("[12", callback);
+  BOOST_CHECK(values.empty());
+  decoder.feed("34]", callback);
+  BOOST_REQUIRE_EQUAL(values.size(), 1);
+  BOOST_CHECK_EQUAL(values[0], 1234);
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_be_reusable_after_reset) {
+  auto decoder = incremental_array(codec::number<int>());
+  int sum = 0;
+  const auto callback = [&](int value) { sum += value; };
+
+  decoder.feed("[1,2", callback);
+  decoder.reset();
+  decoder.feed("[3,4]", callback);
+  decoder.finish();
+  BOOST_CHECK_EQUAL(sum, 8);
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_fail_on_incomplete_input) {
+  for (const auto json : { "", "[", "[1", "[1,", "[1,2" }) {
+    auto decoder = incremental_array(codec::number<int>());
+    decoder.feed(json, [](int) {});
+    BOOST_CHECK_THROW(decoder.finish(), decode_exception);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_fail_on_invalid_input) {
+  for (size_t chunk_size = 1; chunk_size < 8; chunk_size++) {
+    BOOST_CHECK_EQUAL(decode_fail_offset("{}", chunk_size), 0);
+    BOOST_CHECK_EQUAL(decode_fail_offset("[1,,2]", chunk_size), 3);
+    BOOST_CHECK_EQUAL(decode_fail_offset("[1 2]", chunk_size), 3);
+    BOOST_CHECK_EQUAL(decode_fail_offset("[1,2,]", chunk_size), 5);
+    BOOST_CHECK_EQUAL(decode_fail_offset("[1] x", chunk_size), 4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_array_decoder_should_report_codec_errors_with_document_offset) {
+  const auto codec = default_codec<std::vector<int>>();
+  for (const std::string json : { "[1, 22, 3x3]", "[1, \"a\"]", "[1, {}]" }) {
+    size_t expected_offset = 0;
+    try {
+      decode(codec, json);
+    } catch (const decode_exception &exception) {
+      expected_offset = exception.offset();
+    }
+
+    BOOST_REQUIRE_GT(expected_offset, 0);
+    for (size_t chunk_size = 1; chunk_size < json.size(); chunk_size++) {
+      BOOST_CHECK_EQUAL(decode_fail_offset(json, chunk_size), expected_offset);
+    }
+  }
+}
+
+/*
+ * incremental_object_decoder
+ */
+
+BOOST_AUTO_TEST_CASE(json_incremental_object_decoder_should_decode_in_chunks) {
+  const std::string json = R"( { "a" : [1] , "b\":":[], "":[2,3]} )";
+  const auto expected = decode<std::map<std::string, std::vector<int>>>(json);
+
+  for (size_t chunk_size = 1; chunk_size <= json.size(); chunk_size++) {
+    std::map<std::string, std::vector<int>> values;
+    auto decoder = incremental_object(default_codec<std::vector<int>>());
+    for (size_t i = 0; i < json.size(); i += chunk_size) {
+      const auto size = std::min(chunk_size, json.size() - i);
+      decoder.feed(json.data() + i, size, [&](std::string &&key, std::vector<int> &&value) {
+        values[key] = std::move(value);
+      });
+    }
+    decoder.finish();
+    BOOST_REQUIRE(values == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_incremental_object_decoder_should_fail_on_invalid_input) {
+  for (const auto json : { "[]", "{1:2}", R"({"a" 1})", R"({"a":})" }) {
+    auto decoder = incremental_object(codec::number<int>());
+    BOOST_CHECK_THROW(decoder.feed(json, [](std::string &&, int) {}), decode_exception);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
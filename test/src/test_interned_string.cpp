@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/interned_string.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+const void *address(const interned_string &string) {
+  return string.data();
+}
+
+}  // namespace
+
+/*
+ * intern_table
+ */
+
+BOOST_AUTO_TEST_CASE(json_intern_table_should_share_equal_strings) {
+  intern_table table;
+  const auto a = table.intern("SE");
+  const auto b = table.intern(std::string("SE"));
+  const auto c = table.intern("US");
+  BOOST_CHECK_EQUAL(address(a), address(b));
+  BOOST_CHECK_NE(address(a), address(c));
+  BOOST_CHECK_EQUAL(a.str(), "SE");
+}
+
+BOOST_AUTO_TEST_CASE(json_intern_table_should_count_hits_and_misses) {
+  intern_table table;
+  table.intern("a");
+  table.intern("a");
+  table.intern("a");
+  table.intern("b");
+  const auto statistics = table.statistics();
+  BOOST_CHECK_EQUAL(statistics.hits, 2);
+  BOOST_CHECK_EQUAL(statistics.misses, 2);
+  BOOST_CHECK_EQUAL(statistics.size, 2);
+  BOOST_CHECK_EQUAL(statistics.hit_rate(), 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(json_intern_table_should_bound_its_size) {
+  intern_table table(160);
+  for (int i = 0; i < 10000; i++) {
+    table.intern(std::to_string(i));
+  }
+  const auto statistics = table.statistics();
+  BOOST_CHECK_LE(statistics.size, 200);
+  BOOST_CHECK_GE(statistics.evictions, 9000);
+}
+
+BOOST_AUTO_TEST_CASE(json_intern_table_should_keep_handles_valid_after_eviction) {
+  intern_table table(16);
+  const auto string = table.intern("kept");
+  for (int i = 0; i < 1000; i++) {
+    table.intern(std::to_string(i));
+  }
+  table.clear();
+  BOOST_CHECK_EQUAL(string.str(), "kept");
+  BOOST_CHECK_EQUAL(table.statistics().size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_intern_table_should_keep_strings_in_use) {
+  intern_table table(160);
+  const auto first = table.intern("hot");
+  for (int i = 0; i < 10000; i++) {
+    table.intern(std::to_string(i));
+    BOOST_REQUIRE_EQUAL(address(table.intern("hot")), address(first));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_intern_table_should_not_intern_long_strings) {
+  intern_table table(1024, 4);
+  const auto a = table.intern("abcde");
+  const auto b = table.intern("abcde");
+  BOOST_CHECK_NE(address(a), address(b));
+  BOOST_CHECK_EQUAL(table.statistics().size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_intern_table_should_be_thread_safe) {
+  intern_table table(1024);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&]{
+      for (int i = 0; i < 10000; i++) {
+        const auto string = std::to_string(i % 500);
+        BOOST_REQUIRE_EQUAL(table.intern(string).str(), string);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_GT(table.statistics().hit_rate(), 0.9);
+}
+
+/*
+ * interned_string
+ */
+
+BOOST_AUTO_TEST_CASE(json_interned_string_should_compare_contents) {
+  intern_table a;
+  intern_table b;
+  BOOST_CHECK(a.intern("x") == b.intern("x"));
+  BOOST_CHECK(a.intern("x") != b.intern("y"));
+  BOOST_CHECK(a.intern("x") < b.intern("y"));
+  BOOST_CHECK(!(a.intern("x") < a.intern("x")));
+  BOOST_CHECK(interned_string() == a.intern(""));
+}
+
+/*
+ * interned_string_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_interned_string_codec_should_decode_shared_strings) {
+  intern_table table;
+  const auto strings = decode(
+      codec::array<std::vector<interned_string>>(codec::interned_string(table)),
+      R"(["SE","US","SE"])");
+  BOOST_REQUIRE_EQUAL(strings.size(), 3);
+  BOOST_CHECK_EQUAL(address(strings[0]), address(strings[2]));
+  BOOST_CHECK_EQUAL(strings[1].str(), "US");
+  BOOST_CHECK_EQUAL(table.statistics().hits, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_interned_string_codec_should_decode_escaped_strings) {
+  intern_table table;
+  const auto a = decode(codec::interned_string(table), R"("a\nb")");
+  const auto b = decode(codec::interned_string(table), R"("a\u000ab")");
+  BOOST_CHECK_EQUAL(a.str(), "a\nb");
+  BOOST_CHECK_EQUAL(address(a), address(b));
+}
+
+BOOST_AUTO_TEST_CASE(json_interned_string_codec_should_fail_on_invalid_strings) {
+  BOOST_CHECK_THROW(decode<interned_string>("\"abc"), decode_exception);
+  BOOST_CHECK_THROW(decode<interned_string>("abc"), decode_exception);
+  BOOST_CHECK_THROW(decode<interned_string>("\"\\x\""), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_interned_string_codec_should_encode) {
+  intern_table table;
+  BOOST_CHECK_EQUAL(encode(table.intern("a\"b")), "\"a\\\"b\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_interned_string_codec_should_decode_map_keys) {
+  const auto map = decode<std::map<interned_string, int>>(R"({"b":2,"a":1})");
+  BOOST_REQUIRE_EQUAL(map.size(), 2);
+  BOOST_CHECK_EQUAL(map.begin()->first.str(), "a");
+  BOOST_CHECK_EQUAL(encode(map), R"({"a":1,"b":2})");
+}
+
+BOOST_AUTO_TEST_CASE(json_interned_string_codec_should_decode_map_keys_with_table) {
+  intern_table table;
+  const auto codec = codec::map<std::unordered_map<interned_string, interned_string>>(
+      codec::interned_string(table),
+      codec::interned_string(table));
+  const auto map = decode(codec, R"({"a":"a","b":"a"})");
+  BOOST_REQUIRE_EQUAL(map.size(), 2);
+  BOOST_CHECK_EQUAL(address(map.at(table.intern("a"))), address(map.at(table.intern("b"))));
+  BOOST_CHECK_EQUAL(table.statistics().misses, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/lazy.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+std::atomic<int> num_decodes(0);
+
+/**
+ * Decodes arrays of integers like default_codec does, but counts the number
+ * of times that it decodes something.
+ */
+struct counting_codec_t final {
+  using object_type = std::vector<int>;
+
+  object_type decode(decode_context &context) const {
+    num_decodes++;
+    return _codec.decode(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    _codec.encode(context, value);
+  }
+
+ private:
+  decltype(default_codec<std::vector<int>>()) _codec = default_codec<std::vector<int>>();
+};
+
+struct lazy_test_t {
+  std::string id;
+  lazy<std::vector<int>> values;
+};
+
+}  // namespace
+
+template <>
+struct default_codec_t<lazy_test_t> {
+  static codec::object_t<lazy_test_t> codec() {
+    auto codec = codec::object<lazy_test_t>();
+    codec.required("id", &lazy_test_t::id);
+    codec.required("values", &lazy_test_t::values);
+    return codec;
+  }
+};
+
+BOOST_AUTO_TEST_SUITE(codec)
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_decode_on_first_access) {
+  num_decodes = 0;
+  const std::string json = "[1,2,3]";
+  const auto value = decode(lazy(counting_codec_t()), json);
+  BOOST_CHECK(!value.is_decoded());
+  BOOST_CHECK_EQUAL(num_decodes.load(), 0);
+
+  BOOST_CHECK(value.get() == std::vector<int>({ 1, 2, 3 }));
+  BOOST_CHECK_EQUAL(value->size(), 3);
+  BOOST_CHECK(value.is_decoded());
+  BOOST_CHECK_EQUAL(num_decodes.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_decode_once_from_multiple_threads) {
+  num_decodes = 0;
+  const std::string json = "[1,2,3]";
+  const auto value = decode(lazy(counting_codec_t()), json);
+
+  std::vector<std::thread> threads;
+  std::atomic<int> num_correct(0);
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&]{ num_correct += (value->size() == 3); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  BOOST_CHECK_EQUAL(num_correct.load(), 8);
+  BOOST_CHECK_EQUAL(num_decodes.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_fail_on_invalid_json_when_decoding) {
+  BOOST_CHECK_THROW(decode<json::lazy<std::vector<int>>>("[1,2"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_fail_on_wrong_type_when_accessed) {
+  const std::string json = "{\"id\":\"a\",\"values\":[1,\"2\"]}";
+  const auto value = decode<lazy_test_t>(json);
+  BOOST_CHECK_EQUAL(value.id, "a");
+  BOOST_CHECK_THROW(value.values.get(), decode_exception);
+  BOOST_CHECK_THROW(value.values.get(), decode_exception);
+  BOOST_CHECK(!value.values.is_decoded());
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_encode_untouched_value_from_original_json) {
+  num_decodes = 0;
+  const std::string json = "{\"id\":\"a\",\"values\":[ 1, 2 ]}";
+  const auto value = decode<lazy_test_t>(json);
+  BOOST_CHECK_EQUAL(encode(value), json);
+  BOOST_CHECK_EQUAL(measure(value), json.size());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_encode_read_value_from_original_json) {
+  const std::string json = "[ 1, 2 ]";
+  const auto value = decode<json::lazy<std::vector<int>>>(json);
+  BOOST_CHECK_EQUAL(value->size(), 2);
+  BOOST_CHECK_EQUAL(encode(value), json);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_encode_modified_value) {
+  const std::string json = "[ 1, 2 ]";
+  auto value = decode<json::lazy<std::vector<int>>>(json);
+  value->push_back(3);
+  BOOST_CHECK(value.raw().data() == nullptr);
+  BOOST_CHECK_EQUAL(encode(value), "[1,2,3]");
+  BOOST_CHECK_EQUAL(measure(value), 7);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_encode_constructed_value) {
+  const json::lazy<std::vector<int>> value(std::vector<int>{ 4 });
+  BOOST_CHECK(value.is_decoded());
+  BOOST_CHECK_EQUAL(encode(value), "[4]");
+  BOOST_CHECK_EQUAL(encode(json::lazy<std::vector<int>>()), "[]");
+}
+
+/*
+ * Copying
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_share_decoded_value_between_copies) {
+  num_decodes = 0;
+  const std::string json = "[1]";
+  const auto value = decode(lazy(counting_codec_t()), json);
+  const auto copy = value;
+  BOOST_CHECK_EQUAL(&value.get(), &copy.get());
+  BOOST_CHECK_EQUAL(num_decodes.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_lazy_should_copy_value_on_modification) {
+  const std::string json = "[1]";
+  const auto value = decode<json::lazy<std::vector<int>>>(json);
+  auto copy = value;
+  copy->push_back(2);
+  BOOST_CHECK_EQUAL(value->size(), 1);
+  BOOST_CHECK_EQUAL(copy->size(), 2);
+  BOOST_CHECK_EQUAL(encode(value), "[1]");
+  BOOST_CHECK_EQUAL(encode(copy), "[1,2]");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -15,16 +15,48 @@
  */
 
 #include <string>
+#include <type_traits>
 
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/codec/map.hpp>
 #include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/number.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
 #include <spotify/json/test/only_true.hpp>
 
+namespace {
+
+/**
+ * A string codec without a measure method, which map keys must still support.
+ */
+struct unmeasured_string_t {
+  using object_type = std::string;
+
+  object_type decode(spotify::json::decode_context &context) const {
+    return spotify::json::codec::string().decode(context);
+  }
+
+  void encode(spotify::json::encode_context &context, const object_type &value) const {
+    spotify::json::codec::string().encode(context, value);
+  }
+};
+
+}  // namespace
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+template <>
+struct is_string_codec<unmeasured_string_t> : std::true_type {};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
 BOOST_AUTO_TEST_SUITE(codec)
@@ -39,6 +71,12 @@ std::map<std::string, bool> map_parse(const char *not_map) {
   return result;
 }
 
+template <typename T, typename = void>
+struct has_default_codec : std::false_type {};
+
+template <typename T>
+struct has_default_codec<T, decltype(void(default_codec<T>()))> : std::true_type {};
+
 void map_parse_should_fail(const char *not_map) {
   const auto codec = default_codec<std::map<std::string, bool>>();
   auto ctx = decode_context(not_map, not_map + strlen(not_map));
@@ -63,6 +101,14 @@ BOOST_AUTO_TEST_CASE(json_codec_map_should_construct_unordered_map_with_default_
   default_codec<std::unordered_map<std::string, bool>>();
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_map_should_only_have_default_codec_for_string_keys) {
+  static_assert(has_default_codec<std::map<std::string, int>>::value, "");
+  static_assert(!has_default_codec<std::map<int, int>>::value, "");
+  static_assert(!has_default_codec<std::unordered_map<int, int>>::value, "");
+  static_assert(!detail::is_string_codec<number_t<int>>::value, "");
+  static_assert(detail::is_string_codec<string_t>::value, "");
+}
+
 /*
  * Decoding
  */
@@ -123,6 +169,18 @@ BOOST_AUTO_TEST_CASE(json_codec_map_should_respect_should_encode) {
   BOOST_CHECK_EQUAL(encode(codec, map), R"({"a":true})");
 }
 
+/*
+ * Measuring
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_measure_keys_without_measure_method) {
+  std::map<std::string, bool> map;
+  map["a\n"] = true;
+  map["b"] = false;
+  const auto codec = codec::map<std::map<std::string, bool>>(unmeasured_string_t(), boolean());
+  BOOST_CHECK_EQUAL(measure(codec, map), encode(codec, map).size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/arena.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/monotonic_allocator.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct track_t {
+  arena_string uri;
+  arena_vector<arena_string> markets;
+  arena_map<int> counts;
+  std::shared_ptr<arena_string> album;
+};
+
+/**
+ * An arena that records the range of its first block, so that tests can tell
+ * whether memory was taken from it.
+ */
+struct test_arena {
+  test_arena() : arena(64 * 1024) {
+    begin = static_cast<char *>(arena.allocate(1, 1));
+    end = begin + arena.capacity();
+  }
+
+  bool owns(const void *ptr) const {
+    return (ptr >= begin && ptr < end);
+  }
+
+  monotonic_arena arena;
+  const char *begin;
+  const char *end;
+};
+
+const std::string long_string(100, 'x');
+
+}  // namespace
+
+template <>
+struct default_codec_t<track_t> {
+  static codec::object_t<track_t> codec() {
+    auto codec = codec::object<track_t>();
+    codec.required("uri", &track_t::uri);
+    codec.optional("markets", &track_t::markets);
+    codec.optional("counts", &track_t::counts);
+    codec.optional("album", &track_t::album, codec::arena_shared_ptr(default_codec<arena_string>()));
+    return codec;
+  }
+};
+
+/*
+ * monotonic_allocator
+ */
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_allocate_from_arena) {
+  test_arena arena;
+  arena_vector<int> vector(monotonic_allocator<int>(&arena.arena));
+  vector.assign(100, 7);
+  BOOST_CHECK(arena.owns(vector.data()));
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_use_heap_without_arena) {
+  arena_vector<int> vector;
+  vector.assign(100, 7);
+  BOOST_CHECK_EQUAL(vector.size(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_keep_arena_on_move) {
+  test_arena arena;
+  arena_string string(long_string.c_str(), monotonic_allocator<char>(&arena.arena));
+  arena_string moved;
+  moved = std::move(string);
+  BOOST_CHECK(arena.owns(moved.data()));
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_copy_to_heap) {
+  test_arena arena;
+  arena_string string(long_string.c_str(), monotonic_allocator<char>(&arena.arena));
+  const arena_string copy(string);
+  BOOST_CHECK(!arena.owns(copy.data()));
+  BOOST_CHECK(copy.get_allocator().arena() == nullptr);
+  BOOST_CHECK_EQUAL(copy, string);
+}
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_decode_strings_into_arena) {
+  test_arena arena;
+  const auto json = "\"" + long_string + "\"";
+  const auto string = decode<arena_string>(json, arena.arena);
+  BOOST_CHECK(arena.owns(string.data()));
+  BOOST_CHECK_EQUAL(string.c_str(), long_string);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_decode_escaped_strings_into_arena) {
+  test_arena arena;
+  const auto json = "\"\\n" + long_string + "\"";
+  const auto string = decode<arena_string>(json, arena.arena);
+  BOOST_CHECK(arena.owns(string.data()));
+  BOOST_CHECK_EQUAL(string.c_str(), "\n" + long_string);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_decode_containers_into_arena) {
+  test_arena arena;
+  const auto vector = decode<arena_vector<int>>("[1,2,3]", arena.arena);
+  BOOST_CHECK(arena.owns(vector.data()));
+  BOOST_CHECK_EQUAL(vector.size(), 3);
+
+  using arena_set = std::set<int, std::less<int>, monotonic_allocator<int>>;
+  const auto set = decode<arena_set>("[3,1]", arena.arena);
+  BOOST_CHECK(arena.owns(&*set.begin()));
+  BOOST_CHECK_EQUAL(*set.begin(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_decode_maps_into_arena) {
+  test_arena arena;
+  const auto json = "{\"" + long_string + "\":1}";
+  const auto map = decode<arena_map<int>>(json, arena.arena);
+  BOOST_REQUIRE_EQUAL(map.size(), 1);
+  BOOST_CHECK(arena.owns(&*map.begin()));
+  BOOST_CHECK(arena.owns(map.begin()->first.data()));
+  BOOST_CHECK_EQUAL(map.begin()->second, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_decode_arena_shared_ptr_into_arena) {
+  test_arena arena;
+  const auto ptr = decode(codec::arena_shared_ptr(codec::number<int>()), "5", arena.arena);
+  BOOST_CHECK(arena.owns(ptr.get()));
+  BOOST_CHECK_EQUAL(*ptr, 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_decode_arena_shared_ptr_to_heap_without_arena) {
+  const auto ptr = decode(codec::arena_shared_ptr(codec::number<int>()), "5");
+  BOOST_REQUIRE(ptr);
+  BOOST_CHECK_EQUAL(*ptr, 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_leave_shared_ptr_on_heap) {
+  test_arena arena;
+  const auto ptr = decode<std::shared_ptr<int>>("5", arena.arena);
+  BOOST_CHECK(!arena.owns(ptr.get()));
+  BOOST_CHECK_EQUAL(*ptr, 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_decode_objects_into_arena) {
+  test_arena arena;
+  const auto json =
+      "{\"uri\":\"" + long_string + "\",\"markets\":[\"SE\",\"" + long_string + "\"],"
+      "\"counts\":{\"a\":1},\"album\":\"" + long_string + "\"}";
+  const auto track = decode<track_t>(json, arena.arena);
+  BOOST_CHECK(arena.owns(track.uri.data()));
+  BOOST_CHECK(arena.owns(track.markets.data()));
+  BOOST_CHECK(arena.owns(track.markets[1].data()));
+  BOOST_CHECK(arena.owns(&*track.counts.begin()));
+  BOOST_CHECK(arena.owns(track.album.get()));
+  BOOST_CHECK(arena.owns(track.album->data()));
+  BOOST_CHECK_EQUAL(track.markets[0], "SE");
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_decode_to_heap_without_arena) {
+  const auto track = decode<track_t>("{\"uri\":\"" + long_string + "\",\"markets\":[\"SE\"]}");
+  BOOST_CHECK(track.uri.get_allocator().arena() == nullptr);
+  BOOST_CHECK_EQUAL(track.uri.c_str(), long_string);
+  BOOST_CHECK_EQUAL(track.markets.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_leave_std_containers_on_heap) {
+  test_arena arena;
+  const auto json = "[\"" + long_string + "\"]";
+  const auto vector = decode<std::vector<std::string>>(json, arena.arena);
+  BOOST_CHECK(!arena.owns(vector.data()));
+  BOOST_CHECK(!arena.owns(vector[0].data()));
+}
+
+BOOST_AUTO_TEST_CASE(json_monotonic_allocator_should_encode_arena_containers) {
+  test_arena arena;
+  const std::string json = R"({"a":["b","c"]})";
+  const auto map = decode<arena_map<arena_vector<arena_string>>>(json, arena.arena);
+  BOOST_CHECK_EQUAL(encode(map), json);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
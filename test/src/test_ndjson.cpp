@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/ndjson.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct record_t {
+  std::string name;
+  int count;
+};
+
+}  // namespace
+
+template <>
+struct default_codec_t<record_t> {
+  static codec::object_t<record_t> codec() {
+    auto codec = codec::object<record_t>();
+    codec.required("name", &record_t::name);
+    codec.required("count", &record_t::count);
+    return codec;
+  }
+};
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_decode_ndjson_should_decode_records) {
+  const auto result = decode_ndjson<record_t>(
+      "{\"name\":\"a\",\"count\":1}\n"
+      "{\"name\":\"b\\nc\",\"count\":2}\n");
+  BOOST_CHECK(result.errors.empty());
+  BOOST_REQUIRE_EQUAL(result.values.size(), 2);
+  BOOST_CHECK_EQUAL(result.values[0].name, "a");
+  BOOST_CHECK_EQUAL(result.values[1].name, "b\nc");
+  BOOST_CHECK_EQUAL(result.values[1].count, 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_ndjson_should_accept_missing_final_newline) {
+  const auto result = decode_ndjson(codec::number<int>(), "1\n2");
+  BOOST_CHECK(result.values == std::vector<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_ndjson_should_skip_blank_lines_and_carriage_returns) {
+  const auto result = decode_ndjson(codec::number<int>(), "\n1\r\n  \r\n\t2 \n\n");
+  BOOST_CHECK(result.errors.empty());
+  BOOST_CHECK(result.values == std::vector<int>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_ndjson_should_decode_into_callback) {
+  const std::string ndjson = "[1,2]\n[]\n[3]\n";
+  std::vector<std::vector<int>> values;
+  const auto errors = decode_ndjson(
+      default_codec<std::vector<int>>(),
+      ndjson.data(),
+      ndjson.size(),
+      [&](std::vector<int> &&value) { values.push_back(std::move(value)); });
+  BOOST_CHECK(errors.empty());
+  BOOST_REQUIRE_EQUAL(values.size(), 3);
+  BOOST_CHECK(values[2] == std::vector<int>({ 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_ndjson_should_report_errors_per_line) {
+  std::size_t x_offset = 0;
+  try {
+    decode(codec::number<int>(), "x");
+  } catch (const decode_exception &exception) {
+    x_offset = exception.offset();
+  }
+
+  const auto result = decode_ndjson(codec::number<int>(), "1\nx\n3\n4 5\n7\n\"8");
+  BOOST_CHECK(result.values == std::vector<int>({ 1, 3, 7 }));
+  BOOST_REQUIRE_EQUAL(result.errors.size(), 3);
+  BOOST_CHECK_EQUAL(result.errors[0].line, 2);
+  BOOST_CHECK_EQUAL(result.errors[0].offset, 2 + x_offset);
+  BOOST_CHECK_EQUAL(result.errors[1].line, 4);
+  BOOST_CHECK_EQUAL(result.errors[1].offset, 8);
+  BOOST_CHECK_EQUAL(result.errors[1].what, "Unexpected trailing input");
+  BOOST_CHECK_EQUAL(result.errors[2].line, 6);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_ndjson_should_not_let_records_span_lines) {
+  const auto result = decode_ndjson(default_codec<std::vector<int>>(), "[1,\n2]\n[3]");
+  BOOST_REQUIRE_EQUAL(result.values.size(), 1);
+  BOOST_CHECK_EQUAL(result.errors.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_ndjson_should_report_physical_line_numbers) {
+  const auto result = decode_ndjson(codec::string(), "\"a\nb\"\n1\n2\n\"x\"\n");
+  BOOST_CHECK(result.values == std::vector<std::string>({ "a\nb", "x" }));
+  BOOST_REQUIRE_EQUAL(result.errors.size(), 2);
+  BOOST_CHECK_EQUAL(result.errors[0].line, 3);
+  BOOST_CHECK_EQUAL(result.errors[0].offset, 6);
+  BOOST_CHECK_EQUAL(result.errors[1].line, 4);
+  BOOST_CHECK_EQUAL(result.errors[1].offset, 8);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_ndjson_should_resume_after_unterminated_string) {
+  const auto result = decode_ndjson(codec::number<int>(), "1\n\"2\n3\n4\n");
+  BOOST_CHECK(result.values == std::vector<int>({ 1, 3, 4 }));
+  BOOST_REQUIRE_EQUAL(result.errors.size(), 1);
+  BOOST_CHECK_EQUAL(result.errors[0].line, 2);
+}
+
+/*
+ * Parallel decoding
+ */
+
+namespace {
+
+std::string generate_ndjson(const int records) {
+  std::string ndjson;
+  for (int i = 0; i < records; i++) {
+    if (i % 97 == 13) {
+      ndjson += "{\"name\":\"broken\"}\n";
+    } else if (i % 89 == 7) {
+      ndjson += "\n";
+    } else {
+      ndjson += "{\"name\":\"n" + std::to_string(i) + "\",\"count\":" + std::to_string(i) + "}\n";
+    }
+  }
+  return ndjson;
+}
+
+void check_same_errors(const std::vector<ndjson_error> &a, const std::vector<ndjson_error> &b) {
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  for (std::size_t i = 0; i < a.size(); i++) {
+    BOOST_CHECK_EQUAL(a[i].line, b[i].line);
+    BOOST_CHECK_EQUAL(a[i].offset, b[i].offset);
+    BOOST_CHECK_EQUAL(a[i].what, b[i].what);
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_ndjson_should_match_serial_decoding) {
+  const auto ndjson = generate_ndjson(2000);
+  const auto codec = default_codec<record_t>();
+  const auto serial = decode_ndjson(codec, ndjson);
+  BOOST_REQUIRE(!serial.errors.empty());
+
+  for (const std::size_t chunk_size : { 1, 100, 4096, 1 << 20 }) {
+    parallel_options options;
+    options.threads = 4;
+    options.chunk_size = chunk_size;
+    const auto parallel = parallel_decode_ndjson(codec, ndjson, options);
+    BOOST_REQUIRE_EQUAL(parallel.values.size(), serial.values.size());
+    for (std::size_t i = 0; i < serial.values.size(); i++) {
+      BOOST_REQUIRE_EQUAL(parallel.values[i].name, serial.values[i].name);
+      BOOST_REQUIRE_EQUAL(parallel.values[i].count, serial.values[i].count);
+    }
+    check_same_errors(parallel.errors, serial.errors);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_ndjson_should_match_serial_decoding_with_newlines_in_strings) {
+  std::string ndjson;
+  for (int i = 0; i < 50; i++) {
+    ndjson += "\"a\nb\"\n1\n2\n\"x\"\n\"y\n3\n\"z\n\"w" + std::to_string(i) + "\"\n";
+  }
+  ndjson += "\"unterminated\n4\n\"5\"";
+
+  const auto codec = codec::string();
+  const auto serial = decode_ndjson(codec, ndjson);
+  for (const std::size_t chunk_size : { 1, 2, 3, 5, 8, 13, 100, 1 << 20 }) {
+    parallel_options options;
+    options.threads = 4;
+    options.chunk_size = chunk_size;
+    const auto parallel = parallel_decode_ndjson(codec, ndjson, options);
+    BOOST_CHECK(parallel.values == serial.values);
+    check_same_errors(parallel.errors, serial.errors);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_ndjson_should_decode_into_concurrent_callback) {
+  const auto ndjson = generate_ndjson(2000);
+  const auto codec = default_codec<record_t>();
+  const auto serial = decode_ndjson(codec, ndjson);
+
+  parallel_options options;
+  options.threads = 4;
+  options.chunk_size = 1000;
+  std::mutex mutex;
+  long long sum = 0;
+  std::size_t count = 0;
+  const auto errors = parallel_decode_ndjson(codec, ndjson.data(), ndjson.size(), options, [&](record_t &&record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    sum += record.count;
+    count++;
+  });
+
+  long long serial_sum = 0;
+  for (const auto &record : serial.values) {
+    serial_sum += record.count;
+  }
+
+  BOOST_CHECK_EQUAL(count, serial.values.size());
+  BOOST_CHECK_EQUAL(sum, serial_sum);
+  check_same_errors(errors, serial.errors);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_ndjson_should_decode_empty_input) {
+  const auto result = parallel_decode_ndjson(codec::number<int>(), std::string());
+  BOOST_CHECK(result.values.empty());
+  BOOST_CHECK(result.errors.empty());
+}
+
+/*
+ * Filtering
+ */
+
+BOOST_AUTO_TEST_CASE(json_filter_ndjson_should_decode_only_matching_records) {
+  const auto result = filter_ndjson(default_codec<record_t>(), std::string(
+      "{\"name\":\"heartbeat\",\"count\":1}\n"
+      "{\"name\":\"play\",\"count\":2}\n"
+      "{\"name\":\"heartbeat\",\"count\":\"invalid\"}\n"
+      "\n"
+      "{\"name\":\"play\",\"count\":4}\n"), negate(field_equals("/name", "heartbeat")));
+  BOOST_CHECK(result.errors.empty());
+  BOOST_REQUIRE_EQUAL(result.values.size(), 2);
+  BOOST_CHECK_EQUAL(result.values[0].count, 2);
+  BOOST_CHECK_EQUAL(result.values[1].count, 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_filter_ndjson_should_report_errors_from_filter_and_codec) {
+  const std::string ndjson =
+      "{\"name\":\"a\",\"count\":1}\n"
+      "{\"x\":[,],\"name\":\"a\"}\n"
+      "{\"name\":\"a\"}\n";
+  const auto result = filter_ndjson(default_codec<record_t>(), ndjson, field_equals("/name", "a"));
+  BOOST_CHECK_EQUAL(result.values.size(), 1);
+  BOOST_REQUIRE_EQUAL(result.errors.size(), 2);
+  BOOST_CHECK_EQUAL(result.errors[0].line, 2);
+  BOOST_CHECK_EQUAL(result.errors[0].offset, ndjson.find("[,]") + 1);
+  BOOST_CHECK_EQUAL(result.errors[1].line, 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_filter_ndjson_should_match_serial_filtering) {
+  const auto ndjson = generate_ndjson(2000);
+  const auto codec = default_codec<record_t>();
+  const auto filter = any_of(field_starts_with("/name", "n1"), field_equals("/name", "broken"));
+  const auto serial = filter_ndjson(codec, ndjson, filter);
+  BOOST_REQUIRE(!serial.errors.empty());
+  BOOST_REQUIRE(!serial.values.empty());
+
+  parallel_options options;
+  options.threads = 4;
+  options.chunk_size = 1000;
+  const auto parallel = parallel_filter_ndjson(codec, ndjson.data(), ndjson.size(), filter, options);
+  BOOST_REQUIRE_EQUAL(parallel.values.size(), serial.values.size());
+  for (std::size_t i = 0; i < serial.values.size(); i++) {
+    BOOST_REQUIRE_EQUAL(parallel.values[i].name, serial.values[i].name);
+  }
+  check_same_errors(parallel.errors, serial.errors);
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_encode_ndjson_should_encode_one_value_per_line) {
+  const std::vector<record_t> records{ { "a", 1 }, { "b\nc", 2 } };
+  const auto ndjson = encode_ndjson(records);
+  BOOST_CHECK_EQUAL(ndjson,
+      "{\"name\":\"a\",\"count\":1}\n"
+      "{\"name\":\"b\\nc\",\"count\":2}\n");
+
+  const auto result = decode_ndjson<record_t>(ndjson);
+  BOOST_CHECK(result.errors.empty());
+  BOOST_CHECK_EQUAL(result.values.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_ndjson_should_encode_empty_input) {
+  BOOST_CHECK_EQUAL(encode_ndjson(codec::number<int>(), std::vector<int>()), "");
+}
+
+BOOST_AUTO_TEST_CASE(json_encode_ndjson_should_append_to_context) {
+  const std::vector<int> values{ 1, 2 };
+  encode_context context;
+  encode_ndjson(context, codec::number<int>(), values.begin(), values.end());
+  encode_ndjson(context, codec::number<int>(), values.begin(), values.end());
+  BOOST_CHECK_EQUAL(std::string(static_cast<const char *>(context.data()), context.size()), "1\n2\n1\n2\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -145,6 +145,20 @@ BOOST_AUTO_TEST_CASE(json_codec_number_should_not_encode_infinity) {
   BOOST_CHECK_THROW(encode(number<double>(), +INFINITY), encode_exception);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_number_should_encode_into_buffer_of_exact_size) {
+  char buffer[3];
+  BOOST_REQUIRE_EQUAL(encode(0.5, buffer, sizeof(buffer)), 3);
+  BOOST_CHECK_EQUAL(std::string(buffer, 3), "0.5");
+  BOOST_CHECK_EQUAL(measure(0.5), 3);
+  BOOST_CHECK_EQUAL(measure(-1.25e-100), encode(-1.25e-100).size());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_number_should_not_encode_not_a_number_into_buffer) {
+  char buffer[64];
+  BOOST_CHECK_THROW(encode(number<double>(), NAN, buffer, 1), encode_exception);
+  BOOST_CHECK_THROW(measure(number<double>(), NAN), encode_exception);
+}
+
 /*
  * Decoding Signed Integers
  */
@@ -253,6 +253,26 @@ BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_dummy_fields) {
   BOOST_CHECK_EQUAL(encode(codec, example_t()), R"({"dummy":""})");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_object_should_share_fields_between_copies) {
+  const auto codec = example_codec();
+  auto copy = codec;
+  copy.optional("extra", string());
+
+  example_t example;
+  example.value = "v";
+  BOOST_CHECK_EQUAL(encode(codec, example), R"({"simple":{"value":""},"value":"v"})");
+  BOOST_CHECK_EQUAL(encode(copy, example), R"({"simple":{"value":""},"value":"v","extra":""})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_keep_fields_when_moved_from) {
+  auto codec = example_codec();
+  const auto moved = std::move(codec);
+
+  example_t example;
+  example.value = "v";
+  BOOST_CHECK_EQUAL(encode(codec, example), encode(moved, example));
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_getter_field) {
   const auto codec = getset_codec();
   getset_t getset;
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/parallel_decode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+parallel_options small_chunks(const std::size_t chunk_size) {
+  parallel_options options;
+  options.threads = 4;
+  options.chunk_size = chunk_size;
+  return options;
+}
+
+/**
+ * Decode the JSON both serially and in parallel with all chunk sizes up to the
+ * size of the input, and check that the results or the errors are identical.
+ */
+template <typename codec_type>
+void check_same_as_serial(const codec_type &codec, const std::string &json) {
+  typename codec_type::object_type expected;
+  std::string expected_error;
+  std::size_t expected_offset = 0;
+  try {
+    expected = decode(codec, json);
+  } catch (const decode_exception &exception) {
+    expected_error = exception.what();
+    expected_offset = exception.offset();
+  }
+
+  for (std::size_t chunk_size = 1; chunk_size <= json.size() + 1; chunk_size++) {
+    try {
+      const auto actual = parallel_decode(codec, json, small_chunks(chunk_size));
+      BOOST_REQUIRE(expected_error.empty());
+      BOOST_REQUIRE(actual == expected);
+    } catch (const decode_exception &exception) {
+      BOOST_REQUIRE_EQUAL(exception.what(), expected_error);
+      BOOST_REQUIRE_EQUAL(exception.offset(), expected_offset);
+    }
+  }
+}
+
+std::string generate_array(const int count) {
+  std::string json = "[";
+  for (int i = 0; i < count; i++) {
+    json += (i ? ", " : "");
+    json += "{\"id\":\"" + std::to_string(i) + "\",\"tags\":[\"a,]\\\"\",\"}{\\\\\"]}";
+  }
+  return json + "]";
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_should_decode_arrays) {
+  const auto codec = default_codec<std::vector<int>>();
+  check_same_as_serial(codec, "[]");
+  check_same_as_serial(codec, " [ ] ");
+  check_same_as_serial(codec, "[1]");
+  check_same_as_serial(codec, "[1,2,3]");
+  check_same_as_serial(codec, "\n[ 1 ,\t2 ,3 ]\r\n");
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_should_decode_nested_values) {
+  using tags = std::map<std::string, std::vector<std::string>>;
+  check_same_as_serial(default_codec<std::vector<tags>>(), generate_array(20));
+  check_same_as_serial(
+      codec::array<std::vector<std::string>>(codec::raw<std::string>()),
+      "[[1,[2]],{\"a\":{\"b\":\",\"}},\"\\\\\",\"\\\"]\",null]");
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_should_decode_other_containers) {
+  check_same_as_serial(default_codec<std::set<int>>(), "[3,1,2,1]");
+  check_same_as_serial(default_codec<std::array<int, 3>>(), "[1,2,3]");
+  check_same_as_serial(default_codec<std::array<int, 3>>(), "[1,2]");
+  check_same_as_serial(default_codec<std::array<int, 3>>(), "[1,2,3,4]");
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_should_fail_like_serial_decode) {
+  const auto codec = default_codec<std::vector<int>>();
+  check_same_as_serial(codec, "");
+  check_same_as_serial(codec, "{}");
+  check_same_as_serial(codec, "[1,]");
+  check_same_as_serial(codec, "[,1]");
+  check_same_as_serial(codec, "[1 2]");
+  check_same_as_serial(codec, "[1,\"2\",x]");
+  check_same_as_serial(codec, "[1,2");
+  check_same_as_serial(codec, "[1}");
+  check_same_as_serial(codec, "[1] 2");
+  check_same_as_serial(codec, "[[1]]");
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_decode_should_decode_large_arrays) {
+  std::string json = "[";
+  std::vector<int> expected;
+  for (int i = 0; i < 100000; i++) {
+    json += (i ? "," : "") + std::to_string(i);
+    expected.push_back(i);
+  }
+  json += "]";
+
+  BOOST_CHECK(parallel_decode<std::vector<int>>(json, small_chunks(1000)) == expected);
+  BOOST_CHECK(parallel_decode<std::vector<int>>(json) == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/parallel_encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+/**
+ * Encode the value both serially and in parallel with different numbers of
+ * threads (and thus partitions), into a string and into segments, and check
+ * that the output is identical.
+ */
+template <typename codec_type>
+void check_same_as_serial(const codec_type &codec, const typename codec_type::object_type &value) {
+  const auto expected = encode(codec, value);
+  for (const std::size_t threads : { 1, 2, 3, 8 }) {
+    parallel_options options;
+    options.threads = threads;
+    BOOST_REQUIRE_EQUAL(parallel_encode(codec, value, options), expected);
+    BOOST_REQUIRE_EQUAL(parallel_encode_segments(codec, value, options).str(), expected);
+    BOOST_REQUIRE_EQUAL(parallel_encode_segments(codec, value, options, 8).str(), expected);
+  }
+}
+
+std::vector<std::shared_ptr<int>> sparse_vector(const int size, const int every) {
+  std::vector<std::shared_ptr<int>> vector;
+  for (int i = 0; i < size; i++) {
+    vector.push_back(i % every == 0 ? std::make_shared<int>(i) : nullptr);
+  }
+  return vector;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_parallel_encode_should_encode_arrays) {
+  const auto codec = default_codec<std::vector<int>>();
+  check_same_as_serial(codec, {});
+  check_same_as_serial(codec, { 1 });
+  check_same_as_serial(codec, { 1, 2, 3 });
+
+  std::vector<int> large;
+  for (int i = 0; i < 10000; i++) {
+    large.push_back(i * 7);
+  }
+  check_same_as_serial(codec, large);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_encode_should_encode_arrays_with_omitted_elements) {
+  const auto codec = default_codec<std::vector<std::shared_ptr<int>>>();
+  check_same_as_serial(codec, sparse_vector(100, 1000));  // only the first element
+  check_same_as_serial(codec, sparse_vector(100, 7));
+  check_same_as_serial(codec, { nullptr, nullptr, nullptr });
+  check_same_as_serial(codec, { std::make_shared<int>(1), nullptr, nullptr, nullptr });
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_encode_should_encode_maps) {
+  std::map<std::string, std::string> map;
+  std::unordered_map<std::string, std::string> unordered_map;
+  for (int i = 0; i < 1000; i++) {
+    map[std::to_string(i)] = std::string(i % 20, 'x') + "\"";
+    unordered_map[std::to_string(i)] = std::to_string(i);
+  }
+
+  check_same_as_serial(default_codec<std::map<std::string, std::string>>(), {});
+  check_same_as_serial(default_codec<std::map<std::string, std::string>>(), map);
+  check_same_as_serial(default_codec<std::unordered_map<std::string, std::string>>(), unordered_map);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_encode_should_encode_maps_with_key_codec) {
+  using map_type = std::map<std::vector<char>, int>;
+  map_type map;
+  for (int i = 0; i < 1000; i++) {
+    const auto key = std::to_string(i);
+    map[std::vector<char>(key.begin(), key.end())] = i;
+  }
+
+  const auto codec = codec::map<map_type>(codec::string_ref<std::vector<char>>(), codec::number<int>());
+  check_same_as_serial(codec, map);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_encode_should_encode_with_default_codec) {
+  const std::vector<std::string> vector{ "a", "b" };
+  BOOST_CHECK_EQUAL(parallel_encode(vector), "[\"a\",\"b\"]");
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_encode_segments_should_encode_serially_on_one_thread) {
+  const std::vector<int> vector{ 1, 2, 3 };
+  parallel_options options;
+  options.threads = 1;
+  const auto output = parallel_encode_segments(default_codec<std::vector<int>>(), vector, options);
+  BOOST_REQUIRE_EQUAL(output.segments().size(), 1);
+  BOOST_CHECK_EQUAL(output.str(), "[1,2,3]");
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_encode_segments_should_reference_large_values) {
+  const auto a = "\"" + std::string(100, 'a') + "\"";
+  const auto c = "\"" + std::string(100, 'c') + "\"";
+  const std::vector<codec::raw_ref> vector{
+      codec::raw_ref(a.data(), a.size()),
+      codec::raw_ref("\"b\"", 3),
+      codec::raw_ref(c.data(), c.size()) };
+  parallel_options options;
+  options.threads = 2;
+  const auto output = parallel_encode_segments(default_codec<std::vector<codec::raw_ref>>(), vector, options, 64);
+  BOOST_CHECK_EQUAL(output.str(), encode(vector));
+  BOOST_CHECK_EQUAL(output.size(), encode(vector).size());
+
+  auto referenced = 0;
+  for (const auto &segment : output.segments()) {
+    referenced += (segment.data == a.data() || segment.data == c.data());
+  }
+  BOOST_CHECK_EQUAL(referenced, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/detail/parallel_for.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(detail)
+
+namespace {
+
+void check_runs_each_task_once(const std::size_t threads, const std::size_t num_tasks) {
+  std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[num_tasks + 1]);
+  for (std::size_t i = 0; i <= num_tasks; i++) {
+    runs[i] = 0;
+  }
+
+  parallel_for(threads, num_tasks, [&](const std::size_t index) { runs[index]++; });
+  for (std::size_t i = 0; i < num_tasks; i++) {
+    BOOST_REQUIRE_EQUAL(runs[i].load(), 1);
+  }
+  BOOST_CHECK_EQUAL(runs[num_tasks].load(), 0);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_run_each_task_once) {
+  check_runs_each_task_once(0, 1000);
+  check_runs_each_task_once(1, 1000);
+  check_runs_each_task_once(4, 1000);
+  check_runs_each_task_once(7, 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_accept_zero_tasks) {
+  check_runs_each_task_once(4, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_run_on_multiple_threads) {
+  std::atomic<int> running(0);
+  std::atomic<int> max_running(0);
+  parallel_for(4, 4, [&](std::size_t) {
+    const auto now_running = ++running;
+    for (int seen = max_running; seen < now_running && !max_running.compare_exchange_weak(seen, now_running);) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    running--;
+  });
+  BOOST_CHECK_GT(max_running.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_bound_number_of_threads) {
+  std::atomic<int> running(0);
+  std::atomic<int> max_running(0);
+  check_runs_each_task_once(1000, 1000);
+  parallel_for(1000, 200, [&](std::size_t) {
+    const auto now_running = ++running;
+    for (int seen = max_running; seen < now_running && !max_running.compare_exchange_weak(seen, now_running);) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    running--;
+  });
+  BOOST_CHECK_LE(std::size_t(max_running.load()), max_thread_count());
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_balance_uneven_tasks) {
+  // All slow tasks start out on the first thread; the others must steal them.
+  std::atomic<int> done(0);
+  const auto before = std::chrono::steady_clock::now();
+  parallel_for(4, 64, [&](const std::size_t index) {
+    if (index < 16) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    done++;
+  });
+  const auto duration = std::chrono::steady_clock::now() - before;
+  BOOST_CHECK_EQUAL(done.load(), 64);
+  BOOST_CHECK_LT(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), 150);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_rethrow_exceptions) {
+  std::atomic<int> runs(0);
+  BOOST_CHECK_THROW(
+      parallel_for(4, 1000, [&](const std::size_t index) {
+        runs++;
+        if (index == 10) {
+          throw std::runtime_error("failure");
+        }
+      }),
+      std::runtime_error);
+  BOOST_CHECK_LE(runs.load(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_allow_nested_calls) {
+  std::atomic<int> runs(0);
+  parallel_for(4, 8, [&](std::size_t) {
+    parallel_for(4, 8, [&](std::size_t) { runs++; });
+  });
+  BOOST_CHECK_EQUAL(runs.load(), 64);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_allow_concurrent_calls) {
+  std::atomic<int> runs(0);
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 4; i++) {
+    callers.emplace_back([&]{
+      for (int j = 0; j < 50; j++) {
+        parallel_for(3, 10, [&](std::size_t) { runs++; });
+      }
+    });
+  }
+  for (auto &caller : callers) {
+    caller.join();
+  }
+  BOOST_CHECK_EQUAL(runs.load(), 4 * 50 * 10);
+}
+
+BOOST_AUTO_TEST_CASE(json_parallel_for_should_have_default_thread_count) {
+  BOOST_CHECK_GE(default_thread_count(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // detail
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
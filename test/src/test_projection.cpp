@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/projection.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct artist_t {
+  std::string name;
+  int popularity = 0;
+};
+
+struct track_t {
+  std::string uri;
+  std::string name;
+  int duration = 0;
+  std::vector<artist_t> artists;
+  std::map<std::string, artist_t> by_role;
+  std::shared_ptr<artist_t> composer;
+};
+
+codec::object_t<artist_t> artist_codec() {
+  codec::object_t<artist_t> codec;
+  codec.required("name", &artist_t::name);
+  codec.optional("popularity", &artist_t::popularity);
+  return codec;
+}
+
+codec::object_t<track_t> track_codec() {
+  codec::object_t<track_t> codec;
+  codec.required("uri", &track_t::uri);
+  codec.optional("name", &track_t::name);
+  codec.optional("duration", &track_t::duration);
+  codec.optional("artists", &track_t::artists, codec::array<std::vector<artist_t>>(artist_codec()));
+  codec.optional("by_role", &track_t::by_role, codec::map<std::map<std::string, artist_t>>(artist_codec()));
+  codec.optional("composer", &track_t::composer, codec::shared_ptr(artist_codec()));
+  return codec;
+}
+
+const std::string track_json =
+    "{\"uri\":\"spotify:track:1\",\"name\":\"Song\",\"duration\":180,"
+    "\"artists\":[{\"name\":\"A\",\"popularity\":1},{\"name\":\"B\",\"popularity\":2}],"
+    "\"by_role\":{\"lead\":{\"name\":\"C\",\"popularity\":3}},"
+    "\"composer\":{\"name\":\"D\",\"popularity\":4}}";
+
+}  // namespace
+
+/*
+ * projection
+ */
+
+BOOST_AUTO_TEST_CASE(json_projection_should_build_field_tree) {
+  const projection p({ "a", "b/c", "b/d", "e~1f" });
+  const auto &fields = p.root().fields;
+  BOOST_CHECK_EQUAL(fields.size(), 3);
+  BOOST_CHECK(!fields.at("a"));
+  BOOST_CHECK(!fields.at("e/f"));
+  BOOST_REQUIRE(fields.at("b"));
+  BOOST_CHECK_EQUAL(fields.at("b")->fields.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_projection_should_let_shorter_paths_select_whole_value) {
+  BOOST_CHECK(!projection({ "a/b", "a" }).root().fields.at("a"));
+  BOOST_CHECK(!projection({ "a", "a/b" }).root().fields.at("a"));
+}
+
+BOOST_AUTO_TEST_CASE(json_projection_should_reject_invalid_paths) {
+  BOOST_CHECK_THROW(projection({ "a~2" }), std::invalid_argument);
+}
+
+/*
+ * decode
+ */
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_decode_selected_fields) {
+  const auto track = decode(track_codec(), track_json, projection({ "uri", "duration" }));
+  BOOST_CHECK_EQUAL(track.uri, "spotify:track:1");
+  BOOST_CHECK_EQUAL(track.duration, 180);
+  BOOST_CHECK_EQUAL(track.name, "");
+  BOOST_CHECK(track.artists.empty());
+  BOOST_CHECK(track.by_role.empty());
+  BOOST_CHECK(!track.composer);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_nest_through_arrays_maps_and_pointers) {
+  const projection p({ "uri", "artists/name", "by_role/popularity", "composer/name" });
+  const auto track = decode(track_codec(), track_json, p);
+  BOOST_REQUIRE_EQUAL(track.artists.size(), 2);
+  BOOST_CHECK_EQUAL(track.artists[1].name, "B");
+  BOOST_CHECK_EQUAL(track.artists[1].popularity, 0);
+  BOOST_CHECK_EQUAL(track.by_role.at("lead").name, "");
+  BOOST_CHECK_EQUAL(track.by_role.at("lead").popularity, 3);
+  BOOST_REQUIRE(track.composer);
+  BOOST_CHECK_EQUAL(track.composer->name, "D");
+  BOOST_CHECK_EQUAL(track.composer->popularity, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_decode_whole_selected_values) {
+  const auto track = decode(track_codec(), track_json, projection({ "uri", "artists" }));
+  BOOST_REQUIRE_EQUAL(track.artists.size(), 2);
+  BOOST_CHECK_EQUAL(track.artists[0].name, "A");
+  BOOST_CHECK_EQUAL(track.artists[0].popularity, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_apply_to_elements_of_root_array) {
+  const auto codec = codec::array<std::vector<artist_t>>(artist_codec());
+  const auto artists = decode(codec, "[{\"name\":\"A\",\"popularity\":1}]", projection({ "popularity" }));
+  BOOST_REQUIRE_EQUAL(artists.size(), 1);
+  BOOST_CHECK_EQUAL(artists[0].name, "");
+  BOOST_CHECK_EQUAL(artists[0].popularity, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_not_decode_unselected_fields) {
+  const std::string json = "{\"uri\":\"u\",\"duration\":\"not a number\",\"artists\":[{}]}";
+  BOOST_CHECK_EQUAL(decode(track_codec(), json, projection({ "uri" })).uri, "u");
+  BOOST_CHECK_THROW(decode(track_codec(), json, projection({ "uri", "duration" })), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_only_require_selected_fields) {
+  const std::string json = "{\"name\":\"Song\"}";
+  BOOST_CHECK_EQUAL(decode(track_codec(), json, projection({ "name" })).name, "Song");
+  BOOST_CHECK_THROW(decode(track_codec(), json, projection({ "name", "uri" })), decode_exception);
+
+  const std::string nested = "{\"uri\":\"u\",\"artists\":[{\"popularity\":1}]}";
+  BOOST_CHECK_NO_THROW(decode(track_codec(), nested, projection({ "uri", "artists/popularity" })));
+  BOOST_CHECK_THROW(decode(track_codec(), nested, projection({ "uri", "artists/name" })), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_ignore_unknown_fields) {
+  const auto track = decode(track_codec(), track_json, projection({ "uri", "nope", "artists/nope" }));
+  BOOST_CHECK_EQUAL(track.uri, "spotify:track:1");
+  BOOST_CHECK_EQUAL(track.artists.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_share_codec_between_projections) {
+  const auto codec = track_codec();
+  const projection uris({ "uri" });
+  const projection names({ "name" });
+  BOOST_CHECK_EQUAL(decode(codec, track_json, uris).name, "");
+  BOOST_CHECK_EQUAL(decode(codec, track_json, names).name, "Song");
+  BOOST_CHECK_EQUAL(decode(codec, track_json).artists.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_with_projection_should_restore_projection_after_failure) {
+  const projection p({ "artists/popularity", "duration" });
+  const std::string json = "{\"artists\":[{\"popularity\":\"x\"}]}";
+  decode_context failing(json.data(), json.size());
+  failing.projection = &p.root();
+  BOOST_CHECK_THROW(track_codec().decode(failing), decode_exception);
+  BOOST_CHECK_EQUAL(failing.projection, &p.root());
+}
+
+BOOST_AUTO_TEST_CASE(json_try_decode_with_projection_should_return_false_on_failure) {
+  track_t track;
+  BOOST_CHECK(try_decode(track, track_codec(), track_json, projection({ "uri" })));
+  BOOST_CHECK_EQUAL(track.uri, "spotify:track:1");
+  BOOST_CHECK(!try_decode(track, track_codec(), std::string("{}"), projection({ "uri" })));
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -153,6 +153,22 @@ BOOST_AUTO_TEST_CASE(json_codec_raw_should_encode_vector_as_is) {
   BOOST_CHECK_EQUAL(encode(raw<std::vector<uint8_t>>(), vec), data);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_raw_should_reference_large_values) {
+  const std::string raw(1000, '1');
+  const std::vector<raw_ref> refs{ raw_ref(raw.data(), raw.size()), raw_ref("2", 1) };
+
+  encode_context context;
+  context.set_reference_threshold(512);
+  default_codec<std::vector<raw_ref>>().encode(context, refs);
+
+  const auto segments = context.segments();
+  BOOST_REQUIRE_EQUAL(segments.size(), 3);
+  BOOST_CHECK_EQUAL(std::string(static_cast<const char *>(segments[0].data), segments[0].size), "[");
+  BOOST_CHECK_EQUAL(segments[1].data, raw.data());
+  BOOST_CHECK_EQUAL(segments[1].size, raw.size());
+  BOOST_CHECK_EQUAL(std::string(static_cast<const char *>(segments[2].data), segments[2].size), ",2]");
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_raw_should_encode_with_separators) {
   std::string raw = "{}";
   raw_ref ref(raw.data(), raw.size());
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/record_filter.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+const std::string record =
+    "{\"event\":\"play\",\"uri\":\"spotify:track:1\",\"ms\":1500,"
+    "\"user\":{\"country\":\"SE\",\"premium\":null},\"esc\":\"a\\\"b\"}";
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_field_equals_should_compare_strings) {
+  BOOST_CHECK(field_equals("/event", "play")(record));
+  BOOST_CHECK(field_equals("/user/country", "SE")(record));
+  BOOST_CHECK(field_equals("/esc", "a\"b")(record));
+  BOOST_CHECK(!field_equals("/event", "pla")(record));
+  BOOST_CHECK(!field_equals("/event", "playing")(record));
+  BOOST_CHECK(!field_equals("/ms", "1500")(record));
+  BOOST_CHECK(!field_equals("/missing", "play")(record));
+}
+
+BOOST_AUTO_TEST_CASE(json_field_starts_with_should_compare_prefixes) {
+  BOOST_CHECK(field_starts_with("/uri", "spotify:track:")(record));
+  BOOST_CHECK(field_starts_with("/uri", "")(record));
+  BOOST_CHECK(field_starts_with("/esc", "a\"")(record));
+  BOOST_CHECK(!field_starts_with("/uri", "spotify:album:")(record));
+  BOOST_CHECK(!field_starts_with("/event", "play!")(record));
+  BOOST_CHECK(!field_starts_with("/user", "{")(record));
+}
+
+BOOST_AUTO_TEST_CASE(json_field_in_range_should_compare_numbers) {
+  BOOST_CHECK(field_in_range("/ms", 1000, 2000)(record));
+  BOOST_CHECK(field_in_range("/ms", 1500, 1500)(record));
+  BOOST_CHECK(!field_in_range("/ms", 0, 1499.5)(record));
+  BOOST_CHECK(!field_in_range("/event", 0, 1)(record));
+  BOOST_CHECK(!field_in_range("/missing", 0, 1)(record));
+  BOOST_CHECK(field_in_range("/0", -2, -1)("[-1.5e0]"));
+}
+
+BOOST_AUTO_TEST_CASE(json_field_exists_should_check_presence) {
+  BOOST_CHECK(field_exists("/user/premium")(record));
+  BOOST_CHECK(field_exists("")(record));
+  BOOST_CHECK(!field_exists("/user/age")(record));
+}
+
+BOOST_AUTO_TEST_CASE(json_record_filter_should_combine_predicates) {
+  const auto is_play = field_equals("/event", "play");
+  const auto is_swedish = field_equals("/user/country", "SE");
+  const auto is_long = field_in_range("/ms", 10000, 1e9);
+  BOOST_CHECK(!negate(is_play)(record));
+  BOOST_CHECK(all_of(is_play, is_swedish)(record));
+  BOOST_CHECK(!all_of(is_play, is_long)(record));
+  BOOST_CHECK(any_of(is_long, is_swedish)(record));
+  BOOST_CHECK(!any_of(is_long, negate(is_play))(record));
+}
+
+BOOST_AUTO_TEST_CASE(json_record_filter_should_evaluate_lazily) {
+  const std::string json = "{\"a\":\"x\",\"b\":[}";
+  BOOST_CHECK(!all_of(field_equals("/a", "y"), field_exists("/c"))(json));
+  BOOST_CHECK(any_of(field_equals("/a", "x"), field_exists("/c"))(json));
+  BOOST_CHECK_THROW(all_of(field_equals("/a", "x"), field_exists("/c"))(json), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_record_filter_should_not_read_past_field) {
+  BOOST_CHECK(field_equals("/event", "x")("{\"event\":\"x\", garbage"));
+}
+
+BOOST_AUTO_TEST_CASE(json_record_filter_should_fail_on_invalid_input_before_field) {
+  BOOST_CHECK_THROW(field_equals("/b", "x")("{\"a\":[1,,2],\"b\":\"x\"}"), decode_exception);
+  BOOST_CHECK_THROW(field_equals("/a", "x")("{\"a\":\"x"), decode_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/sax.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+/**
+ * Records the events as a compact string, e.g., "{k(a)n(1)}".
+ */
+struct recording_handler {
+  void start_object() { events += "{"; }
+  void end_object() { events += "}"; }
+  void start_array() { events += "["; }
+  void end_array() { events += "]"; }
+  void key(const sax_string &key) { events += "k(" + key.str() + ")"; }
+  void string(const sax_string &value) { events += "s(" + value.str() + ")"; }
+  void number(const sax_number &value) { events += "n(" + std::string(value.data, value.size) + ")"; }
+  void boolean(bool value) { events += (value ? "t" : "f"); }
+  void null() { events += "0"; }
+
+  std::string events;
+};
+
+std::string events(const std::string &json) {
+  recording_handler handler;
+  sax_parse(json, handler);
+  return handler.events;
+}
+
+bool fails(const std::string &json) {
+  try {
+    events(json);
+    return false;
+  } catch (const decode_exception &) {
+    return true;
+  }
+}
+
+struct sum_handler : public sax_handler {
+  void number(const sax_number &value) { sum += value.as<int64_t>(); }
+  int64_t sum = 0;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_emit_events_for_simple_values) {
+  BOOST_CHECK_EQUAL(events("true"), "t");
+  BOOST_CHECK_EQUAL(events("false"), "f");
+  BOOST_CHECK_EQUAL(events(" null "), "0");
+  BOOST_CHECK_EQUAL(events("-1.5e3"), "n(-1.5e3)");
+  BOOST_CHECK_EQUAL(events("\"abc\""), "s(abc)");
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_emit_events_for_containers) {
+  BOOST_CHECK_EQUAL(events("{}"), "{}");
+  BOOST_CHECK_EQUAL(events("[ ]"), "[]");
+  BOOST_CHECK_EQUAL(events("[1, \"a\", null]"), "[n(1)s(a)0]");
+  BOOST_CHECK_EQUAL(
+      events("{ \"a\" : [ {}, [] ], \"b\" : { \"c\" : true } }"),
+      "{k(a)[{}[]]k(b){k(c)t}}");
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_pass_raw_strings) {
+  recording_handler handler;
+  sax_parse("{\"k\\u0065y\":\"a\\nb\"}", handler);
+  BOOST_CHECK_EQUAL(handler.events, "{k(key)s(a\nb)}");
+
+  struct raw_handler : public sax_handler {
+    void string(const sax_string &value) {
+      raw = std::string(value.data, value.size);
+      has_escapes = value.has_escapes;
+    }
+    std::string raw;
+    bool has_escapes = false;
+  } raw;
+  sax_parse("\"a\\\"b\"", raw);
+  BOOST_CHECK_EQUAL(raw.raw, "a\\\"b");
+  BOOST_CHECK(raw.has_escapes);
+  sax_parse("\"ab\"", raw);
+  BOOST_CHECK(!raw.has_escapes);
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_parse_numbers_on_demand) {
+  sum_handler handler;
+  sax_parse("{\"a\":[1,2,{\"b\":3}],\"c\":\"4\",\"d\":-10}", handler);
+  BOOST_CHECK_EQUAL(handler.sum, -4);
+
+  const std::string json = "2.5";
+  struct double_handler : public sax_handler {
+    void number(const sax_number &value) { result = value.as<double>(); }
+    double result = 0;
+  } doubles;
+  sax_parse(json, doubles);
+  BOOST_CHECK_EQUAL(doubles.result, 2.5);
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_parse_deeply_nested_input_without_recursion) {
+  const auto depth = 100000;
+  const auto json = std::string(depth, '[') + "{\"a\":[]}" + std::string(depth, ']');
+
+  struct depth_handler : public sax_handler {
+    void start_array() { max_depth = std::max(max_depth, ++depth); }
+    void end_array() { --depth; }
+    int depth = 0;
+    int max_depth = 0;
+  } handler;
+  sax_parse(json, handler);
+  BOOST_CHECK_EQUAL(handler.depth, 0);
+  BOOST_CHECK_EQUAL(handler.max_depth, depth + 1);
+
+  const auto mixed = std::string(200, '[') + std::string(200, '{') + "x";
+  BOOST_CHECK(fails(mixed));
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_track_container_kinds_across_words) {
+  std::string json;
+  std::string expected;
+  for (int i = 0; i < 300; i++) {
+    json += (i % 3 ? "[" : "{\"k\":");
+    expected += (i % 3 ? "[" : "{k(k)");
+  }
+  for (int i = 299; i >= 0; i--) {
+    json += (i % 3 ? "]" : "}");
+    expected += (i % 3 ? "]" : "}");
+  }
+  json.insert(json.find(']'), "1");
+  expected.insert(expected.find(']'), "n(1)");
+  BOOST_CHECK_EQUAL(events(json), expected);
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_fail_on_invalid_input) {
+  BOOST_CHECK(fails(""));
+  BOOST_CHECK(fails("["));
+  BOOST_CHECK(fails("[1,]"));
+  BOOST_CHECK(fails("[1 2]"));
+  BOOST_CHECK(fails("[1}"));
+  BOOST_CHECK(fails("{\"a\":1]"));
+  BOOST_CHECK(fails("{\"a\" 1}"));
+  BOOST_CHECK(fails("{1:1}"));
+  BOOST_CHECK(fails("{\"a\":}"));
+  BOOST_CHECK(fails("\"\\x\""));
+  BOOST_CHECK(fails("\"abc"));
+  BOOST_CHECK(fails("01"));
+  BOOST_CHECK(fails("-"));
+  BOOST_CHECK(fails("tru"));
+  BOOST_CHECK(fails("nul"));
+  BOOST_CHECK(fails("x"));
+  BOOST_CHECK(fails("[] []"));
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_report_same_offsets_as_skip_value) {
+  for (const std::string json : { "[1,]", "{\"a\" 1}", "[1 2]", "\"\\x\"", "[[[" }) {
+    size_t sax_offset = 0;
+    size_t skip_offset = 0;
+    try {
+      events(json);
+    } catch (const decode_exception &exception) {
+      sax_offset = exception.offset();
+    }
+    try {
+      decode_context context(json.data(), json.size());
+      detail::skip_value(context);
+    } catch (const decode_exception &exception) {
+      skip_offset = exception.offset();
+    }
+    BOOST_CHECK_EQUAL(sax_offset, skip_offset);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_emit_events_before_error) {
+  recording_handler handler;
+  BOOST_CHECK_THROW(sax_parse("[1,{\"a\":x}]", handler), decode_exception);
+  BOOST_CHECK_EQUAL(handler.events, "[n(1){k(a)");
+}
+
+BOOST_AUTO_TEST_CASE(json_sax_parse_should_parse_value_in_context) {
+  const std::string json = "[1,2] rest";
+  decode_context context(json.data(), json.size());
+  sum_handler handler;
+  sax_parse(context, handler);
+  BOOST_CHECK_EQUAL(handler.sum, 3);
+  BOOST_CHECK_EQUAL(context.offset(), 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
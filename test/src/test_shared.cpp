@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/shared.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/test/only_true.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct shared_test_t {
+  std::string value;
+};
+
+int num_codecs_created = 0;
+
+}  // namespace
+
+template <>
+struct default_codec_t<shared_test_t> {
+  static codec::object_t<shared_test_t> codec() {
+    num_codecs_created++;
+    codec::object_t<shared_test_t> codec;
+    codec.required("value", &shared_test_t::value);
+    return codec;
+  }
+};
+
+BOOST_AUTO_TEST_SUITE(codec)
+
+/*
+ * shared_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_should_encode) {
+  const auto codec = shared(boolean());
+  BOOST_CHECK_EQUAL(encode(codec, true), "true");
+  BOOST_CHECK_EQUAL(measure(codec, false), 5);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_should_decode) {
+  const auto codec = shared(boolean());
+  BOOST_CHECK_EQUAL(decode(codec, "true"), true);
+  BOOST_CHECK_EQUAL(decode(codec, "false"), false);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_should_respect_should_encode) {
+  const auto codec = shared(only_true_t());
+  BOOST_CHECK(codec.should_encode(true));
+  BOOST_CHECK(!codec.should_encode(false));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_should_nest_in_other_codecs) {
+  const auto codec = array<std::vector<shared_test_t>>(shared_default<shared_test_t>());
+  const auto values = decode(codec, R"([{"value":"a"},{"value":"b"}])");
+  BOOST_REQUIRE_EQUAL(values.size(), 2);
+  BOOST_CHECK_EQUAL(values[1].value, "b");
+  BOOST_CHECK_EQUAL(encode(codec, values), R"([{"value":"a"},{"value":"b"}])");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+
+/*
+ * cached_default_codec
+ */
+
+BOOST_AUTO_TEST_CASE(json_cached_default_codec_should_create_codec_once) {
+  const auto &codec = cached_default_codec<shared_test_t>();
+  const auto created = num_codecs_created;
+  BOOST_CHECK_EQUAL(&cached_default_codec<shared_test_t>(), &codec);
+
+  shared_test_t value;
+  value.value = "x";
+  BOOST_CHECK_EQUAL(encode(value), R"({"value":"x"})");
+  BOOST_CHECK_EQUAL(decode<shared_test_t>(R"({"value":"y"})").value, "y");
+  BOOST_CHECK_EQUAL(num_codecs_created, created);
+}
+
+BOOST_AUTO_TEST_CASE(json_cached_default_codec_should_be_shared_between_threads) {
+  const auto *codec = &cached_default_codec<std::vector<shared_test_t>>();
+  const void *other_codec = nullptr;
+  std::thread thread([&]{
+    other_codec = &cached_default_codec<std::vector<shared_test_t>>();
+  });
+  thread.join();
+  BOOST_CHECK_EQUAL(other_codec, codec);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
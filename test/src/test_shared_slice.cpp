@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/raw.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/shared_slice.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct track_t {
+  shared_slice uri;
+  shared_slice metadata;
+};
+
+bool points_into(const shared_slice &slice, const shared_buffer &buffer) {
+  return buffer.contains(slice.data(), slice.data() + slice.size());
+}
+
+}  // namespace
+
+template <>
+struct default_codec_t<track_t> {
+  static codec::object_t<track_t> codec() {
+    auto codec = codec::object<track_t>();
+    codec.required("uri", &track_t::uri);
+    codec.optional("metadata", &track_t::metadata, codec::raw<shared_slice>());
+    return codec;
+  }
+};
+
+/*
+ * shared_slice
+ */
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_should_keep_buffer_alive) {
+  shared_slice slice;
+  {
+    const shared_buffer buffer(std::string("abcdef"));
+    slice = buffer.slice(buffer.data() + 1, buffer.data() + 4);
+  }
+  BOOST_CHECK_EQUAL(slice.str(), "bcd");
+  BOOST_CHECK_EQUAL(slice.pinned_size(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_should_compact) {
+  const shared_buffer buffer(std::string(1000, 'x'));
+  const auto slice = buffer.slice(buffer.data(), buffer.data() + 3);
+  const auto compacted = slice.compact();
+  BOOST_CHECK(!points_into(compacted, buffer));
+  BOOST_CHECK_EQUAL(compacted.pinned_size(), 3);
+  BOOST_CHECK(compacted == slice);
+  BOOST_CHECK(compacted.compact().data() == compacted.data());
+}
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_should_compare_contents) {
+  BOOST_CHECK(shared_slice::copy("ab", 2) == shared_slice::copy("ab", 2));
+  BOOST_CHECK(shared_slice::copy("ab", 2) != shared_slice::copy("ac", 2));
+  BOOST_CHECK(shared_slice() == shared_slice::copy("", 0));
+}
+
+/*
+ * shared_slice_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_codec_should_decode_slices_of_buffer) {
+  const shared_buffer buffer(std::string(R"(["abc","def"])"));
+  const auto slices = decode<std::vector<shared_slice>>(buffer);
+  BOOST_REQUIRE_EQUAL(slices.size(), 2);
+  BOOST_CHECK(points_into(slices[0], buffer));
+  BOOST_CHECK(slices[0].data() == buffer.data() + 2);
+  BOOST_CHECK_EQUAL(slices[1].str(), "def");
+}
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_codec_should_copy_escaped_strings) {
+  const shared_buffer buffer(std::string(R"("a\nb")"));
+  const auto slice = decode<shared_slice>(buffer);
+  BOOST_CHECK(!points_into(slice, buffer));
+  BOOST_CHECK_EQUAL(slice.str(), "a\nb");
+}
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_codec_should_copy_short_strings) {
+  const shared_buffer buffer(std::string(R"(["SE","spotify:track:1"])"));
+  const auto slices = decode(codec::array<std::vector<shared_slice>>(codec::shared_slice(4)), buffer);
+  BOOST_CHECK(!points_into(slices[0], buffer));
+  BOOST_CHECK(points_into(slices[1], buffer));
+}
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_codec_should_copy_without_buffer) {
+  const std::string json = "\"abc\"";
+  const auto slice = decode<shared_slice>(json);
+  BOOST_CHECK_EQUAL(slice.str(), "abc");
+  BOOST_CHECK_EQUAL(slice.pinned_size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_codec_should_fail_on_invalid_strings) {
+  BOOST_CHECK_THROW(decode<shared_slice>(shared_buffer(std::string("\"abc"))), decode_exception);
+  BOOST_CHECK_THROW(decode<shared_slice>(shared_buffer(std::string("abc"))), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_codec_should_encode) {
+  BOOST_CHECK_EQUAL(encode(shared_slice::copy("a\"b", 3)), "\"a\\\"b\"");
+}
+
+/*
+ * raw_t<shared_slice>
+ */
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_should_decode_raw_values) {
+  const shared_buffer buffer(std::string(R"({"uri":"u","metadata":{"a":[1,2]}})"));
+  const auto track = decode<track_t>(buffer);
+  BOOST_CHECK_EQUAL(track.metadata.str(), R"({"a":[1,2]})");
+  BOOST_CHECK(points_into(track.metadata, buffer));
+  BOOST_CHECK(points_into(track.uri, buffer));
+  BOOST_CHECK_EQUAL(encode(track), R"({"uri":"u","metadata":{"a":[1,2]}})");
+}
+
+BOOST_AUTO_TEST_CASE(json_shared_slice_should_outlive_buffer) {
+  std::unique_ptr<shared_buffer> buffer(new shared_buffer(std::string(R"({"uri":"u","metadata":[true]})")));
+  const auto track = decode<track_t>(*buffer);
+  buffer.reset();
+  BOOST_CHECK_EQUAL(track.uri.str(), "u");
+  BOOST_CHECK_EQUAL(track.metadata.str(), "[true]");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -14,15 +14,19 @@
  * the License.
  */
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/codec/map.hpp>
 #include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/raw.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encode.hpp>
+#include <spotify/json/encode_exception.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
@@ -267,6 +271,121 @@ BOOST_AUTO_TEST_CASE(json_codec_string_should_encode_escaped_control_characters)
   BOOST_CHECK_EQUAL(encode(std::string("\x01\x02")), "\"\\u0001\\u0002\"");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_string_should_encode_escaped_null_characters_in_long_string) {
+  const auto string = std::string("0123456789abcde\0", 16) + std::string("0123456789abcdef\x01", 17);
+  const auto answer = "\"0123456789abcde\\u00000123456789abcdef\\u0001\"";
+  BOOST_CHECK_EQUAL(encode(string), answer);
+}
+
+/*
+ * Encoding References
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_reference_long_string) {
+  const std::string string(100, 'a');
+  encode_context context;
+  context.set_reference_threshold(64);
+  string_t().encode(context, string);
+
+  const auto segments = context.segments();
+  BOOST_REQUIRE_EQUAL(segments.size(), 3);
+  BOOST_CHECK_EQUAL(segments[1].data, string.data());
+  BOOST_CHECK_EQUAL(segments[1].size, string.size());
+  BOOST_CHECK_EQUAL(context.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_not_reference_short_string) {
+  encode_context context;
+  context.set_reference_threshold(64);
+  string_t().encode(context, std::string(63, 'a'));
+  BOOST_CHECK_EQUAL(context.segments().size(), 1);
+  BOOST_CHECK_EQUAL(context.size(), 65);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_not_reference_string_that_needs_escaping) {
+  const auto string = std::string(100, 'a') + "\n";
+  encode_context context;
+  context.set_reference_threshold(64);
+  string_t().encode(context, string);
+  BOOST_CHECK_EQUAL(context.segments().size(), 1);
+  BOOST_CHECK_EQUAL(
+      std::string(static_cast<const char *>(context.data()), context.size()),
+      "\"" + std::string(100, 'a') + "\\n\"");
+}
+
+/*
+ * string_ref_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_encode_raw_ref) {
+  const char *string = "a\"b";
+  BOOST_CHECK_EQUAL(encode(string_ref<raw_ref>(), raw_ref(string, 3)), "\"a\\\"b\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_encode_vector) {
+  const std::vector<char> string{ 'a', 'b', 'c' };
+  BOOST_CHECK_EQUAL(encode(string_ref<std::vector<char>>(), string), "\"abc\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_reference_long_string) {
+  const std::string string(100, 'a');
+  encode_context context;
+  context.set_reference_threshold(64);
+  string_ref<raw_ref>().encode(context, raw_ref(string.data(), string.size()));
+  BOOST_REQUIRE_EQUAL(context.segments().size(), 3);
+  BOOST_CHECK(context.segments()[1].data == string.data());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_decode_view_into_input) {
+  const std::string json = "\"abc\"";
+  const auto ref = decode(string_ref<raw_ref>(), json);
+  BOOST_CHECK(ref.data() == json.data() + 1);
+  BOOST_CHECK_EQUAL(ref.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_not_decode_escaped_string_into_view) {
+  BOOST_CHECK_THROW(decode(string_ref<raw_ref>(), "\"a\\nb\""), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_decode_escaped_string_into_vector) {
+  const auto string = decode(string_ref<std::vector<char>>(), "\"a\\nb\"");
+  BOOST_CHECK_EQUAL(std::string(string.begin(), string.end()), "a\nb");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_ref_should_measure) {
+  const char *string = "a\nb";
+  const auto ref = raw_ref(string, 3);
+  BOOST_CHECK_EQUAL(measure(string_ref<raw_ref>(), ref), encode(string_ref<raw_ref>(), ref).size());
+}
+
+/*
+ * c_string_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_c_string_should_encode) {
+  const char *string = "a\tb";
+  BOOST_CHECK_EQUAL(encode(string), "\"a\\tb\"");
+  BOOST_CHECK_EQUAL(measure(c_string(), string), 6);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_c_string_should_not_encode_null) {
+  const char *string = nullptr;
+  BOOST_CHECK_THROW(encode(string), encode_exception);
+  BOOST_CHECK_THROW(measure(c_string(), string), encode_exception);
+  BOOST_CHECK(!detail::should_encode(c_string(), string));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_c_string_should_not_decode) {
+  BOOST_CHECK_THROW(decode(c_string(), "\"a\""), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_encode_map_without_copying_keys) {
+  const std::map<std::vector<char>, const char *> map{ { { 'a' }, "x" }, { { 'b' }, "y" } };
+  const auto codec = codec::map<std::map<std::vector<char>, const char *>>(
+      string_ref<std::vector<char>>(), c_string());
+  BOOST_CHECK_EQUAL(encode(codec, map), R"({"a":"x","b":"y"})");
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2015-2016 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/encode_exception.hpp>
+#include <spotify/json/writer.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+std::string to_string(const encode_context &context) {
+  return std::string(static_cast<const char *>(context.data()), context.size());
+}
+
+}  // namespace
+
+/*
+ * Values
+ */
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_top_level_value) {
+  encode_context context;
+  writer w(context);
+  w.value(42);
+  BOOST_CHECK(w.is_complete());
+  BOOST_CHECK_EQUAL(to_string(context), "42");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_null) {
+  encode_context context;
+  writer(context).null();
+  BOOST_CHECK_EQUAL(to_string(context), "null");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_escaped_c_string) {
+  encode_context context;
+  writer(context).value("a\"b\n");
+  BOOST_CHECK_EQUAL(to_string(context), "\"a\\\"b\\n\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_value_with_codec) {
+  encode_context context;
+  writer(context).value(codec::number<double>(), 0.5);
+  BOOST_CHECK_EQUAL(to_string(context), "0.5");
+}
+
+/*
+ * Containers
+ */
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_empty_containers) {
+  encode_context context;
+  writer(context).begin_array().begin_object().end_object().begin_array().end_array().end_array();
+  BOOST_CHECK_EQUAL(to_string(context), "[{},[]]");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_object_with_commas) {
+  encode_context context;
+  writer w(context);
+  w.begin_object();
+  w.field("a", 1);
+  w.key("b").value(std::string("x"));
+  w.field("c", "y");
+  w.key("d").null();
+  w.end_object();
+  BOOST_CHECK(w.is_complete());
+  BOOST_CHECK_EQUAL(to_string(context), "{\"a\":1,\"b\":\"x\",\"c\":\"y\",\"d\":null}");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_nested_containers) {
+  encode_context context;
+  writer w(context);
+  w.begin_object().key("rows").begin_array();
+  for (int i = 0; i < 3; i++) {
+    w.begin_object().field("id", i).end_object();
+  }
+  w.end_array().field("count", 3).end_object();
+  BOOST_CHECK_EQUAL(
+      to_string(context),
+      "{\"rows\":[{\"id\":0},{\"id\":1},{\"id\":2}],\"count\":3}");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_subvalues_with_codecs) {
+  encode_context context;
+  writer w(context);
+  w.begin_array();
+  w.value(std::vector<int>{ 1, 2 });
+  w.value(std::map<std::string, bool>{ { "k", true } });
+  w.end_array();
+  BOOST_CHECK_EQUAL(to_string(context), "[[1,2],{\"k\":true}]");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_escape_keys) {
+  encode_context context;
+  writer(context).begin_object().field("a\"b", 1).end_object();
+  BOOST_CHECK_EQUAL(to_string(context), "{\"a\\\"b\":1}");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_write_deeply_nested_arrays) {
+  encode_context context;
+  writer w(context);
+  for (int i = 0; i < 200; i++) {
+    w.begin_array();
+  }
+  for (int i = 0; i < 200; i++) {
+    w.end_array();
+  }
+  BOOST_CHECK_EQUAL(to_string(context), std::string(200, '[') + std::string(200, ']'));
+}
+
+/*
+ * Errors
+ */
+
+BOOST_AUTO_TEST_CASE(json_writer_should_fail_on_value_without_key) {
+  encode_context context;
+  writer w(context);
+  w.begin_object();
+  BOOST_CHECK_THROW(w.value(1), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_fail_on_key_outside_object) {
+  encode_context context;
+  writer w(context);
+  BOOST_CHECK_THROW(w.key("a"), encode_exception);
+  w.begin_array();
+  BOOST_CHECK_THROW(w.key("a"), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_fail_on_two_keys) {
+  encode_context context;
+  writer w(context);
+  w.begin_object().key("a");
+  BOOST_CHECK_THROW(w.key("b"), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_fail_on_dangling_key) {
+  encode_context context;
+  writer w(context);
+  w.begin_object().key("a");
+  BOOST_CHECK_THROW(w.end_object(), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_fail_on_mismatched_end) {
+  encode_context context;
+  writer w(context);
+  BOOST_CHECK_THROW(w.end_array(), encode_exception);
+  w.begin_object();
+  BOOST_CHECK_THROW(w.end_array(), encode_exception);
+  w.end_object();
+  BOOST_CHECK_THROW(w.end_object(), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_should_fail_on_second_top_level_value) {
+  encode_context context;
+  writer w(context);
+  w.value(1);
+  BOOST_CHECK_THROW(w.value(2), encode_exception);
+  BOOST_CHECK_THROW(w.begin_array(), encode_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify